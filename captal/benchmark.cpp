@@ -0,0 +1,202 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <cmath>
+#include <vector>
+
+#include <captal/engine.hpp>
+#include <captal/render_texture.hpp>
+#include <captal/texture.hpp>
+#include <captal/frame_benchmark.hpp>
+
+#include <captal/components/node.hpp>
+#include <captal/components/camera.hpp>
+#include <captal/components/drawable.hpp>
+
+#include <captal/systems/frame.hpp>
+#include <captal/systems/render.hpp>
+
+using namespace cpt::enum_operations;
+
+//Headless frame benchmark, it renders a fixed scene into a render texture and prints a JSON report.
+//It needs no window and no audio device, so it can run headless on a software Vulkan driver such as lavapipe:
+//  SDL_VIDEODRIVER=dummy VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json ./captal_benchmark 1000
+//Arguments: [frame count] [warmup frame count] [sprite count]
+
+static constexpr std::uint32_t width{1280};
+static constexpr std::uint32_t height{720};
+
+//A one texel checkerboard, the worst case for minification without mipmaps
+static cpt::texture_ptr make_checker_texture(cpt::texture_mipmaps mipmaps)
+{
+    constexpr std::uint32_t size{2048};
+
+    std::vector<std::uint8_t> data{};
+    data.resize(size * size * 4);
+
+    for(std::uint32_t y{}; y < size; ++y)
+    {
+        for(std::uint32_t x{}; x < size; ++x)
+        {
+            const std::uint8_t value{((x ^ y) & 1) ? std::uint8_t{255} : std::uint8_t{0}};
+            const std::size_t index{(y * size + x) * 4};
+
+            data[index + 0] = value;
+            data[index + 1] = value;
+            data[index + 2] = value;
+            data[index + 3] = 255;
+        }
+    }
+
+    tph::sampler_info sampling{};
+    sampling.mag_filter = tph::filter::linear;
+    sampling.min_filter = tph::filter::linear;
+    sampling.mipmap_mode = tph::mipmap_mode::linear;
+
+    return cpt::make_texture(size, size, std::data(data), sampling, cpt::color_space::srgb, mipmaps);
+}
+
+static void populate(entt::registry& world, const cpt::render_texture_ptr& target, std::uint32_t sprite_count, const cpt::texture_ptr& texture)
+{
+    const auto camera{world.create()};
+    world.emplace<cpt::components::node>(camera, cpt::vec3f{0.0f, 0.0f, 1.0f});
+    world.emplace<cpt::components::camera>(camera, target)->fit(width, height);
+
+    //A grid of sprites, deterministic so results can be compared between commits
+    const auto columns{static_cast<std::uint32_t>(std::ceil(std::sqrt(static_cast<float>(sprite_count))))};
+
+    for(std::uint32_t i{}; i < sprite_count; ++i)
+    {
+        const auto x{static_cast<float>(i % columns) / static_cast<float>(columns) * static_cast<float>(width)};
+        const auto y{static_cast<float>(i / columns) / static_cast<float>(columns) * static_cast<float>(height)};
+        const cpt::color color{static_cast<float>(i % 7) / 7.0f, static_cast<float>(i % 5) / 5.0f, static_cast<float>(i % 3) / 3.0f};
+
+        const auto entity{world.create()};
+        world.emplace<cpt::components::node>(entity, cpt::vec3f{x, y, 0.0f}, cpt::vec3f{4.0f, 4.0f, 0.0f});
+
+        if(texture)
+        {
+            //The whole texture is squeezed into a 8x8 pixels sprite
+            auto& sprite{world.emplace<cpt::components::drawable>(entity, std::in_place_type<cpt::sprite>, 8, 8, texture, color).get<cpt::sprite>()};
+            sprite.set_relative_texture_rect(0.0f, 0.0f, 1.0f, 1.0f);
+        }
+        else
+        {
+            world.emplace<cpt::components::drawable>(entity, std::in_place_type<cpt::sprite>, 8, 8, color);
+        }
+    }
+}
+
+//The scripted part of the scene, every sprite turns at a fixed speed
+static void animate(entt::registry& world)
+{
+    world.view<cpt::components::node, cpt::components::drawable>().each([](cpt::components::node& node, cpt::components::drawable&)
+    {
+        node.rotate(0.01f);
+    });
+}
+
+static cpt::texture_ptr make_scene_texture(const std::string& scene)
+{
+    if(scene == "texture")
+    {
+        return make_checker_texture(cpt::texture_mipmaps::none);
+    }
+    else if(scene == "texture_mipmaps")
+    {
+        return make_checker_texture(cpt::texture_mipmaps::generate);
+    }
+    else if(scene != "sprites" && scene != "static")
+    {
+        throw std::runtime_error{"Unknown scene \"" + scene + "\"."};
+    }
+
+    return nullptr;
+}
+
+static void run(std::uint32_t frame_count, std::uint32_t warmup_frame_count, std::uint32_t sprite_count, const std::string& scene)
+{
+    const tph::texture_info texture_info{tph::texture_format::r8g8b8a8_unorm, tph::texture_usage::color_attachment | tph::texture_usage::sampled};
+    cpt::render_texture_ptr target{cpt::make_render_texture(cpt::make_texture(width, height, texture_info))};
+
+    entt::registry world{};
+    populate(world, target, sprite_count, make_scene_texture(scene));
+
+    //Static scenes measure the cost of frames where nothing changed, they are never reset
+    const bool animated{scene != "static"};
+    const auto options{animated ? cpt::begin_render_options::timed | cpt::begin_render_options::reset : cpt::begin_render_options::timed};
+
+    cpt::frame_benchmark benchmark{frame_count, warmup_frame_count};
+
+    while(benchmark.next_frame())
+    {
+        cpt::engine::instance().run();
+
+        benchmark.time("script", [&world, animated]()
+        {
+            if(animated)
+            {
+                animate(world);
+            }
+        });
+
+        //Reset every frame, so command buffer recording is measured too
+        if(auto render_info{target->begin_render(options)}; render_info)
+        {
+            benchmark.time_gpu(*render_info);
+        }
+
+        benchmark.time("render", [&world]()
+        {
+            cpt::systems::render(world);
+        });
+
+        benchmark.time("transfers", []()
+        {
+            cpt::engine::instance().submit_transfers();
+        });
+
+        benchmark.time("present", [&target]()
+        {
+            target->present();
+        });
+
+        benchmark.time("end_frame", [&world]()
+        {
+            cpt::systems::end_frame(world);
+        });
+    }
+
+    //GPU times are only available once the frames are done
+    target->wait();
+
+    std::cout << benchmark.report() << std::flush;
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const std::uint32_t frame_count{argc > 1 ? static_cast<std::uint32_t>(std::stoul(argv[1])) : 1000};
+        const std::uint32_t warmup_frame_count{argc > 2 ? static_cast<std::uint32_t>(std::stoul(argv[2])) : 60};
+        const std::uint32_t sprite_count{argc > 3 ? static_cast<std::uint32_t>(std::stoul(argv[3])) : 4096};
+        const std::string scene{argc > 4 ? argv[4] : "sprites"}; //"sprites", "static", "texture" or "texture_mipmaps"
+
+        const cpt::system_parameters system{.headless = true};
+        const cpt::audio_parameters audio{.channel_count = 2, .frequency = 44100};
+
+        const cpt::graphics_parameters graphics
+        {
+            .pipeline_cache_path = std::filesystem::path{} //Pipeline creation time must not depend on previous runs
+        };
+
+        cpt::engine engine{"captal_benchmark", cpt::version{0, 1, 0}, system, audio, graphics};
+
+        run(frame_count, warmup_frame_count, sprite_count, scene);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "An exception as been throw: " << e.what() << std::endl;
+        return 1;
+    }
+}
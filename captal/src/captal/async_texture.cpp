@@ -0,0 +1,310 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include "async_texture.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+
+#include <tephra/image.hpp>
+
+#include "engine.hpp"
+#include "texture_container.hpp"
+
+namespace cpt
+{
+
+static tph::texture_format format_from_color_space(color_space space) noexcept
+{
+    switch(space)
+    {
+        case color_space::srgb:   return tph::texture_format::r8g8b8a8_srgb;
+        case color_space::linear: return tph::texture_format::r8g8b8a8_unorm;
+        default: std::terminate();
+    }
+}
+
+static std::uint32_t compute_level_count(std::uint32_t width, std::uint32_t height, const tph::sampler_info& sampling) noexcept
+{
+    if(sampling.max_lod <= 0.0f)
+    {
+        return 1;
+    }
+
+    const std::uint32_t full_chain{mip_level_count(width, height)};
+    if(sampling.max_lod + 1.0f >= static_cast<float>(full_chain))
+    {
+        return full_chain;
+    }
+
+    return static_cast<std::uint32_t>(sampling.max_lod) + 1;
+}
+
+static std::optional<async_texture::decoded_data> read_container(const std::filesystem::path& file, const tph::sampler_info& sampling, color_space space)
+{
+    std::ifstream stream{file, std::ios_base::binary};
+    if(!stream)
+    {
+        throw std::runtime_error{"Can not open file \"" + file.string() + "\"."};
+    }
+
+    auto container{read_texture_container_header(stream, space)};
+    if(!is_texture_format_supported(container.format))
+    {
+        return std::nullopt;
+    }
+
+    async_texture::decoded_data output{};
+    output.staging = load_texture_container(stream, container);
+
+    output.levels.reserve(std::size(container.levels));
+    for(const auto& level : container.levels)
+    {
+        output.levels.emplace_back(async_texture::level{level.offset, level.size, level.width, level.height});
+    }
+
+    const auto level_count{static_cast<std::uint32_t>(std::size(output.levels))};
+    const tph::texture_info info{container.format, tph::texture_usage::sampled | tph::texture_usage::transfer_destination, level_count};
+    output.texture = make_texture(sampling, container.width, container.height, info);
+
+    return output;
+}
+
+async_texture::decoded_data async_texture::decode(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space)
+{
+    auto& renderer{engine::instance().renderer()};
+
+    auto file{path};
+    if(is_texture_container(path))
+    {
+        if(auto output{read_container(path, sampling, space)}; output)
+        {
+            return std::move(*output);
+        }
+
+        file = find_fallback_image(path);
+        if(file.empty())
+        {
+            throw std::runtime_error{"Texture format of \"" + path.string() + "\" is not supported by the device, and no fallback image has been found."};
+        }
+    }
+
+    tph::image image{renderer, file, tph::image_usage::persistant_mapping};
+    const auto width {static_cast<std::uint32_t>(image.width())};
+    const auto height{static_cast<std::uint32_t>(image.height())};
+
+    async_texture::decoded_data output{};
+
+    const std::uint32_t level_count{compute_level_count(width, height, sampling)};
+    output.levels.reserve(level_count);
+
+    std::uint64_t total_size{};
+    for(std::uint32_t i{}; i < level_count; ++i)
+    {
+        const std::uint32_t level_width {std::max(width >> i, 1u)};
+        const std::uint32_t level_height{std::max(height >> i, 1u)};
+
+        const std::uint64_t size{std::uint64_t{level_width} * level_height * sizeof(tph::pixel)};
+
+        output.levels.emplace_back(async_texture::level{total_size, size, level_width, level_height});
+        total_size += size;
+    }
+
+    output.staging = tph::buffer{renderer, total_size, tph::buffer_usage::transfer_source};
+
+    auto* const data{reinterpret_cast<tph::pixel*>(output.staging.map())};
+    std::memcpy(data, std::data(image), image.byte_size());
+
+    for(std::uint32_t i{1}; i < level_count; ++i)
+    {
+        const auto& source{output.levels[i - 1]};
+        const auto& level {output.levels[i]};
+
+        downsample(data + source.offset / sizeof(tph::pixel), source.width, source.height, data + level.offset / sizeof(tph::pixel), level.width, level.height);
+    }
+
+    output.staging.unmap();
+
+    const tph::texture_info info{format_from_color_space(space), tph::texture_usage::sampled | tph::texture_usage::transfer_destination, level_count};
+    output.texture = make_texture(sampling, width, height, info);
+
+    return output;
+}
+
+async_texture::async_texture(std::filesystem::path file, const tph::sampler_info& sampling, color_space space, texture_ptr placeholder)
+:m_path{std::move(file)}
+,m_placeholder{std::move(placeholder)}
+{
+    m_future = std::async(std::launch::async, decode, m_path, sampling, space);
+}
+
+async_texture::async_texture(std::filesystem::path file, std::future<decoded_data> decoding, texture_ptr placeholder)
+:m_path{std::move(file)}
+,m_placeholder{std::move(placeholder)}
+,m_future{std::move(decoding)}
+{
+
+}
+
+async_texture::async_texture(texture_ptr texture)
+:m_texture{std::move(texture)}
+,m_status{async_texture_status::ready}
+{
+
+}
+
+bool async_texture::wait_decoding()
+{
+    if(m_future.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+    {
+        return false;
+    }
+
+    try
+    {
+        auto data{m_future.get()};
+
+        m_staging = std::move(data.staging);
+        m_staging_memory = memory_tracking{memory_category::staging, memory_location::host, m_staging.size()};
+        m_levels  = std::move(data.levels);
+        m_texture = std::move(data.texture);
+
+#ifdef CAPTAL_DEBUG
+        m_texture->set_name(convert_to<narrow>(m_path.u8string()));
+#endif
+
+        m_status.store(async_texture_status::uploading, std::memory_order_release);
+    }
+    catch(...)
+    {
+        m_exception = std::current_exception();
+        m_status.store(async_texture_status::failed, std::memory_order_release);
+    }
+
+    return status() == async_texture_status::uploading;
+}
+
+std::uint64_t async_texture::stream(std::uint64_t budget)
+{
+    if(status() == async_texture_status::decoding && !wait_decoding())
+    {
+        return 0;
+    }
+
+    if(status() != async_texture_status::uploading || m_recorded_levels == mip_levels())
+    {
+        return 0;
+    }
+
+    auto&& [buffer, signal, keeper, ownership] = engine::instance().begin_transfer(transfer_queue::transfer);
+
+    tph::texture_memory_barrier barrier{m_texture->get_texture()};
+    barrier.subresource.mip_level_count = mip_levels();
+
+    if(m_recorded_levels == 0)
+    {
+        barrier.source_access      = tph::resource_access::none;
+        barrier.destination_access = tph::resource_access::transfer_write;
+        barrier.old_layout         = tph::texture_layout::undefined;
+        barrier.new_layout         = tph::texture_layout::transfer_destination_optimal;
+
+        tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::top_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+    }
+    else
+    {
+        //Orders these copies after the layout transition and the copies recorded in previous frames
+        barrier.source_access      = tph::resource_access::transfer_write;
+        barrier.destination_access = tph::resource_access::transfer_write;
+        barrier.old_layout         = tph::texture_layout::transfer_destination_optimal;
+        barrier.new_layout         = tph::texture_layout::transfer_destination_optimal;
+
+        tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+    }
+
+    std::uint64_t recorded{};
+    std::uint32_t level_count{};
+
+    while(m_recorded_levels < mip_levels())
+    {
+        const std::uint32_t index{mip_levels() - m_recorded_levels - 1};
+        const level& current{m_levels[index]};
+        const std::uint64_t size{current.size};
+
+        if(recorded != 0 && recorded + size > budget)
+        {
+            break;
+        }
+
+        tph::buffer_texture_copy region{};
+        region.buffer_offset = current.offset;
+        region.texture_subresource.mip_level = index;
+        region.texture_size.width  = current.width;
+        region.texture_size.height = current.height;
+
+        tph::cmd::copy(buffer, m_staging, m_texture->get_texture(), region);
+
+        recorded += size;
+        ++level_count;
+        ++m_recorded_levels;
+    }
+
+    keeper.keep(m_texture);
+
+    //Levels are only tracked here, the texture is published once all of them are resident
+    signal.connect([self = shared_from_this(), level_count]()
+    {
+        self->m_resident_levels.fetch_add(level_count, std::memory_order_acq_rel);
+    });
+
+    if(m_recorded_levels == mip_levels())
+    {
+        barrier.source_access      = tph::resource_access::transfer_write;
+        barrier.destination_access = tph::resource_access::shader_read;
+        barrier.old_layout         = tph::texture_layout::transfer_destination_optimal;
+        barrier.new_layout         = tph::texture_layout::shader_read_only_optimal;
+
+        ownership.release(buffer, tph::pipeline_stage::fragment_shader, barrier);
+
+        signal.connect([self = shared_from_this()]()
+        {
+            self->m_staging = tph::buffer{};
+            self->m_staging_memory = memory_tracking{};
+            self->m_status.store(async_texture_status::ready, std::memory_order_release);
+            self->m_ready_signal(self->m_texture);
+        });
+    }
+
+    return recorded;
+}
+
+async_texture_ptr make_async_texture(std::filesystem::path file, const tph::sampler_info& sampling, color_space space, texture_ptr placeholder)
+{
+    auto output{std::make_shared<async_texture>(std::move(file), sampling, space, std::move(placeholder))};
+    engine::instance().stream_texture(output);
+
+    return output;
+}
+
+}
@@ -0,0 +1,167 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#ifndef CAPTAL_ASYNC_TEXTURE_HPP_INCLUDED
+#define CAPTAL_ASYNC_TEXTURE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <filesystem>
+#include <future>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+#include <tephra/buffer.hpp>
+
+#include "signal.hpp"
+#include "texture.hpp"
+
+namespace cpt
+{
+
+enum class async_texture_status : std::uint32_t
+{
+    decoding = 0,
+    uploading = 1,
+    ready = 2,
+    failed = 3
+};
+
+using async_texture_ready_signal = cpt::signal<const texture_ptr&>;
+
+//Texture decoded on a worker thread, then streamed to the GPU a few mip levels per frame on the transfer queue.
+//Until it is ready, texture() returns the placeholder (which may be null).
+class CAPTAL_API async_texture : public std::enable_shared_from_this<async_texture>
+{
+public:
+    struct level
+    {
+        std::uint64_t offset{};
+        std::uint64_t size{};
+        std::uint32_t width{};
+        std::uint32_t height{};
+    };
+
+    struct decoded_data
+    {
+        tph::buffer staging{};
+        std::vector<level> levels{};
+        texture_ptr texture{};
+    };
+
+    //Decodes the file and builds its mip chain in a staging buffer, can be called from any thread.
+    //KTX2 and DDS files are read as is, if the device supports their format.
+    static decoded_data decode(const std::filesystem::path& file, const tph::sampler_info& sampling, color_space space);
+
+public:
+    async_texture() = default;
+    explicit async_texture(std::filesystem::path file, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_ptr placeholder = nullptr);
+    async_texture(std::filesystem::path file, std::future<decoded_data> decoding, texture_ptr placeholder = nullptr);
+    explicit async_texture(texture_ptr texture); //Already uploaded texture, ready right away
+
+    ~async_texture() = default;
+    async_texture(const async_texture&) = delete;
+    async_texture& operator=(const async_texture&) = delete;
+    async_texture(async_texture&&) noexcept = delete;
+    async_texture& operator=(async_texture&&) noexcept = delete;
+
+    //Records the upload of the next mip levels, from the smallest to the largest, up to budget bytes (at least one level is recorded).
+    //Returns the amount of bytes recorded. Called by the engine, on the thread that submits the transfers.
+    std::uint64_t stream(std::uint64_t budget);
+
+    const texture_ptr& texture() const noexcept
+    {
+        if(status() == async_texture_status::ready)
+        {
+            return m_texture;
+        }
+
+        return m_placeholder;
+    }
+
+    const texture_ptr& placeholder() const noexcept
+    {
+        return m_placeholder;
+    }
+
+    async_texture_status status() const noexcept
+    {
+        return m_status.load(std::memory_order_acquire);
+    }
+
+    bool is_ready() const noexcept
+    {
+        return status() == async_texture_status::ready;
+    }
+
+    std::uint32_t resident_levels() const noexcept
+    {
+        return m_resident_levels.load(std::memory_order_acquire);
+    }
+
+    std::uint32_t mip_levels() const noexcept
+    {
+        return static_cast<std::uint32_t>(std::size(m_levels));
+    }
+
+    const std::filesystem::path& path() const noexcept
+    {
+        return m_path;
+    }
+
+    //Valid only if status() is failed
+    std::exception_ptr exception() const noexcept
+    {
+        return m_exception;
+    }
+
+    async_texture_ready_signal& on_ready() noexcept
+    {
+        return m_ready_signal;
+    }
+
+private:
+    bool wait_decoding();
+
+private:
+    std::filesystem::path m_path{};
+    texture_ptr m_placeholder{};
+    texture_ptr m_texture{};
+    std::future<decoded_data> m_future{};
+    tph::buffer m_staging{};
+    memory_tracking m_staging_memory{};
+    std::vector<level> m_levels{};
+    std::uint32_t m_recorded_levels{};
+    std::atomic<std::uint32_t> m_resident_levels{};
+    std::atomic<async_texture_status> m_status{async_texture_status::decoding};
+    std::exception_ptr m_exception{};
+    async_texture_ready_signal m_ready_signal{};
+};
+
+//Starts decoding on a worker thread and registers the texture to the engine's streaming queue
+CAPTAL_API async_texture_ptr make_async_texture(std::filesystem::path file, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_ptr placeholder = nullptr);
+
+}
+
+#endif
@@ -27,6 +27,8 @@
 
 #include <variant>
 #include <vector>
+#include <span>
+#include <functional>
 #include <cassert>
 
 #include <tephra/descriptor.hpp>
@@ -112,6 +114,107 @@ inline tph::descriptor_write make_descriptor_write(tph::descriptor_set& set, std
     }
 }
 
+//For uniform buffers bound as uniform_buffer_dynamic, the descriptor does not contain the offset of the buffer,
+//so all buffers allocated in the same heap share the same descriptor. The offset is given at bind time by dynamic_offset.
+inline tph::descriptor_write make_descriptor_write(tph::descriptor_set& set, std::uint32_t binding, const cpt::binding& data, tph::descriptor_type type) noexcept
+{
+    if(type == tph::descriptor_type::uniform_buffer_dynamic)
+    {
+        if(get_binding_type(data) == binding_type::uniform_buffer)
+        {
+            auto buffer{std::get<uniform_buffer_ptr>(data)->get_buffer()};
+
+            const tph::descriptor_buffer_info info{buffer.buffer, 0, std::get<uniform_buffer_ptr>(data)->size()};
+
+            return tph::descriptor_write{set, binding, 0, tph::descriptor_type::uniform_buffer_dynamic, info};
+        }
+        else if(get_binding_type(data) == binding_type::uniform_buffer_part)
+        {
+            const auto part  {std::get<uniform_buffer_part>(data)};
+            const auto buffer{part.buffer->get_buffer()};
+
+            const tph::descriptor_buffer_info info{buffer.buffer, 0, part.buffer->part_size(part.part)};
+
+            return tph::descriptor_write{set, binding, 0, tph::descriptor_type::uniform_buffer_dynamic, info};
+        }
+    }
+
+    return make_descriptor_write(set, binding, data);
+}
+
+inline std::uint32_t dynamic_offset(const cpt::binding& data) noexcept
+{
+    if(get_binding_type(data) == binding_type::uniform_buffer)
+    {
+        return static_cast<std::uint32_t>(std::get<uniform_buffer_ptr>(data)->get_buffer().offset);
+    }
+    else if(get_binding_type(data) == binding_type::uniform_buffer_part)
+    {
+        const auto part{std::get<uniform_buffer_part>(data)};
+
+        return static_cast<std::uint32_t>(part.buffer->get_buffer().offset + part.buffer->part_offset(part.part));
+    }
+
+    return 0;
+}
+
+//Identifies the content of a descriptor, bindings with equal keys write the same descriptor
+struct binding_key
+{
+    const void* resource{};
+    std::uint64_t offset{};
+    std::uint64_t size{};
+
+    friend bool operator==(const binding_key&, const binding_key&) noexcept = default;
+};
+
+inline binding_key make_binding_key(const cpt::binding& data, tph::descriptor_type type) noexcept
+{
+    const bool dynamic{type == tph::descriptor_type::uniform_buffer_dynamic};
+
+    if(get_binding_type(data) == binding_type::uniform_buffer)
+    {
+        auto& uniform{*std::get<uniform_buffer_ptr>(data)};
+        auto  buffer {uniform.get_buffer()};
+
+        return binding_key{&buffer.buffer, dynamic ? 0 : buffer.offset, uniform.size()};
+    }
+    else if(get_binding_type(data) == binding_type::texture)
+    {
+        return binding_key{std::get<texture_ptr>(data).get()};
+    }
+    else if(get_binding_type(data) == binding_type::storage_buffer)
+    {
+        return binding_key{std::get<storage_buffer_ptr>(data).get()};
+    }
+    else
+    {
+        const auto part  {std::get<uniform_buffer_part>(data)};
+        const auto buffer{part.buffer->get_buffer()};
+
+        return binding_key{&buffer.buffer, dynamic ? 0 : buffer.offset + part.buffer->part_offset(part.part), part.buffer->part_size(part.part)};
+    }
+}
+
+inline std::size_t hash_binding_keys(std::span<const binding_key> keys) noexcept
+{
+    std::size_t output{std::size(keys)};
+
+    const auto combine = [&output](std::size_t value)
+    {
+        output ^= value + 0x9e3779b9 + (output << 6) + (output >> 2);
+    };
+
+    for(auto&& key : keys)
+    {
+        combine(std::hash<const void*>{}(key.resource));
+        combine(std::hash<std::uint64_t>{}(key.offset));
+        combine(std::hash<std::uint64_t>{}(key.size));
+    }
+
+    return output;
+}
+
 class CAPTAL_API binding_buffer
 {
 public:
@@ -22,9 +22,15 @@
 
 #include "buffer_pool.hpp"
 
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+
 #include <captal_foundation/stack_allocator.hpp>
+#include <captal_foundation/profiler.hpp>
 
 #include "engine.hpp"
+#include "scene_epoch.hpp"
 
 namespace cpt
 {
@@ -34,7 +40,7 @@ buffer_heap_chunk::buffer_heap_chunk(buffer_heap* parent, std::uint64_t offset,
 ,m_offset{offset}
 ,m_size{size}
 {
-
+    m_parent->register_owner(*this);
 }
 
 buffer_heap_chunk::~buffer_heap_chunk()
@@ -50,7 +56,10 @@ buffer_heap_chunk::buffer_heap_chunk(buffer_heap_chunk&& other) noexcept
 ,m_offset{other.m_offset}
 ,m_size{other.m_size}
 {
-
+    if(m_parent)
+    {
+        m_parent->register_owner(*this);
+    }
 }
 
 buffer_heap_chunk& buffer_heap_chunk::operator=(buffer_heap_chunk&& other) noexcept
@@ -59,6 +68,16 @@ buffer_heap_chunk& buffer_heap_chunk::operator=(buffer_heap_chunk&& other) noexc
     std::swap(other.m_offset, m_offset);
     std::swap(other.m_size, m_size);
 
+    if(m_parent)
+    {
+        m_parent->register_owner(*this);
+    }
+
+    if(other.m_parent)
+    {
+        other.m_parent->register_owner(other);
+    }
+
     return *this;
 }
 
@@ -77,11 +96,28 @@ const void* buffer_heap_chunk::map(std::uint64_t offset) const noexcept
     return reinterpret_cast<const std::uint8_t*>(m_parent->map()) + m_offset + offset;
 }
 
-buffer_heap::buffer_heap(std::uint64_t size, tph::buffer_usage usage)
+//Vulkan limits offset alignments and the non coherent atom size to 256 bytes, so slices can start anywhere after this
+static constexpr std::uint64_t slice_alignment{256};
+
+static tph::buffer make_device_buffer(std::uint64_t size, tph::buffer_usage usage, bool ring)
+{
+    if(ring)
+    {
+        return tph::buffer{engine::instance().renderer(), align_up(size, slice_alignment) * buffer_heap::ring_size, usage | tph::buffer_usage::device_mapped};
+    }
+
+    return tph::buffer{engine::instance().renderer(), size, usage | tph::buffer_usage::transfer_destination | tph::buffer_usage::device_only};
+}
+
+buffer_heap::buffer_heap(std::uint64_t size, tph::buffer_usage usage, bool ring)
 :m_local_data{engine::instance().renderer(), size, usage | tph::buffer_usage::transfer_source}
-,m_device_data{engine::instance().renderer(), size, usage | tph::buffer_usage::transfer_destination | tph::buffer_usage::device_only}
+,m_device_data{make_device_buffer(size, usage, ring)}
+,m_local_memory{memory_category::uniform_pool, memory_location::host, size}
+,m_device_memory{memory_category::uniform_pool, memory_location::device, m_device_data.size()}
 ,m_size{size}
+,m_slice_size{ring ? align_up(size, slice_alignment) : 0}
 ,m_local_map{m_local_data.map()}
+,m_device_map{ring ? m_device_data.map() : nullptr}
 {
     m_ranges.reserve(64);
     m_upload_ranges.reserve(64);
@@ -93,6 +129,17 @@ buffer_heap::~buffer_heap()
 }
 
 std::optional<buffer_heap_chunk> buffer_heap::try_allocate(std::uint64_t size, std::uint64_t alignment)
+{
+    //The chunk registers itself as the owner of its range, so it is created once the heap is unlocked
+    if(const auto offset{try_reserve(size, alignment)}; offset)
+    {
+        return std::make_optional(buffer_heap_chunk{this, *offset, size});
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::uint64_t> buffer_heap::try_reserve(std::uint64_t size, std::uint64_t alignment)
 {
     std::lock_guard lock{m_mutex};
 
@@ -101,12 +148,12 @@ std::optional<buffer_heap_chunk> buffer_heap::try_allocate(std::uint64_t size, s
     //Push it at the begginning if the heap is empty
     if(std::empty(m_ranges) && size <= m_size)
     {
-        m_ranges.emplace_back(0, size);
+        m_ranges.emplace_back(0, size, alignment);
 
         m_free_space -= size;
         m_allocation_count = 1;
 
-        return std::make_optional(buffer_heap_chunk{this, 0, size});
+        return std::make_optional<std::uint64_t>(0);
     }
 
     //Try to push it at the end
@@ -117,7 +164,7 @@ std::optional<buffer_heap_chunk> buffer_heap::try_allocate(std::uint64_t size, s
 
         if(m_size - end >= size)
         {
-            m_ranges.emplace_back(end, size);
+            m_ranges.emplace_back(end, size, alignment);
 
             return std::cend(m_ranges) - 1;
         }
@@ -130,7 +177,7 @@ std::optional<buffer_heap_chunk> buffer_heap::try_allocate(std::uint64_t size, s
         m_free_space -= it->size;
         m_allocation_count += 1;
 
-        return std::make_optional(buffer_heap_chunk{this, it->offset, it->size});
+        return std::make_optional(it->offset);
     }
 
     //Try to insert it at a suitable place
@@ -143,7 +190,7 @@ std::optional<buffer_heap_chunk> buffer_heap::try_allocate(std::uint64_t size, s
 
             if(static_cast<std::int64_t>(next->offset) - static_cast<std::int64_t>(end) >= static_cast<std::int64_t>(size))
             {
-                return m_ranges.insert(next, range{end, size});
+                return m_ranges.insert(next, range{end, size, alignment});
             }
         }
 
@@ -155,15 +202,16 @@ std::optional<buffer_heap_chunk> buffer_heap::try_allocate(std::uint64_t size, s
         m_free_space -= it->size;
         m_allocation_count += 1;
 
-        return std::make_optional(buffer_heap_chunk{this, it->offset, it->size});
+        return std::make_optional(it->offset);
     }
 
     return std::nullopt;
 }
 
-buffer_heap_chunk buffer_heap::allocate_first(std::uint64_t size)
+buffer_heap_chunk buffer_heap::allocate_first(std::uint64_t size, std::uint64_t alignment)
 {
-    m_ranges.emplace_back(0, size);
+    //Offset 0 fits any alignment, but relocation needs the real one
+    m_ranges.emplace_back(0, size, alignment);
 
     m_free_space -= size;
     m_allocation_count = 1;
@@ -171,6 +219,29 @@ buffer_heap_chunk buffer_heap::allocate_first(std::uint64_t size)
     return buffer_heap_chunk{this, 0, size};
 }
 
+std::uint64_t buffer_heap::largest_free_block() const
+{
+    std::lock_guard lock{m_mutex};
+
+    std::uint64_t output{};
+    std::uint64_t end{};
+
+    for(auto&& range : m_ranges)
+    {
+        output = std::max(output, range.offset - end);
+        end = range.offset + range.size;
+    }
+
+    return std::max(output, m_size - end);
+}
+
+std::uint64_t buffer_heap::staging_size() const
+{
+    std::lock_guard lock{m_upload_mutex};
+
+    return std::size(m_stagings) * m_size;
+}
+
 #ifdef CAPTAL_DEBUG
 void buffer_heap::set_name(std::string_view name)
 {
@@ -212,7 +283,7 @@ static ForwardIt coalesce(ForwardIt begin, ForwardIt end)
     return result;
 }
 
-bool buffer_heap::begin_upload(tph::command_buffer& command_buffer)
+bool buffer_heap::begin_upload(memory_transfer_info& info, bool direct)
 {
     std::unique_lock lock{m_upload_mutex};
 
@@ -229,6 +300,20 @@ bool buffer_heap::begin_upload(tph::command_buffer& command_buffer)
     std::sort(std::begin(m_upload_ranges), std::end(m_upload_ranges), sort_predicate);
     m_upload_ranges.erase(coalesce(std::begin(m_upload_ranges), std::end(m_upload_ranges)), std::end(m_upload_ranges));
 
+    //Staging buffers only let the host copies run on the standalone transfer queue.
+    //Without it, end_upload copies the local buffer directly to the device buffer.
+    if(direct)
+    {
+        for(auto& range : m_upload_ranges)
+        {
+            range.destination_offset = range.source_offset;
+        }
+
+        lock.release();
+
+        return true;
+    }
+
     const auto accumulator = [](std::uint64_t left, tph::buffer_copy& right)
     {
         return left + right.size;
@@ -276,6 +361,7 @@ bool buffer_heap::begin_upload(tph::command_buffer& command_buffer)
         constexpr auto usage{tph::buffer_usage::transfer_source | tph::buffer_usage::transfer_destination};
 
         m_stagings.emplace_back(staging_buffer{tph::buffer{engine::instance().renderer(), m_size, usage}});
+        m_stagings.back().memory = memory_tracking{memory_category::staging, memory_location::host, m_size};
 
         #ifdef CAPTAL_DEBUG
         if(!std::empty(m_name))
@@ -298,18 +384,30 @@ bool buffer_heap::begin_upload(tph::command_buffer& command_buffer)
 
     staging_buffer& staging{m_stagings[m_current_staging]};
     staging.used |= m_current_mask;
+    staging.last_use = engine::instance().frame();
+
+    tph::cmd::copy(info.buffer, m_local_data, staging.buffer, m_upload_ranges);
 
-    tph::cmd::copy(command_buffer, m_local_data, staging.buffer, m_upload_ranges);
+    const std::uint64_t staging_offset{chunk_size * m_current_mask_index};
+    info.ownership.release(info.buffer, tph::pipeline_stage::transfer, tph::buffer_memory_barrier{staging.buffer, staging_offset, total_size, tph::resource_access::transfer_write, tph::resource_access::transfer_read});
 
     lock.release();
 
     return true;
 }
 
-void buffer_heap::end_upload(tph::command_buffer& command_buffer, transfer_ended_signal& signal)
+void buffer_heap::end_upload(tph::command_buffer& command_buffer, transfer_ended_signal& signal, bool direct)
 {
     std::unique_lock lock{m_upload_mutex, std::adopt_lock};
 
+    if(direct)
+    {
+        tph::cmd::copy(command_buffer, m_local_data, m_device_data, m_upload_ranges);
+        m_upload_ranges.clear();
+
+        return;
+    }
+
     staging_buffer& staging{m_stagings[m_current_staging]};
 
     for(auto& range : m_upload_ranges)
@@ -326,6 +424,107 @@ void buffer_heap::end_upload(tph::command_buffer& command_buffer, transfer_ended
     });
 }
 
+bool buffer_heap::upload_slice(bool write)
+{
+    std::lock_guard lock{m_upload_mutex};
+
+    const bool registered{!std::empty(m_upload_ranges)};
+
+    if(registered)
+    {
+        const auto sort_predicate = [](const tph::buffer_copy& left, const tph::buffer_copy& right)
+        {
+            return left.source_offset < right.source_offset;
+        };
+
+        std::sort(std::begin(m_upload_ranges), std::end(m_upload_ranges), sort_predicate);
+        m_upload_ranges.erase(coalesce(std::begin(m_upload_ranges), std::end(m_upload_ranges)), std::end(m_upload_ranges));
+
+        //Each slice receives the ranges once it becomes the current one
+        for(auto& ranges : m_slice_ranges)
+        {
+            ranges.insert(std::end(ranges), std::begin(m_upload_ranges), std::end(m_upload_ranges));
+
+            std::sort(std::begin(ranges), std::end(ranges), sort_predicate);
+            ranges.erase(coalesce(std::begin(ranges), std::end(ranges)), std::end(ranges));
+        }
+
+        m_upload_ranges.clear();
+    }
+
+    auto& ranges{m_slice_ranges[m_slice.load(std::memory_order_relaxed)]};
+
+    if(write && !std::empty(ranges))
+    {
+        const std::uint64_t base{slice_offset()};
+
+        for(const auto& range : ranges)
+        {
+            std::memcpy(m_device_map + base + range.source_offset, reinterpret_cast<const std::uint8_t*>(m_local_map) + range.source_offset, range.size);
+            m_device_data.flush(base + range.source_offset, range.size);
+        }
+
+        ranges.clear();
+    }
+
+    return registered;
+}
+
+bool buffer_heap::relocate(std::span<const std::reference_wrapper<buffer_heap>> destinations)
+{
+    //Moving the chunks changes the ranges, so work on a copy
+    std::vector<range> ranges{};
+
+    {
+        std::lock_guard lock{m_mutex};
+        ranges = m_ranges;
+    }
+
+    for(auto&& range : ranges)
+    {
+        assert(range.owner && "cpt::buffer_heap::relocate called while a chunk is being allocated");
+
+        for(buffer_heap& destination : destinations)
+        {
+            if(destination.free_space() < range.size)
+            {
+                continue;
+            }
+
+            auto chunk{destination.try_allocate(range.size, range.alignment)};
+
+            if(chunk)
+            {
+                //The local copy is always up to date, the device copy is made by the next upload
+                std::memcpy(chunk->map(), reinterpret_cast<const std::uint8_t*>(m_local_map) + range.offset, range.size);
+                chunk->upload();
+
+                //The owner takes the new chunk, the old one is freed at the end of the scope
+                *range.owner = std::move(*chunk);
+
+                break;
+            }
+        }
+    }
+
+    return allocation_count() == 0;
+}
+
+std::size_t buffer_heap::trim_stagings(std::uint64_t frame, std::uint64_t idle_frames)
+{
+    std::lock_guard lock{m_upload_mutex};
+
+    //Uploads capture the index of their staging buffer, only the last ones can be removed
+    std::size_t output{};
+    while(!std::empty(m_stagings) && m_stagings.back().used == 0 && frame - m_stagings.back().last_use >= idle_frames)
+    {
+        m_stagings.pop_back();
+        ++output;
+    }
+
+    return output;
+}
+
 void buffer_heap::register_upload(std::uint64_t offset, std::uint64_t size) noexcept
 {
     std::lock_guard lock{m_upload_mutex};
@@ -335,6 +534,21 @@ void buffer_heap::register_upload(std::uint64_t offset, std::uint64_t size) noex
     m_upload_ranges.emplace_back(offset, 0, size);
 }
 
+void buffer_heap::register_owner(buffer_heap_chunk& chunk) noexcept
+{
+    std::lock_guard lock{m_mutex};
+
+    const auto predicate = [](const range& range, const buffer_heap_chunk& chunk)
+    {
+        return range.offset < chunk.m_offset;
+    };
+
+    const auto it{std::lower_bound(std::begin(m_ranges), std::end(m_ranges), chunk, predicate)};
+    assert(it != std::end(m_ranges) && it->offset == chunk.m_offset && "Bad memory heap chunk.");
+
+    it->owner = &chunk;
+}
+
 void buffer_heap::unregister_chunk(const buffer_heap_chunk& chunk) noexcept
 {
     std::lock_guard lock{m_mutex};
@@ -356,33 +570,26 @@ void buffer_heap::unregister_chunk(const buffer_heap_chunk& chunk) noexcept
 buffer_pool::buffer_pool(tph::buffer_usage pool_usage, std::uint64_t pool_size)
 :m_pool_usage{pool_usage}
 ,m_pool_size{pool_size}
+,m_staging_budget{pool_size * 4}
 {
 
 }
 
 buffer_heap_chunk buffer_pool::allocate(std::uint64_t size, std::uint64_t alignment)
 {
+    std::lock_guard lock{m_mutex};
+
     if(size > m_pool_size)
     {
-        auto heap {std::make_unique<buffer_heap>(size, m_pool_usage)};
-        auto chunk{heap->allocate_first(size)};
-
-        #ifdef CAPTAL_DEBUG
-        if(!std::empty(m_name))
-        {
-            heap->set_name(m_name + " heap #" + std::to_string(std::size(m_heaps)));
-        }
-        #endif
+        auto heap {make_heap(size)};
+        auto chunk{heap->allocate_first(size, alignment)};
 
-        std::lock_guard lock{m_mutex};
         m_to_end.emplace_back();
         m_heaps.emplace_back(std::move(heap));
 
         return chunk;
     }
 
-    std::lock_guard lock{m_mutex};
-
     if(!std::empty(m_heaps))
     {
         stack_memory_pool<512> pool{};
@@ -418,8 +625,35 @@ buffer_heap_chunk buffer_pool::allocate(std::uint64_t size, std::uint64_t alignm
         }
     }
 
-    auto heap {std::make_unique<buffer_heap>(m_pool_size, m_pool_usage)};
-    auto chunk{heap->allocate_first(size)};
+    auto heap {make_heap(m_pool_size)};
+    auto chunk{heap->allocate_first(size, alignment)};
+
+    m_to_end.emplace_back();
+    m_heaps.emplace_back(std::move(heap));
+
+    return chunk;
+}
+
+std::unique_ptr<buffer_heap> buffer_pool::make_heap(std::uint64_t size)
+{
+    //The engine does not exist yet when its own pool is created
+    if(!std::exchange(m_ring_checked, true))
+    {
+        auto& renderer{engine::instance().renderer()};
+
+        m_ring = renderer.allocator().device_memory_host_visible();
+
+        if(m_ring)
+        {
+            for(auto& fence : m_slice_fences)
+            {
+                fence = tph::fence{renderer, true};
+            }
+        }
+    }
+
+    auto heap{std::make_unique<buffer_heap>(size, m_pool_usage, m_ring)};
+    heap->m_slice.store(m_slice, std::memory_order_relaxed);
 
     #ifdef CAPTAL_DEBUG
     if(!std::empty(m_name))
@@ -428,44 +662,153 @@ buffer_heap_chunk buffer_pool::allocate(std::uint64_t size, std::uint64_t alignm
     }
     #endif
 
-    m_to_end.emplace_back();
-    m_heaps.emplace_back(std::move(heap));
-
-    return chunk;
+    return heap;
 }
 
 void buffer_pool::upload(memory_transfer_info info)
 {
+    upload(info, info);
+}
+
+void buffer_pool::upload(memory_transfer_info staging, memory_transfer_info device)
+{
+    CAPTAL_PROFILE_SCOPE("cpt::buffer_pool::upload");
+
+    if(is_ring())
+    {
+        upload_ring();
+
+        return;
+    }
+
     std::lock_guard lock{m_mutex};
 
     #ifdef CAPTAL_DEBUG
-    tph::cmd::begin_label(info.buffer, m_name + " transfer", 0.961f, 0.961f, 0.863f, 1.0f);
+    tph::cmd::begin_label(staging.buffer, m_name + " transfer", 0.961f, 0.961f, 0.863f, 1.0f);
+
+    if(&staging.buffer != &device.buffer)
+    {
+        tph::cmd::begin_label(device.buffer, m_name + " transfer", 0.961f, 0.961f, 0.863f, 1.0f);
+    }
     #endif
 
+    //Both copies end up on the graphics queue, staging would only add a copy
+    const bool direct{&staging.buffer == &device.buffer || !engine::instance().transfer_scheduler().has_standalone_queue()};
+
+    //The host to staging copies are released to the device copies, with a simple barrier if both are recorded on the same queue family
     for(std::size_t i{}; i < std::size(m_heaps); ++i)
     {
-        m_to_end[i] = m_heaps[i]->begin_upload(info.buffer);
+        m_to_end[i] = m_heaps[i]->begin_upload(staging, direct);
     }
 
-    tph::cmd::pipeline_barrier(info.buffer, tph::resource_access::transfer_write, tph::resource_access::transfer_read, tph::dependency_flags::none,
-                                            tph::pipeline_stage::transfer, tph::pipeline_stage::transfer);
-
     for(std::size_t i{}; i < std::size(m_heaps); ++i)
     {
         if(m_to_end[i])
         {
-            m_heaps[i]->end_upload(info.buffer, info.signal);
+            m_heaps[i]->end_upload(device.buffer, device.signal, direct);
+        }
+    }
+
+    //Staging buffers in use by the uploads above are never freed
+    std::uint64_t staging_size{};
+    for(auto& heap : m_heaps)
+    {
+        staging_size += heap->staging_size();
+    }
+
+    if(staging_size > m_staging_budget)
+    {
+        for(auto& heap : m_heaps)
+        {
+            heap->trim_stagings(engine::instance().frame(), m_staging_idle_frames);
         }
     }
 
     #ifdef CAPTAL_DEBUG
-    tph::cmd::end_label(info.buffer);
+    tph::cmd::end_label(staging.buffer);
+
+    if(&staging.buffer != &device.buffer)
+    {
+        tph::cmd::end_label(device.buffer);
+    }
     #endif
 }
 
 void buffer_pool::upload()
 {
-    upload(cpt::engine::instance().transfer_scheduler().begin_transfer());
+    if(is_ring())
+    {
+        CAPTAL_PROFILE_SCOPE("cpt::buffer_pool::upload");
+
+        upload_ring();
+
+        return;
+    }
+
+    auto& scheduler{cpt::engine::instance().transfer_scheduler()};
+
+    //Staging copies can run on the standalone transfer queue, device copies must stay on the graphics queue
+    //because the device buffers may be in use by previously submitted frames.
+    upload(scheduler.begin_transfer(transfer_queue::transfer), scheduler.begin_transfer(transfer_queue::graphics));
+}
+
+static std::atomic<std::uint64_t> current_relocation_epoch{};
+
+void buffer_pool::upload_ring()
+{
+    std::lock_guard lock{m_mutex};
+
+    auto& renderer{engine::instance().renderer()};
+
+    //Frames that read the slice left by the previous upload have all been submitted since, the fence is signaled once they are done
+    if(m_released_slice)
+    {
+        auto& fence{m_slice_fences[*m_released_slice]};
+        fence.reset();
+
+        std::unique_lock queue_lock{engine::instance().submit_mutex()};
+        tph::submit(renderer, tph::submit_info{}, fence);
+        queue_lock.unlock();
+
+        m_released_slice.reset();
+    }
+
+    //Submitted frames may still read the current slice if it has already been used by a previous frame,
+    //ranges are then written once the next slice is current
+    bool registered{};
+    for(auto& heap : m_heaps)
+    {
+        if(heap->upload_slice(m_writable))
+        {
+            registered = true;
+        }
+    }
+
+    //Moving to another slice makes all frames record again, so it is only done while the buffers change
+    if(registered || m_registered)
+    {
+        const std::uint32_t next{(m_slice + 1) % buffer_heap::ring_size};
+        m_slice_fences[next].wait();
+
+        m_released_slice = m_slice;
+        m_slice = next;
+
+        for(auto& heap : m_heaps)
+        {
+            heap->m_slice.store(m_slice, std::memory_order_relaxed);
+        }
+
+        m_writable = true;
+
+        current_relocation_epoch.fetch_add(1, std::memory_order_relaxed);
+        touch_scene();
+    }
+    else
+    {
+        m_writable = false;
+    }
+
+    m_registered = registered;
 }
 
 void buffer_pool::clean()
@@ -478,6 +821,112 @@ void buffer_pool::clean()
     };
 
     m_heaps.erase(std::remove_if(std::begin(m_heaps), std::end(m_heaps), predicate), std::end(m_heaps));
+    m_to_end.resize(std::size(m_heaps));
+}
+
+std::size_t buffer_pool::compact(float threshold)
+{
+    CAPTAL_PROFILE_SCOPE("cpt::buffer_pool::compact");
+
+    //The device copies of the heaps that will be freed may still be in use
+    engine::instance().renderer().wait();
+
+    std::lock_guard lock{m_mutex};
+
+    const auto usage = [](const buffer_heap& heap)
+    {
+        return static_cast<float>(heap.size() - heap.free_space()) / static_cast<float>(heap.size());
+    };
+
+    //Least used heaps are emptied first, into the most used ones
+    std::sort(std::begin(m_heaps), std::end(m_heaps), [](const std::unique_ptr<buffer_heap>& left, const std::unique_ptr<buffer_heap>& right)
+    {
+        return left->free_space() > right->free_space();
+    });
+
+    std::vector<std::reference_wrapper<buffer_heap>> destinations{};
+    destinations.reserve(std::size(m_heaps));
+
+    bool relocated{};
+    for(std::size_t i{}; i < std::size(m_heaps); ++i)
+    {
+        auto& heap{*m_heaps[i]};
+
+        //Dedicated heaps of big buffers never move
+        if(heap.size() != m_pool_size || heap.allocation_count() == 0 || usage(heap) >= threshold)
+        {
+            continue;
+        }
+
+        destinations.clear();
+        for(std::size_t j{std::size(m_heaps)}; j > i + 1; --j)
+        {
+            if(m_heaps[j - 1]->size() == m_pool_size)
+            {
+                destinations.emplace_back(std::ref(*m_heaps[j - 1]));
+            }
+        }
+
+        const std::size_t allocation_count{heap.allocation_count()};
+        heap.relocate(destinations);
+        relocated = relocated || heap.allocation_count() != allocation_count;
+    }
+
+    const std::size_t heap_count{std::size(m_heaps)};
+
+    std::erase_if(m_heaps, [](const std::unique_ptr<buffer_heap>& heap)
+    {
+        return heap->allocation_count() == 0;
+    });
+
+    m_to_end.resize(std::size(m_heaps));
+
+    if(relocated)
+    {
+        //Descriptor sets and recorded command buffers still refer to the old heaps
+        current_relocation_epoch.fetch_add(1, std::memory_order_relaxed);
+        touch_scene();
+    }
+
+    return heap_count - std::size(m_heaps);
+}
+
+std::size_t buffer_pool::trim(std::uint64_t idle_frames)
+{
+    std::lock_guard lock{m_mutex};
+
+    std::size_t output{};
+    for(auto& heap : m_heaps)
+    {
+        output += heap->trim_stagings(engine::instance().frame(), idle_frames);
+    }
+
+    return output;
+}
+
+memory_heap_statistics buffer_pool::statistics() const
+{
+    std::lock_guard lock{m_mutex};
+
+    std::uint64_t allocation_count{};
+    std::uint64_t allocated{};
+    std::uint64_t used{};
+    std::uint64_t largest_free_block{};
+
+    for(auto&& heap : m_heaps)
+    {
+        allocation_count += heap->allocation_count();
+        allocated += heap->size();
+        used += heap->size() - heap->free_space();
+        largest_free_block = std::max(largest_free_block, heap->largest_free_block());
+    }
+
+    return make_memory_heap_statistics(std::size(m_heaps), allocation_count, allocated, used, largest_free_block);
+}
+
+std::uint64_t buffer_relocation_epoch() noexcept
+{
+    return current_relocation_epoch.load(std::memory_order_relaxed);
 }
 
 #ifdef CAPTAL_DEBUG
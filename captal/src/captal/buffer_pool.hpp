@@ -25,10 +25,18 @@
 
 #include "config.hpp"
 
+#include <optional>
+#include <span>
+#include <functional>
+#include <array>
+#include <atomic>
+
 #include <tephra/buffer.hpp>
+#include <tephra/synchronization.hpp>
 
 #include "signal.hpp"
 #include "memory_transfer.hpp"
+#include "memory_statistics.hpp"
 
 namespace cpt
 {
@@ -91,10 +99,16 @@ private:
     {
         std::uint64_t offset{};
         std::uint64_t size{};
+        std::uint64_t alignment{};
+        buffer_heap_chunk* owner{}; //Updated each time the chunk is moved, used to relocate it
     };
 
 public:
-    explicit buffer_heap(std::uint64_t size, tph::buffer_usage usage);
+    //On devices with host visible device memory, the device buffer is a persistently mapped ring with one slice per frame in flight
+    static constexpr std::uint32_t ring_size{3};
+
+public:
+    explicit buffer_heap(std::uint64_t size, tph::buffer_usage usage, bool ring = false);
     ~buffer_heap();
     buffer_heap(const buffer_heap&) = delete;
     buffer_heap& operator=(const buffer_heap&) = delete;
@@ -102,7 +116,7 @@ public:
     buffer_heap& operator=(buffer_heap&& other) noexcept = delete;
 
     std::optional<buffer_heap_chunk> try_allocate(std::uint64_t size, std::uint64_t alignment);
-    buffer_heap_chunk allocate_first(std::uint64_t size);
+    buffer_heap_chunk allocate_first(std::uint64_t size, std::uint64_t alignment);
 
     tph::buffer& buffer() noexcept
     {
@@ -114,6 +128,17 @@ public:
         return m_device_data;
     }
 
+    //Offset in buffer() of the slice read by the frame being recorded, always 0 without ring
+    std::uint64_t slice_offset() const noexcept
+    {
+        return m_slice.load(std::memory_order_relaxed) * m_slice_size;
+    }
+
+    bool is_ring() const noexcept
+    {
+        return m_device_map != nullptr;
+    }
+
     std::uint64_t size() const noexcept
     {
         return m_size;
@@ -139,6 +164,9 @@ public:
         return m_allocation_count;
     }
 
+    std::uint64_t largest_free_block() const;
+    std::uint64_t staging_size() const;
+
 #ifdef CAPTAL_DEBUG
     void set_name(std::string_view name);
 #else
@@ -149,10 +177,17 @@ public:
 #endif
 
 private:
-    bool begin_upload(tph::command_buffer& command_buffer);
-    void end_upload(tph::command_buffer& command_buffer, transfer_ended_signal& signal);
+    std::optional<std::uint64_t> try_reserve(std::uint64_t size, std::uint64_t alignment);
+
+    bool begin_upload(memory_transfer_info& info, bool direct);
+    void end_upload(tph::command_buffer& command_buffer, transfer_ended_signal& signal, bool direct);
+    bool upload_slice(bool write);
+
+    bool relocate(std::span<const std::reference_wrapper<buffer_heap>> destinations);
+    std::size_t trim_stagings(std::uint64_t frame, std::uint64_t idle_frames);
 
     void register_upload(std::uint64_t offset, std::uint64_t size) noexcept;
+    void register_owner(buffer_heap_chunk& chunk) noexcept;
     void unregister_chunk(const buffer_heap_chunk& chunk) noexcept;
 
 private:
@@ -161,24 +196,32 @@ private:
         tph::buffer buffer{};
         std::uint64_t used{}; //only 4 bits are used
         std::array<cpt::scoped_connection, 4> connection{};
+        memory_tracking memory{};
+        std::uint64_t last_use{}; //engine frame of the last upload
     };
 
 private:
     tph::buffer m_local_data{};
     tph::buffer m_device_data{};
+    memory_tracking m_local_memory{};
+    memory_tracking m_device_memory{};
     std::vector<staging_buffer> m_stagings{};
     std::uint64_t m_size{};
+    std::uint64_t m_slice_size{};
     void* m_local_map{};
+    std::uint8_t* m_device_map{};
+    std::atomic<std::uint32_t> m_slice{};
     std::atomic<std::uint64_t> m_free_space{};
     std::atomic<std::size_t> m_allocation_count{};
     std::vector<range> m_ranges{};
-    std::mutex m_mutex{};
+    mutable std::mutex m_mutex{};
 
     std::vector<tph::buffer_copy> m_upload_ranges{};
+    std::array<std::vector<tph::buffer_copy>, ring_size> m_slice_ranges{}; //Ranges each slice of the ring has not received yet
     std::size_t m_current_staging{};
     std::uint64_t m_current_mask{};
     std::uint64_t m_current_mask_index{};
-    std::mutex m_upload_mutex{};
+    mutable std::mutex m_upload_mutex{};
 
 #ifdef CAPTAL_DEBUG
     std::string m_name{};
@@ -197,9 +240,44 @@ public:
 
     buffer_heap_chunk allocate(std::uint64_t size, std::uint64_t alignment);
     void upload(memory_transfer_info info);
+    void upload(memory_transfer_info staging, memory_transfer_info device);
     void upload();
     void clean();
 
+    //Moves the buffers of the heaps used below threshold into the other heaps, then frees the empty heaps.
+    //Waits for the device to be idle, it is meant for loading screens, and must not run concurrently with any use of the pool.
+    //Returns the number of freed heaps.
+    std::size_t compact(float threshold = 0.5f);
+
+    //Frees the staging buffers that have not been used for idle_frames frames, returns the number of freed buffers.
+    //This is done automatically after each upload if the staging buffers take more than the staging budget.
+    std::size_t trim(std::uint64_t idle_frames);
+
+    void set_staging_budget(std::uint64_t bytes, std::uint64_t idle_frames = 120) noexcept
+    {
+        m_staging_budget = bytes;
+        m_staging_idle_frames = idle_frames;
+    }
+
+    std::uint64_t staging_budget() const noexcept
+    {
+        return m_staging_budget;
+    }
+
+    std::uint64_t staging_idle_frames() const noexcept
+    {
+        return m_staging_idle_frames;
+    }
+
+    //Heaps are accounted as memory_category::uniform_pool
+    memory_heap_statistics statistics() const;
+
+    //Uploads write to the slices of persistently mapped rings instead of recording copies
+    bool is_ring() const noexcept
+    {
+        return m_ring.load(std::memory_order_relaxed);
+    }
+
 #ifdef CAPTAL_DEBUG
     void set_name(std::string_view name);
 #else
@@ -209,19 +287,37 @@ public:
     }
 #endif
 
+private:
+    std::unique_ptr<buffer_heap> make_heap(std::uint64_t size);
+    void upload_ring();
+
 private:
     tph::buffer_usage m_pool_usage{};
     std::uint64_t m_pool_size{};
+    std::uint64_t m_staging_budget{};
+    std::uint64_t m_staging_idle_frames{120};
 
     std::vector<bool> m_to_end{};
     std::vector<std::unique_ptr<buffer_heap>> m_heaps{};
     mutable std::mutex m_mutex{};
 
+    bool m_ring_checked{};
+    std::atomic<bool> m_ring{};
+    std::uint32_t m_slice{};
+    bool m_writable{true}; //No submitted frame reads the current slice yet
+    bool m_registered{};
+    std::optional<std::uint32_t> m_released_slice{};
+    std::array<tph::fence, buffer_heap::ring_size> m_slice_fences{};
+
 #ifdef CAPTAL_DEBUG
     std::string m_name{};
 #endif
 };
 
+//Changes each time buffer_pool::compact moves buffers, or a ring pool moves on to another slice.
+//Descriptor sets and dynamic offsets computed before must be computed again.
+CAPTAL_API std::uint64_t buffer_relocation_epoch() noexcept;
+
 }
 
 #endif
@@ -30,6 +30,8 @@
 
 #include <captal_foundation/math.hpp>
 
+#include "../scene_epoch.hpp"
+
 namespace cpt
 {
 
@@ -60,48 +62,56 @@ public:
     {
         m_position = position;
         m_updated = true;
+        touch_scene();
     }
 
     void move(const vec3f& relative) noexcept
     {
         m_position += relative;
         m_updated = true;
+        touch_scene();
     }
 
     void set_origin(const vec3f& origin) noexcept
     {
         m_origin = origin;
         m_updated = true;
+        touch_scene();
     }
 
     void move_origin(const vec3f& relative) noexcept
     {
         m_origin += relative;
         m_updated = true;
+        touch_scene();
     }
 
     void set_rotation(float angle) noexcept
     {
         m_rotation = std::fmod(angle, std::numbers::pi_v<float> * 2.0f);
         m_updated = true;
+        touch_scene();
     }
 
     void set_scale(const vec3f& scale) noexcept
     {
         m_scale = scale;
         m_updated = true;
+        touch_scene();
     }
 
     void scale(const vec3f& scale) noexcept
     {
         m_scale *= scale;
         m_updated = true;
+        touch_scene();
     }
 
     void rotate(float angle) noexcept
     {
         m_rotation = std::fmod(m_rotation + angle, std::numbers::pi_v<float> * 2.0f);
         m_updated = true;
+        touch_scene();
     }
 
     const vec3f& position() const noexcept
@@ -132,6 +142,7 @@ public:
     void update() noexcept
     {
         m_updated = true;
+        touch_scene();
     }
 
     bool is_updated() const noexcept
@@ -23,9 +23,12 @@
 #include "engine.hpp"
 
 #include <iostream>
+#include <thread>
 
 #include <apyre/power.hpp>
 
+#include <captal_foundation/profiler.hpp>
+
 namespace cpt
 {
 
@@ -49,8 +52,6 @@ static constexpr auto default_fragment_shader_spv = std::to_array<std::uint32_t>
 
 static constexpr std::array<std::uint8_t, 4> default_texture_data{255, 255, 255, 255};
 
-using clock = std::chrono::steady_clock;
-
 engine* engine::m_instance{nullptr};
 
 static swl::stream_info make_stream_info(const swl::listener& listener, const swl::audio_world& audio_world, const swl::physical_device& audio_device)
@@ -60,15 +61,17 @@ static swl::stream_info make_stream_info(const swl::listener& listener, const sw
 
 engine::engine(const std::string& application_name, cpt::version version)
 :m_application{application_name, version}
-,m_audio_device{m_application.audio_application().default_output_device()}
-,m_audio_world{m_audio_device.default_sample_rate()}
+,m_audio_device{&m_application.audio_application().default_output_device()}
+,m_audio_world{m_audio_device->default_sample_rate()}
 ,m_audio_pulser{m_audio_world}
-,m_listener{m_audio_pulser.bind(swl::listener{std::min(m_audio_device.max_output_channel(), 2u)})}
-,m_audio_stream{m_application.audio_application(), m_audio_device, make_stream_info(*m_listener, m_audio_world, m_audio_device), swl::listener_bridge{*m_listener}}
+,m_listener{m_audio_pulser.bind(swl::listener{std::min(m_audio_device->max_output_channel(), 2u)})}
+,m_audio_stream{m_application.audio_application(), *m_audio_device, make_stream_info(*m_listener, m_audio_world, *m_audio_device), swl::listener_bridge{*m_listener}}
 ,m_graphics_device{m_application.graphics_application().default_physical_device()}
-,m_renderer{m_graphics_device, graphics_layers, graphics_extensions}
+,m_renderer{m_graphics_device, graphics_layers, graphics_extensions, tph::physical_device_features{}, tph::renderer_options::standalone_transfer_queue}
+,m_pipeline_cache{m_renderer, m_graphics_device, graphics_parameters{}.pipeline_cache_path}
 ,m_uniform_pool{tph::buffer_usage::uniform | tph::buffer_usage::vertex | tph::buffer_usage::index}
 ,m_transfer_scheduler{m_renderer}
+,m_task_pool{task_thread_count()}
 {
     init();
 }
@@ -111,6 +114,26 @@ static const swl::physical_device& default_audio_device(const swl::application&
     throw std::runtime_error{"Can not find any suitable audio device."};
 }
 
+static const swl::physical_device* select_audio_device(const swl::application& application, const system_parameters& system, const audio_parameters& parameters)
+{
+    if(system.headless)
+    {
+        return nullptr;
+    }
+
+    return &default_audio_device(application, parameters);
+}
+
+static swl::stream make_audio_stream(swl::application& application, const swl::physical_device* device, swl::listener& listener, const swl::audio_world& audio_world)
+{
+    if(!device)
+    {
+        return swl::stream{};
+    }
+
+    return swl::stream{application, *device, make_stream_info(listener, audio_world, *device), swl::listener_bridge{listener}};
+}
+
 static const tph::physical_device& default_graphics_device(const tph::application& application, const graphics_parameters& parameters)
 {
     if(parameters.physical_device.has_value())
@@ -136,31 +159,63 @@ static const tph::physical_device& default_graphics_device(const tph::applicatio
     return application.select_physical_device(requirements);
 }
 
+//Half of the cores, the other half keeps running the game
+static std::size_t task_thread_count() noexcept
+{
+    return std::max(std::thread::hardware_concurrency() / 2, 1u);
+}
+
 engine::engine(const std::string& application_name, cpt::version version, const system_parameters& system, const audio_parameters& audio, const graphics_parameters& graphics)
 :engine{cpt::application{application_name, version, system.extensions}, system, audio, graphics}
 {
 
 }
 
-engine::engine(cpt::application application, const system_parameters& system [[maybe_unused]], const audio_parameters& audio, const graphics_parameters& graphics)
+engine::engine(cpt::application application, const system_parameters& system, const audio_parameters& audio, const graphics_parameters& graphics)
 :m_application{std::move(application)}
-,m_audio_device{default_audio_device(m_application.audio_application(), audio)}
-,m_audio_world{audio.frequency}
+,m_headless{system.headless}
+,m_audio_device{select_audio_device(m_application.audio_application(), system, audio)}
+,m_audio_world{audio.frequency, audio.worker_count}
 ,m_audio_pulser{m_audio_world}
 ,m_listener{m_audio_pulser.bind(swl::listener{audio.channel_count})}
-,m_audio_stream{m_application.audio_application(), m_audio_device, make_stream_info(*m_listener, m_audio_world, m_audio_device), swl::listener_bridge{*m_listener}}
+,m_audio_stream{make_audio_stream(m_application.audio_application(), m_audio_device, *m_listener, m_audio_world)}
 ,m_graphics_device{default_graphics_device(m_application.graphics_application(), graphics)}
-,m_renderer{m_graphics_device, graphics_layers | graphics.layers, graphics_extensions | graphics.extensions, graphics.features, graphics.options}
+,m_renderer{m_graphics_device, graphics_layers | graphics.layers, (system.headless ? tph::renderer_extension::none : graphics_extensions) | graphics.extensions, graphics.features, graphics.options}
+,m_pipeline_cache{m_renderer, m_graphics_device, graphics.pipeline_cache_path}
 ,m_uniform_pool{tph::buffer_usage::uniform | tph::buffer_usage::vertex | tph::buffer_usage::index}
 ,m_transfer_scheduler{m_renderer}
+,m_task_pool{task_thread_count()}
 {
     init();
 }
 
 engine::~engine()
 {
+    //Running tasks may use the engine, queued ones are dropped
+    m_task_pool.stop();
     m_renderer.wait();
 
+    if constexpr(debug_enabled)
+    {
+        const auto statistics{m_pipeline_cache.statistics()};
+        const auto milliseconds{std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(statistics.creation_time).count()};
+
+        std::cout << "Pipeline creation: " << statistics.pipeline_count << " pipelines in " << milliseconds << "ms ("
+                  << (statistics.state == pipeline_cache_state::loaded ? "with" : "without") << " pipeline cache)" << std::endl;
+    }
+
+    try
+    {
+        m_pipeline_cache.save();
+    }
+    catch(const std::exception& e)
+    {
+        if constexpr(debug_enabled)
+        {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
     m_update_signal.disconnect_all();
     m_frame_per_second_signal.disconnect_all();
 
@@ -170,6 +225,7 @@ engine::~engine()
 void engine::set_framerate_limit(std::uint32_t frame_per_second) noexcept
 {
     m_frame_rate_limit = frame_per_second;
+    m_frame_pacer.set_frame_rate(frame_per_second == no_frame_rate_limit ? 0 : frame_per_second);
 }
 
 void engine::set_translator(cpt::translator new_translator)
@@ -181,6 +237,9 @@ void engine::set_default_render_layout(render_layout_ptr new_default_render_layo
 {
     m_default_layout = std::move(new_default_render_layout);
 
+    std::lock_guard lock{m_default_techniques_mutex};
+    m_default_techniques.clear();
+
     #ifdef CAPTAL_DEBUG
     m_default_layout->set_name("cpt::engine's default render layout");
     #endif
@@ -190,6 +249,9 @@ void engine::set_default_vertex_shader(tph::shader new_default_vertex_shader) no
 {
     m_default_vertex_shader = std::move(new_default_vertex_shader);
 
+    std::lock_guard lock{m_default_techniques_mutex};
+    m_default_techniques.clear();
+
     #ifdef CAPTAL_DEBUG
     tph::set_object_name(m_renderer, m_default_vertex_shader, "cpt::engine's default vertex shader");
     #endif
@@ -199,24 +261,133 @@ void engine::set_default_fragment_shader(tph::shader new_default_fragment_shader
 {
     m_default_fragment_shader = std::move(new_default_fragment_shader);
 
+    std::lock_guard lock{m_default_techniques_mutex};
+    m_default_techniques.clear();
+
     #ifdef CAPTAL_DEBUG
     tph::set_object_name(m_renderer, m_default_fragment_shader, "cpt::engine's default fragment shader");
     #endif
 }
 
-memory_transfer_info engine::begin_transfer()
+render_technique_ptr engine::default_render_technique(const render_target_ptr& target, cpt::vertex_format format)
+{
+    std::lock_guard lock{m_default_techniques_mutex};
+
+    std::erase_if(m_default_techniques, [](const default_technique& entry)
+    {
+        return entry.target.expired();
+    });
+
+    const auto same_target = [&target](const render_target_weak_ptr& other)
+    {
+        return !other.owner_before(target) && !target.owner_before(other);
+    };
+
+    for(const auto& entry : m_default_techniques)
+    {
+        if(entry.format == format && same_target(entry.target))
+        {
+            return entry.technique;
+        }
+    }
+
+    auto technique{make_render_technique(target, render_technique_info{.vertex_format = format})};
+
+    #ifdef CAPTAL_DEBUG
+    technique->set_name("cpt::engine's default render technique");
+    #endif
+
+    m_default_techniques.emplace_back(default_technique{target, format, technique});
+
+    return technique;
+}
+
+memory_transfer_info engine::begin_transfer(transfer_queue queue)
 {
-    return m_transfer_scheduler.begin_transfer();
+    return m_transfer_scheduler.begin_transfer(queue);
 }
 
 void engine::submit_transfers()
 {
+    stream_textures();
+
     m_uniform_pool.upload();
     m_transfer_scheduler.submit_transfers();
 }
 
+void engine::stream_texture(async_texture_ptr texture)
+{
+    std::lock_guard lock{m_streaming_mutex};
+
+    m_streamed_textures.emplace_back(std::move(texture));
+}
+
+void engine::set_texture_streaming_budget(std::uint64_t bytes_per_frame) noexcept
+{
+    m_texture_streaming_budget = bytes_per_frame;
+}
+
+void engine::stream_textures()
+{
+    std::lock_guard lock{m_streaming_mutex};
+
+    std::erase_if(m_streamed_textures, [](const async_texture_ptr& texture)
+    {
+        return texture->status() == async_texture_status::ready || texture->status() == async_texture_status::failed;
+    });
+
+    //The first texture always makes progress, even if one of its levels is bigger than the budget
+    std::uint64_t budget{m_texture_streaming_budget};
+    for(auto& texture : m_streamed_textures)
+    {
+        budget -= std::min(texture->stream(budget), budget);
+
+        if(budget == 0)
+        {
+            break;
+        }
+    }
+}
+
+std::size_t engine::compact_memory(float threshold)
+{
+    const std::size_t output{m_uniform_pool.compact(threshold)};
+
+    m_renderer.allocator().clean();
+
+    return output;
+}
+
+cpt::memory_statistics engine::memory_statistics() const
+{
+    const auto& allocator{m_renderer.allocator()};
+
+    const auto heap_count{allocator.heap_count()};
+    const auto allocation_count{allocator.allocation_count()};
+    const auto allocated{allocator.allocated_memory()};
+    const auto used{allocator.used_memory()};
+    const auto largest_free_block{allocator.largest_free_block()};
+
+    auto output{tracked_memory_statistics()};
+    output.frame = m_frame_id;
+    output.device_local  = make_memory_heap_statistics(heap_count.device_local, allocation_count.device_local, allocated.device_local, used.device_local, largest_free_block.device_local);
+    output.device_shared = make_memory_heap_statistics(heap_count.device_shared, allocation_count.device_shared, allocated.device_shared, used.device_shared, largest_free_block.device_shared);
+    output.host_shared   = make_memory_heap_statistics(heap_count.host_shared, allocation_count.host_shared, allocated.host_shared, used.host_shared, largest_free_block.host_shared);
+    output.uniform_pool  = m_uniform_pool.statistics();
+    output.frame_memory  = m_frame_memory_statistics;
+
+    return output;
+}
+
 bool engine::run()
 {
+    CAPTAL_PROFILE_SCOPE("cpt::engine::run");
+
+    //Transient containers of the previous frame are all gone, start again from the beginning of the arena
+    m_frame_memory_statistics = frame_memory().stats();
+    frame_memory().reset();
+    end_memory_frame();
+
     update_frame();
     m_update_signal(m_frame_time);
 
@@ -253,8 +424,11 @@ void engine::init()
 
     m_audio_world.set_up(vec3f{0.0f, 0.0f, 1.0f});
     m_listener->set_direction(vec3f{0.0f, 1.0f, 0.0f});
-    m_audio_pulser.start();
-    m_audio_stream.start();
+    if(!m_headless)
+    {
+        m_audio_pulser.start();
+        m_audio_stream.start();
+    }
 
     set_default_vertex_shader(tph::shader{m_renderer, tph::shader_stage::vertex, default_vertex_shader_spv});
     set_default_fragment_shader(tph::shader{m_renderer, tph::shader_stage::fragment, default_fragment_shader_spv});
@@ -266,7 +440,7 @@ void engine::init()
 
     render_layout_info renderable_info{};
     renderable_info.bindings.reserve(2);
-    renderable_info.bindings.emplace_back(tph::shader_stage::vertex, 0, tph::descriptor_type::uniform_buffer);
+    renderable_info.bindings.emplace_back(tph::shader_stage::vertex, 0, tph::descriptor_type::uniform_buffer_dynamic); //dynamic, so renderables can share descriptor sets
     renderable_info.bindings.emplace_back(tph::shader_stage::fragment, 1, tph::descriptor_type::image_sampler);
     renderable_info.default_bindings.emplace(1, make_texture(1, 1, std::data(default_texture_data), default_sampling));
 
@@ -362,13 +536,40 @@ void engine::init()
             std::cout << "    Battery life: " << static_cast<std::uint32_t>(power_status.battery->remaining * 100.0) << "%\n";
         }
 
-        std::cout << "  Audio device: " << m_audio_device.name() << "\n";
-        std::cout << "    Channels: " << m_listener->channel_count() << "\n";
-        std::cout << "    Sample rate: " << m_audio_world.sample_rate() << "Hz\n";
-        std::cout << "    Output latency: " << m_audio_device.default_low_output_latency().count() << "s\n";
+        if(m_audio_device)
+        {
+            std::cout << "  Audio device: " << m_audio_device->name() << "\n";
+            std::cout << "    Channels: " << m_listener->channel_count() << "\n";
+            std::cout << "    Sample rate: " << m_audio_world.sample_rate() << "Hz\n";
+            std::cout << "    Output latency: " << m_audio_device->default_low_output_latency().count() << "s\n";
+        }
+        else
+        {
+            std::cout << "  Audio device: None (headless)\n";
+        }
 
         std::cout << "  Graphics device: " << m_graphics_device.properties().name << "\n";
         std::cout << "    Pipeline Cache UUID: " << format_uuid(m_graphics_device.properties().uuid) << "\n";
+
+        const auto format_pipeline_cache_state = [](pipeline_cache_state state) -> std::string_view
+        {
+            switch(state)
+            {
+                case pipeline_cache_state::empty: return "Empty";
+                case pipeline_cache_state::loaded: return "Loaded";
+                case pipeline_cache_state::invalidated: return "Invalidated (device or driver changed)";
+                default: return "Unknown";
+            }
+        };
+
+        std::cout << "    Pipeline Cache: " << format_pipeline_cache_state(m_pipeline_cache.statistics().state);
+
+        if(m_pipeline_cache.statistics().state == pipeline_cache_state::loaded)
+        {
+            std::cout << " (" << format_data(m_pipeline_cache.statistics().loaded_size) << ")";
+        }
+
+        std::cout << "\n";
         std::cout << "    Heap sizes:\n";
         std::cout << "      Host shared: " << format_data(m_renderer.allocator().default_heap_sizes().host_shared) << "\n";
         std::cout << "      Device shared: " << format_data(m_renderer.allocator().default_heap_sizes().device_shared) << "\n";
@@ -395,8 +596,8 @@ void engine::update_frame()
     ++m_frame_id;
     ++m_frame_per_second_counter;
 
-    m_frame_time = std::chrono::duration_cast<std::chrono::duration<float>>(clock::now() - m_last_update).count();
-    m_last_update = clock::now();
+    //Waits for the frame rate limit first, so the frame time includes the wait
+    m_frame_time = std::chrono::duration_cast<std::chrono::duration<float>>(m_frame_pacer.next_frame()).count();
 
     m_frame_per_second_timer += m_frame_time;
 
@@ -413,16 +614,6 @@ void engine::update_frame()
         m_frame_per_second_counter = 0;
         m_frame_per_second_timer -= 1.0f;
     }
-
-    if(m_frame_rate_limit != no_frame_rate_limit)
-    {
-        const float frame_time_target{1.0f / static_cast<float>(m_frame_rate_limit)};
-
-        if(m_frame_time < frame_time_target)
-        {
-            std::this_thread::sleep_for(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<float>(frame_time_target - m_frame_time)));
-        }
-    }
 }
 
 }
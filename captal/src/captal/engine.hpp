@@ -28,6 +28,10 @@
 #include <optional>
 #include <memory>
 
+#include <captal_foundation/frame_allocator.hpp>
+#include <captal_foundation/frame_pacer.hpp>
+#include <captal_foundation/task_pool.hpp>
+
 #include <swell/stream.hpp>
 #include <swell/audio_pulser.hpp>
 
@@ -39,10 +43,13 @@
 #include "application.hpp"
 #include "render_window.hpp"
 #include "memory_transfer.hpp"
+#include "pipeline_cache.hpp"
 #include "buffer_pool.hpp"
+#include "async_texture.hpp"
 #include "render_technique.hpp"
 #include "translation.hpp"
 #include "font.hpp"
+#include "memory_statistics.hpp"
 
 namespace cpt
 {
@@ -50,6 +57,7 @@ namespace cpt
 struct system_parameters
 {
     apr::application_extension extensions{};
+    bool headless{}; //No audio device and no swapchain, rendering must be done in render textures
 };
 
 struct audio_parameters
@@ -58,16 +66,18 @@ struct audio_parameters
     std::uint32_t frequency{};
     swl::seconds minimum_latency{0.010};
     swl::seconds resync_threshold{0.050};
+    std::uint32_t worker_count{}; //Threads used by the audio world to decode sounds and mix listeners in parallel
     optional_ref<const swl::physical_device> physical_device{};
 };
 
 struct graphics_parameters
 {
-    tph::renderer_options options{};
+    tph::renderer_options options{tph::renderer_options::standalone_transfer_queue};
     tph::renderer_layer layers{};
     tph::renderer_extension extensions{};
     tph::physical_device_features features{};
     optional_ref<const tph::physical_device> physical_device{};
+    std::filesystem::path pipeline_cache_path{"captal_pipeline.cache"}; //Empty path disables persistence
 };
 
 using update_signal = cpt::signal<float>;
@@ -97,9 +107,16 @@ public:
     void set_default_vertex_shader(tph::shader new_default_vertex_shader) noexcept;
     void set_default_fragment_shader(tph::shader new_default_fragment_shader) noexcept;
 
-    memory_transfer_info begin_transfer();
+    memory_transfer_info begin_transfer(transfer_queue queue = transfer_queue::graphics);
     void submit_transfers();
 
+    void stream_texture(async_texture_ptr texture);
+    void set_texture_streaming_budget(std::uint64_t bytes_per_frame) noexcept;
+
+    //Compacts the uniform pool (see buffer_pool::compact) then returns the empty GPU heaps to the driver.
+    //Waits for the device to be idle, it is meant for level transitions.
+    std::size_t compact_memory(float threshold = 0.5f);
+
     bool run();
 
     static engine& instance() noexcept;
@@ -117,7 +134,9 @@ public:
 
     const swl::physical_device& audio_device() const noexcept
     {
-        return m_audio_device;
+        assert(m_audio_device && "cpt::engine::audio_device called on an headless engine.");
+
+        return *m_audio_device;
     }
 
     swl::audio_world& audio_world() noexcept
@@ -175,6 +194,16 @@ public:
         return m_renderer;
     }
 
+    cpt::pipeline_cache& pipeline_cache() noexcept
+    {
+        return m_pipeline_cache;
+    }
+
+    const cpt::pipeline_cache& pipeline_cache() const noexcept
+    {
+        return m_pipeline_cache;
+    }
+
     memory_transfer_scheduler& transfer_scheduler() noexcept
     {
         return m_transfer_scheduler;
@@ -220,6 +249,16 @@ public:
         return m_default_layout;
     }
 
+    //Technique with default shaders and default layout, built once per render target and vertex format.
+    //It is rebuilt after a change of the default shaders or layout.
+    render_technique_ptr default_render_technique(const render_target_ptr& target, cpt::vertex_format format);
+
+    //Background threads for long tasks, such as asynchronous pipeline compilation
+    cpt::task_pool& task_pool() noexcept
+    {
+        return m_task_pool;
+    }
+
     const cpt::translator& translator() const noexcept
     {
         return m_translator;
@@ -235,6 +274,11 @@ public:
         return m_font_engine;
     }
 
+    bool is_headless() const noexcept
+    {
+        return m_headless;
+    }
+
     float frame_time() const noexcept
     {
         return m_frame_time;
@@ -255,14 +299,49 @@ public:
         return m_frame_per_second_signal;
     }
 
+    //Frame rate limit and frame time percentiles, its timeline can be aligned on present times
+    cpt::frame_pacer& frame_pacer() noexcept
+    {
+        return m_frame_pacer;
+    }
+
+    const cpt::frame_pacer& frame_pacer() const noexcept
+    {
+        return m_frame_pacer;
+    }
+
+    std::uint64_t texture_streaming_budget() const noexcept
+    {
+        return m_texture_streaming_budget;
+    }
+
+    //Frame arena usage of the main thread during the last frame
+    const frame_memory_resource::statistics& frame_memory_statistics() const noexcept
+    {
+        return m_frame_memory_statistics;
+    }
+
+    //GPU memory by category and heap, with the allocations counters of the last frame
+    cpt::memory_statistics memory_statistics() const;
+
+private:
+    struct default_technique
+    {
+        render_target_weak_ptr target{};
+        cpt::vertex_format format{};
+        render_technique_ptr technique{};
+    };
+
 private:
     void init();
     void update_frame();
+    void stream_textures();
 
 private:
     cpt::application m_application;
+    bool m_headless{};
 
-    const swl::physical_device& m_audio_device;
+    const swl::physical_device* m_audio_device;
     swl::audio_world m_audio_world;
     swl::audio_pulser m_audio_pulser;
     swl::listener_bind m_listener;
@@ -270,19 +349,26 @@ private:
 
     const tph::physical_device& m_graphics_device;
     tph::renderer m_renderer;
+    cpt::pipeline_cache m_pipeline_cache;
 
     buffer_pool m_uniform_pool;
     memory_transfer_scheduler m_transfer_scheduler;
+    cpt::task_pool m_task_pool;
 
     std::mutex m_queue_mutex{};
+    std::vector<async_texture_ptr> m_streamed_textures{};
+    std::uint64_t m_texture_streaming_budget{16 * 1024 * 1024};
+    std::mutex m_streaming_mutex{};
     tph::shader m_default_vertex_shader{};
     tph::shader m_default_fragment_shader{};
     render_layout_ptr m_default_layout{};
+    std::vector<default_technique> m_default_techniques{};
+    std::mutex m_default_techniques_mutex{};
 
     cpt::translator m_translator{};
     cpt::font_engine m_font_engine{};
 
-    std::chrono::steady_clock::time_point m_last_update{std::chrono::steady_clock::now()};
+    cpt::frame_pacer m_frame_pacer{};
     float m_frame_time{};
     std::uint32_t m_frame_rate_limit{no_frame_rate_limit};
     float m_frame_per_second_timer{};
@@ -290,6 +376,7 @@ private:
     std::uint32_t m_frame_per_second{};
     std::uint64_t m_frame_id{};
     frame_per_second_signal m_frame_per_second_signal{};
+    frame_memory_resource::statistics m_frame_memory_statistics{};
     update_signal m_update_signal{};
 };
 
@@ -98,6 +98,8 @@ font_atlas::font_atlas(glyph_format format, const tph::sampler_info& sampling)
         m_texture = make_texture(m_sampling, default_size, default_size, tph::texture_info{tph::texture_format::r8g8b8a8_srgb, font_atlas_usage});
     }
 
+    m_texture->set_memory_category(memory_category::font_atlas);
+
     m_buffers.reserve(64);
     m_buffer_data.reserve(1024 * 8);
 }
@@ -190,7 +192,8 @@ std::optional<bin_packer::rect> font_atlas::add_glyph(std::span<const uint8_t> i
 
 void font_atlas::upload()
 {
-    auto&& [buffer, signal, keeper] = engine::instance().begin_transfer();
+    //Partial updates must preserve the current content of the atlas, so they stay on the graphics queue
+    auto&& [buffer, signal, keeper, ownership] = engine::instance().begin_transfer();
 
     if(std::exchange(m_resized, false))
     {
@@ -260,7 +263,7 @@ void font_atlas::upload()
     tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::fragment_shader, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
 
     keeper.keep(m_texture);
-    signal.connect([buffer = std::move(staging_buffer)](){});
+    signal.connect([memory = memory_tracking{memory_category::staging, memory_location::host, staging_buffer.size()}, buffer = std::move(staging_buffer)](){});
 
     m_buffers.clear();
     m_buffer_data.clear();
@@ -287,6 +290,8 @@ void font_atlas::resize(tph::command_buffer& buffer, asynchronous_resource_keepe
         new_texture = make_texture(m_sampling, m_packer.width(), m_packer.height(), tph::texture_info{tph::texture_format::r8g8b8a8_srgb, font_atlas_usage});
     }
 
+    new_texture->set_memory_category(memory_category::font_atlas);
+
 #ifdef CAPTAL_DEBUG
     if(!std::empty(m_name))
     {
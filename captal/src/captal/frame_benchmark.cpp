@@ -0,0 +1,194 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include "frame_benchmark.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+static std::uint64_t total_allocation_count()
+{
+    const auto count{engine::instance().renderer().allocator().allocation_count()};
+
+    return count.host_shared + count.device_local + count.device_shared;
+}
+
+static frame_benchmark_statistics make_statistics(std::vector<std::chrono::nanoseconds> times)
+{
+    if(std::empty(times))
+    {
+        return frame_benchmark_statistics{};
+    }
+
+    std::sort(std::begin(times), std::end(times));
+
+    const auto percentile = [&times](double value)
+    {
+        return times[static_cast<std::size_t>(value * static_cast<double>(std::size(times) - 1))];
+    };
+
+    frame_benchmark_statistics output{};
+    output.minimum = times.front();
+    output.mean = std::accumulate(std::begin(times), std::end(times), std::chrono::nanoseconds{}) / std::size(times);
+    output.median = percentile(0.5);
+    output.p99 = percentile(0.99);
+    output.maximum = times.back();
+
+    return output;
+}
+
+frame_benchmark::frame_benchmark(std::uint32_t frame_count, std::uint32_t warmup_frame_count)
+:m_frame_count{frame_count}
+,m_warmup_frame_count{warmup_frame_count}
+{
+    m_cpu_times.reserve(frame_count);
+    m_gpu_times.reserve(frame_count);
+}
+
+bool frame_benchmark::next_frame()
+{
+    const auto now{clock::now()};
+
+    if(std::exchange(m_started, true))
+    {
+        if(measuring())
+        {
+            //engine::run has just closed this frame
+            const auto& memory{engine::instance().frame_memory_statistics()};
+
+            m_cpu_times.emplace_back(now - m_frame_begin);
+            m_frame_allocation_count += memory.allocation_count;
+            m_frame_heap_allocation_count += memory.heap_allocation_count;
+        }
+
+        ++m_frame;
+    }
+
+    if(m_frame == m_warmup_frame_count)
+    {
+        m_begin_allocation_count = total_allocation_count();
+    }
+
+    m_frame_begin = now;
+
+    return m_frame < m_warmup_frame_count + m_frame_count;
+}
+
+void frame_benchmark::time_gpu(const frame_render_info& info)
+{
+    assert(info.time_signal && "cpt::frame_benchmark::time_gpu called with a frame that is not timed.");
+
+    if(measuring())
+    {
+        info.time_signal->connect([this](frame_time_t time)
+        {
+            m_gpu_times.emplace_back(std::chrono::duration_cast<std::chrono::nanoseconds>(time));
+        });
+    }
+}
+
+frame_benchmark_report frame_benchmark::report() const
+{
+    frame_benchmark_report output{};
+    output.frame_count = static_cast<std::uint32_t>(std::size(m_cpu_times));
+    output.cpu_time = make_statistics(m_cpu_times);
+    output.gpu_time = make_statistics(m_gpu_times);
+    output.allocation_count = engine::cinstance().renderer().allocator().allocation_count();
+    output.allocation_delta = static_cast<std::int64_t>(total_allocation_count()) - static_cast<std::int64_t>(m_begin_allocation_count);
+    output.frame_allocation_count = m_frame_allocation_count;
+    output.frame_heap_allocation_count = m_frame_heap_allocation_count;
+
+    output.systems.reserve(std::size(m_systems));
+    for(auto&& system : m_systems)
+    {
+        output.systems.emplace_back(frame_benchmark_system{system.name, make_statistics(system.times)});
+    }
+
+    return output;
+}
+
+void frame_benchmark::record(std::string_view system, std::chrono::nanoseconds time)
+{
+    if(!measuring())
+    {
+        return;
+    }
+
+    auto it{std::find_if(std::begin(m_systems), std::end(m_systems), [system](const system_data& data)
+    {
+        return data.name == system;
+    })};
+
+    if(it == std::end(m_systems))
+    {
+        it = m_systems.insert(std::end(m_systems), system_data{std::string{system}, {}});
+        it->times.reserve(m_frame_count);
+    }
+
+    it->times.emplace_back(time);
+}
+
+static void write_statistics(std::ostream& stream, const frame_benchmark_statistics& statistics)
+{
+    stream << "{\"min\": " << statistics.minimum.count()
+           << ", \"mean\": " << statistics.mean.count()
+           << ", \"median\": " << statistics.median.count()
+           << ", \"p99\": " << statistics.p99.count()
+           << ", \"max\": " << statistics.maximum.count() << "}";
+}
+
+//JSON, all times are in nanoseconds
+std::ostream& operator<<(std::ostream& stream, const frame_benchmark_report& report)
+{
+    stream << "{\n";
+    stream << "  \"frame_count\": " << report.frame_count << ",\n";
+    stream << "  \"cpu_time\": ";
+    write_statistics(stream, report.cpu_time);
+    stream << ",\n  \"gpu_time\": ";
+    write_statistics(stream, report.gpu_time);
+    stream << ",\n  \"systems\": {";
+
+    for(std::size_t i{}; i < std::size(report.systems); ++i)
+    {
+        stream << (i == 0 ? "\n" : ",\n") << "    \"" << report.systems[i].name << "\": ";
+        write_statistics(stream, report.systems[i].time);
+    }
+
+    stream << "\n  },\n";
+    stream << "  \"allocations\": {\"host_shared\": " << report.allocation_count.host_shared
+           << ", \"device_local\": " << report.allocation_count.device_local
+           << ", \"device_shared\": " << report.allocation_count.device_shared
+           << ", \"delta\": " << report.allocation_delta << "},\n";
+    stream << "  \"frame_memory\": {\"allocations\": " << report.frame_allocation_count
+           << ", \"heap_allocations\": " << report.frame_heap_allocation_count << "}\n";
+    stream << "}\n";
+
+    return stream;
+}
+
+}
@@ -0,0 +1,140 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#ifndef CAPTAL_FRAME_BENCHMARK_HPP_INCLUDED
+#define CAPTAL_FRAME_BENCHMARK_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <ostream>
+
+#include <tephra/vulkan/memory.hpp>
+
+#include "render_target.hpp"
+
+namespace cpt
+{
+
+struct frame_benchmark_statistics
+{
+    std::chrono::nanoseconds minimum{};
+    std::chrono::nanoseconds mean{};
+    std::chrono::nanoseconds median{};
+    std::chrono::nanoseconds p99{};
+    std::chrono::nanoseconds maximum{};
+};
+
+struct frame_benchmark_system
+{
+    std::string name{};
+    frame_benchmark_statistics time{};
+};
+
+struct frame_benchmark_report
+{
+    std::uint32_t frame_count{};
+    frame_benchmark_statistics cpu_time{};
+    frame_benchmark_statistics gpu_time{};
+    std::vector<frame_benchmark_system> systems{};
+    tph::vulkan::memory_allocator::heap_sizes allocation_count{}; //Live GPU allocations at the end of the run
+    std::int64_t allocation_delta{}; //GPU allocations made (or freed if negative) during measured frames
+    std::uint64_t frame_allocation_count{}; //Transient allocations served by the main thread frame arena during measured frames
+    std::uint64_t frame_heap_allocation_count{}; //Heap allocations the frame arena had to make for them
+};
+
+//Measures a fixed number of frames, once the warmup frames are done.
+//Typical use:
+//  while(benchmark.next_frame())
+//  {
+//      benchmark.time("render", [&]{cpt::systems::render(world);});
+//      benchmark.time_gpu(*render_info);
+//  }
+class CAPTAL_API frame_benchmark
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+public:
+    explicit frame_benchmark(std::uint32_t frame_count, std::uint32_t warmup_frame_count = 0);
+
+    ~frame_benchmark() = default;
+    frame_benchmark(const frame_benchmark&) = delete;
+    frame_benchmark& operator=(const frame_benchmark&) = delete;
+    frame_benchmark(frame_benchmark&&) noexcept = delete;
+    frame_benchmark& operator=(frame_benchmark&&) noexcept = delete;
+
+    //Ends the current frame (if any) and begins the next one, returns false once all frames have been measured
+    bool next_frame();
+
+    template<typename Func>
+    void time(std::string_view system, Func&& func)
+    {
+        const auto begin{clock::now()};
+        std::forward<Func>(func)();
+        record(system, clock::now() - begin);
+    }
+
+    //The frame must have been began with cpt::begin_render_options::timed
+    void time_gpu(const frame_render_info& info);
+
+    //The render targets must have been waited, so all GPU times are available
+    frame_benchmark_report report() const;
+
+    bool measuring() const noexcept
+    {
+        return m_frame >= m_warmup_frame_count;
+    }
+
+private:
+    struct system_data
+    {
+        std::string name{};
+        std::vector<std::chrono::nanoseconds> times{};
+    };
+
+private:
+    void record(std::string_view system, std::chrono::nanoseconds time);
+
+private:
+    std::uint32_t m_frame_count{};
+    std::uint32_t m_warmup_frame_count{};
+    std::uint32_t m_frame{};
+    bool m_started{};
+    clock::time_point m_frame_begin{};
+    std::uint64_t m_begin_allocation_count{};
+    std::uint64_t m_frame_allocation_count{};
+    std::uint64_t m_frame_heap_allocation_count{};
+    std::vector<std::chrono::nanoseconds> m_cpu_times{};
+    std::vector<std::chrono::nanoseconds> m_gpu_times{};
+    std::vector<system_data> m_systems{};
+};
+
+CAPTAL_API std::ostream& operator<<(std::ostream& stream, const frame_benchmark_report& report);
+
+}
+
+#endif
@@ -0,0 +1,250 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "memory_statistics.hpp"
+
+#include <atomic>
+#include <utility>
+
+namespace cpt
+{
+
+struct memory_category_counters
+{
+    std::array<std::atomic<std::uint64_t>, 2> bytes{};
+    std::atomic<std::uint64_t> count{};
+    std::atomic<std::uint64_t> allocations{};
+    std::atomic<std::uint64_t> deallocations{};
+    std::atomic<std::uint64_t> allocated_bytes{};
+    std::atomic<std::uint64_t> last_allocations{};
+    std::atomic<std::uint64_t> last_deallocations{};
+    std::atomic<std::uint64_t> last_allocated_bytes{};
+};
+
+static std::array<memory_category_counters, memory_category_count> memory_counters{};
+static std::atomic<std::uint64_t> staging_memory{};
+static std::atomic<std::uint64_t> staging_high_water_mark{};
+
+static memory_category_counters& counters(memory_category category) noexcept
+{
+    return memory_counters[static_cast<std::size_t>(category)];
+}
+
+static void add_bytes(memory_category category, memory_location location, std::uint64_t size) noexcept
+{
+    counters(category).bytes[static_cast<std::size_t>(location)].fetch_add(size, std::memory_order_relaxed);
+
+    if(category == memory_category::staging)
+    {
+        const std::uint64_t current{staging_memory.fetch_add(size, std::memory_order_relaxed) + size};
+
+        std::uint64_t peak{staging_high_water_mark.load(std::memory_order_relaxed)};
+        while(peak < current && !staging_high_water_mark.compare_exchange_weak(peak, current, std::memory_order_relaxed));
+    }
+}
+
+static void remove_bytes(memory_category category, memory_location location, std::uint64_t size) noexcept
+{
+    counters(category).bytes[static_cast<std::size_t>(location)].fetch_sub(size, std::memory_order_relaxed);
+
+    if(category == memory_category::staging)
+    {
+        staging_memory.fetch_sub(size, std::memory_order_relaxed);
+    }
+}
+
+std::string_view memory_category_name(memory_category category) noexcept
+{
+    switch(category)
+    {
+        case memory_category::texture:       return "texture";
+        case memory_category::render_target: return "render_target";
+        case memory_category::font_atlas:    return "font_atlas";
+        case memory_category::uniform_pool:  return "uniform_pool";
+        case memory_category::staging:       return "staging";
+        default: return "unknown";
+    }
+}
+
+memory_tracking::memory_tracking(memory_category category, memory_location location, std::uint64_t size) noexcept
+:m_category{category}
+,m_location{location}
+,m_size{size}
+{
+    if(m_size > 0)
+    {
+        auto& category_counters{counters(m_category)};
+
+        category_counters.count.fetch_add(1, std::memory_order_relaxed);
+        category_counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        category_counters.allocated_bytes.fetch_add(m_size, std::memory_order_relaxed);
+
+        add_bytes(m_category, m_location, m_size);
+    }
+}
+
+memory_tracking::~memory_tracking()
+{
+    release();
+}
+
+memory_tracking::memory_tracking(memory_tracking&& other) noexcept
+:m_category{other.m_category}
+,m_location{other.m_location}
+,m_size{std::exchange(other.m_size, 0)}
+{
+
+}
+
+memory_tracking& memory_tracking::operator=(memory_tracking&& other) noexcept
+{
+    release();
+
+    m_category = other.m_category;
+    m_location = other.m_location;
+    m_size = std::exchange(other.m_size, 0);
+
+    return *this;
+}
+
+void memory_tracking::set_category(memory_category category) noexcept
+{
+    if(m_size > 0 && category != m_category)
+    {
+        counters(m_category).count.fetch_sub(1, std::memory_order_relaxed);
+        remove_bytes(m_category, m_location, m_size);
+
+        counters(category).count.fetch_add(1, std::memory_order_relaxed);
+        add_bytes(category, m_location, m_size);
+    }
+
+    m_category = category;
+}
+
+void memory_tracking::release() noexcept
+{
+    if(m_size > 0)
+    {
+        auto& category_counters{counters(m_category)};
+
+        category_counters.count.fetch_sub(1, std::memory_order_relaxed);
+        category_counters.deallocations.fetch_add(1, std::memory_order_relaxed);
+
+        remove_bytes(m_category, m_location, m_size);
+
+        m_size = 0;
+    }
+}
+
+memory_heap_statistics make_memory_heap_statistics(std::uint64_t heap_count, std::uint64_t allocation_count, std::uint64_t allocated, std::uint64_t used, std::uint64_t largest_free_block) noexcept
+{
+    memory_heap_statistics output{heap_count, allocation_count, allocated, used, largest_free_block};
+
+    if(allocated > used)
+    {
+        output.fragmentation = 1.0f - static_cast<float>(largest_free_block) / static_cast<float>(allocated - used);
+    }
+
+    return output;
+}
+
+memory_statistics tracked_memory_statistics() noexcept
+{
+    memory_statistics output{};
+
+    for(std::size_t i{}; i < memory_category_count; ++i)
+    {
+        const auto& category_counters{memory_counters[i]};
+        auto& category{output.categories[i]};
+
+        category.device_bytes    = category_counters.bytes[static_cast<std::size_t>(memory_location::device)].load(std::memory_order_relaxed);
+        category.host_bytes      = category_counters.bytes[static_cast<std::size_t>(memory_location::host)].load(std::memory_order_relaxed);
+        category.count           = category_counters.count.load(std::memory_order_relaxed);
+        category.allocations     = category_counters.last_allocations.load(std::memory_order_relaxed);
+        category.deallocations   = category_counters.last_deallocations.load(std::memory_order_relaxed);
+        category.allocated_bytes = category_counters.last_allocated_bytes.load(std::memory_order_relaxed);
+    }
+
+    output.staging_high_water_mark = staging_high_water_mark.load(std::memory_order_relaxed);
+
+    return output;
+}
+
+void end_memory_frame() noexcept
+{
+    for(auto& category_counters : memory_counters)
+    {
+        category_counters.last_allocations.store(category_counters.allocations.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        category_counters.last_deallocations.store(category_counters.deallocations.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        category_counters.last_allocated_bytes.store(category_counters.allocated_bytes.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+static void write_heap(std::ostream& stream, const memory_heap_statistics& heap)
+{
+    stream << "{\"heaps\": " << heap.heap_count
+           << ", \"allocations\": " << heap.allocation_count
+           << ", \"allocated\": " << heap.allocated
+           << ", \"used\": " << heap.used
+           << ", \"largest_free_block\": " << heap.largest_free_block
+           << ", \"fragmentation\": " << heap.fragmentation << "}";
+}
+
+std::ostream& operator<<(std::ostream& stream, const memory_statistics& statistics)
+{
+    stream << "{\n";
+    stream << "  \"frame\": " << statistics.frame << ",\n";
+    stream << "  \"categories\": {";
+
+    for(std::size_t i{}; i < memory_category_count; ++i)
+    {
+        const auto& category{statistics.categories[i]};
+
+        stream << (i == 0 ? "\n" : ",\n") << "    \"" << memory_category_name(static_cast<memory_category>(i)) << "\": "
+               << "{\"device\": " << category.device_bytes
+               << ", \"host\": " << category.host_bytes
+               << ", \"count\": " << category.count
+               << ", \"allocations\": " << category.allocations
+               << ", \"deallocations\": " << category.deallocations
+               << ", \"allocated_bytes\": " << category.allocated_bytes << "}";
+    }
+
+    stream << "\n  },\n";
+    stream << "  \"heaps\": {\n    \"device_local\": ";
+    write_heap(stream, statistics.device_local);
+    stream << ",\n    \"device_shared\": ";
+    write_heap(stream, statistics.device_shared);
+    stream << ",\n    \"host_shared\": ";
+    write_heap(stream, statistics.host_shared);
+    stream << ",\n    \"uniform_pool\": ";
+    write_heap(stream, statistics.uniform_pool);
+    stream << "\n  },\n";
+    stream << "  \"staging_high_water_mark\": " << statistics.staging_high_water_mark << ",\n";
+    stream << "  \"frame_memory\": {\"allocations\": " << statistics.frame_memory.allocation_count
+           << ", \"heap_allocations\": " << statistics.frame_memory.heap_allocation_count
+           << ", \"peak_size\": " << statistics.frame_memory.peak_size << "}\n";
+    stream << "}\n";
+
+    return stream;
+}
+
+}
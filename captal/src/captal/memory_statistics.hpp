@@ -0,0 +1,144 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_MEMORY_STATISTICS_HPP_INCLUDED
+#define CAPTAL_MEMORY_STATISTICS_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <array>
+#include <ostream>
+#include <string_view>
+
+#include <captal_foundation/frame_allocator.hpp>
+
+namespace cpt
+{
+
+enum class memory_category : std::uint32_t
+{
+    texture = 0,
+    render_target = 1,
+    font_atlas = 2,
+    uniform_pool = 3,
+    staging = 4,
+};
+
+inline constexpr std::size_t memory_category_count{5};
+
+enum class memory_location : std::uint32_t
+{
+    device = 0, //Device local memory
+    host = 1    //Host visible memory
+};
+
+CAPTAL_API std::string_view memory_category_name(memory_category category) noexcept;
+
+//Accounts a GPU allocation in the memory statistics until destruction
+class CAPTAL_API memory_tracking
+{
+public:
+    constexpr memory_tracking() = default;
+    explicit memory_tracking(memory_category category, memory_location location, std::uint64_t size) noexcept;
+    ~memory_tracking();
+    memory_tracking(const memory_tracking&) = delete;
+    memory_tracking& operator=(const memory_tracking&) = delete;
+    memory_tracking(memory_tracking&& other) noexcept;
+    memory_tracking& operator=(memory_tracking&& other) noexcept;
+
+    //Moves the allocation to another category, it does not count as an allocation
+    void set_category(memory_category category) noexcept;
+
+    memory_category category() const noexcept
+    {
+        return m_category;
+    }
+
+    memory_location location() const noexcept
+    {
+        return m_location;
+    }
+
+    std::uint64_t size() const noexcept
+    {
+        return m_size;
+    }
+
+private:
+    void release() noexcept;
+
+private:
+    memory_category m_category{};
+    memory_location m_location{};
+    std::uint64_t m_size{};
+};
+
+struct memory_category_statistics
+{
+    std::uint64_t device_bytes{}; //Live bytes in device local memory
+    std::uint64_t host_bytes{}; //Live bytes in host visible memory
+    std::uint64_t count{}; //Live allocations
+    std::uint64_t allocations{}; //Allocations made during the last frame
+    std::uint64_t deallocations{}; //Allocations freed during the last frame
+    std::uint64_t allocated_bytes{}; //Bytes allocated during the last frame
+};
+
+struct memory_heap_statistics
+{
+    std::uint64_t heap_count{};
+    std::uint64_t allocation_count{};
+    std::uint64_t allocated{}; //Memory owned by the heaps
+    std::uint64_t used{}; //Memory bound to live allocations
+    std::uint64_t largest_free_block{}; //Largest free block among all heaps, the biggest allocation that fits without a new heap
+    float fragmentation{}; //1 - largest_free_block / free space, 0 if all free space is in one contiguous block
+};
+
+CAPTAL_API memory_heap_statistics make_memory_heap_statistics(std::uint64_t heap_count, std::uint64_t allocation_count, std::uint64_t allocated, std::uint64_t used, std::uint64_t largest_free_block) noexcept;
+
+struct memory_statistics
+{
+    std::uint64_t frame{};
+    std::array<memory_category_statistics, memory_category_count> categories{};
+    memory_heap_statistics device_local{};
+    memory_heap_statistics device_shared{};
+    memory_heap_statistics host_shared{};
+    memory_heap_statistics uniform_pool{}; //Sub-allocations of cpt::buffer_pool
+    std::uint64_t staging_high_water_mark{}; //Highest amount of live staging memory since the start of the program
+    frame_memory_resource::statistics frame_memory{}; //Frame arena usage of the main thread during the last frame
+
+    const memory_category_statistics& operator[](memory_category category) const noexcept
+    {
+        return categories[static_cast<std::size_t>(category)];
+    }
+};
+
+//Live values of the tracked allocations, and the allocations counters of the last ended frame
+CAPTAL_API memory_statistics tracked_memory_statistics() noexcept;
+//Ends the current frame of the allocations counters, called by cpt::engine
+CAPTAL_API void end_memory_frame() noexcept;
+
+//JSON, all sizes are in bytes
+CAPTAL_API std::ostream& operator<<(std::ostream& stream, const memory_statistics& statistics);
+
+}
+
+#endif
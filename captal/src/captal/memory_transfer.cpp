@@ -26,6 +26,8 @@
 
 #include <sstream>
 
+#include <captal_foundation/profiler.hpp>
+
 namespace cpt
 {
 
@@ -37,13 +39,93 @@ static std::string thread_name(std::thread::id thread)
     return ss.str();
 }
 
+queue_ownership_transfer::queue_ownership_transfer(std::uint32_t source_family, std::uint32_t destination_family) noexcept
+:m_source_family{source_family}
+,m_destination_family{destination_family}
+{
+
+}
+
+void queue_ownership_transfer::release(tph::command_buffer& buffer, tph::pipeline_stage destination_stage, tph::buffer_memory_barrier barrier)
+{
+    if(is_same_family())
+    {
+        tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, destination_stage, tph::dependency_flags::none, {}, std::span{&barrier, 1}, {});
+
+        return;
+    }
+
+    barrier.source_queue_family = m_source_family;
+    barrier.destination_queue_family = m_destination_family;
+
+    const auto destination_access{std::exchange(barrier.destination_access, tph::resource_access::none)};
+    tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::bottom_of_pipe, tph::dependency_flags::none, {}, std::span{&barrier, 1}, {});
+
+    barrier.source_access = tph::resource_access::none;
+    barrier.destination_access = destination_access;
+
+    m_buffers.emplace_back(barrier);
+    m_stages |= destination_stage;
+}
+
+void queue_ownership_transfer::release(tph::command_buffer& buffer, tph::pipeline_stage destination_stage, tph::texture_memory_barrier barrier)
+{
+    if(is_same_family())
+    {
+        tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, destination_stage, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+
+        return;
+    }
+
+    barrier.source_queue_family = m_source_family;
+    barrier.destination_queue_family = m_destination_family;
+
+    //The layout transition is executed once, the acquire barrier must specify the same layouts as the release one.
+    const auto destination_access{std::exchange(barrier.destination_access, tph::resource_access::none)};
+    tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::bottom_of_pipe, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+
+    barrier.source_access = tph::resource_access::none;
+    barrier.destination_access = destination_access;
+
+    m_textures.emplace_back(barrier);
+    m_stages |= destination_stage;
+}
+
+void queue_ownership_transfer::acquire(tph::command_buffer& buffer)
+{
+    if(!empty())
+    {
+        tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::all_commands, m_stages, tph::dependency_flags::none, {}, m_buffers, m_textures);
+    }
+
+    clear();
+}
+
+void queue_ownership_transfer::clear() noexcept
+{
+    m_buffers.clear();
+    m_textures.clear();
+    m_stages = tph::pipeline_stage::none;
+}
+
 memory_transfer_scheduler::memory_transfer_scheduler(tph::renderer& renderer) noexcept
 :m_renderer{&renderer}
 ,m_pool{renderer, tph::command_pool_options::reset | tph::command_pool_options::transient}
+,m_standalone{!renderer.is_same_queue(tph::queue::transfer, tph::queue::graphics)}
 {
+    if(m_standalone)
+    {
+        m_transfer_pool = tph::command_pool{renderer, tph::queue::transfer, tph::command_pool_options::reset | tph::command_pool_options::transient};
+    }
+
     if(debug_enabled)
     {
         tph::set_object_name(*m_renderer, m_pool, "cpt::engine's primary transfer command pool");
+
+        if(m_standalone)
+        {
+            tph::set_object_name(*m_renderer, m_transfer_pool, "cpt::engine's primary standalone transfer command pool");
+        }
     }
 
     m_thread_pools.reserve(4);
@@ -52,18 +134,7 @@ memory_transfer_scheduler::memory_transfer_scheduler(tph::renderer& renderer) no
     //Main thread pool
     const auto thread{std::this_thread::get_id()};
 
-    thread_transfer_pool main_pool{};
-    main_pool.pool = tph::command_pool{*m_renderer, tph::command_pool_options::reset | tph::command_pool_options::transient};
-    main_pool.buffers.reserve(4);
-
-    if(debug_enabled)
-    {
-        const auto name{thread_name(thread)};
-
-        tph::set_object_name(*m_renderer, main_pool.pool, "cpt::engine's thread transfer pool (thread: " + name + ")");
-    }
-
-    m_thread_pools.emplace(thread, std::move(main_pool));
+    m_thread_pools.emplace(thread, make_transfer_pool(thread));
 }
 
 memory_transfer_scheduler::~memory_transfer_scheduler()
@@ -71,25 +142,27 @@ memory_transfer_scheduler::~memory_transfer_scheduler()
 
 }
 
-memory_transfer_info memory_transfer_scheduler::begin_transfer()
+memory_transfer_info memory_transfer_scheduler::begin_transfer(transfer_queue queue)
 {
-    return begin_transfer(std::this_thread::get_id());
+    return begin_transfer(std::this_thread::get_id(), queue);
 }
 
-memory_transfer_info memory_transfer_scheduler::begin_transfer(std::thread::id thread)
+memory_transfer_info memory_transfer_scheduler::begin_transfer(std::thread::id thread, transfer_queue queue)
 {
     std::unique_lock lock{m_mutex};
 
     auto& pool  {get_transfer_pool(thread)};
-    auto& buffer{next_thread_buffer(pool, thread)};
+    auto& buffer{next_thread_buffer(pool, thread, queue)};
 
     m_begin = true;
 
-    return memory_transfer_info{buffer.buffer, buffer.signal, buffer.keeper};
+    return memory_transfer_info{buffer.buffer, buffer.signal, buffer.keeper, buffer.ownership};
 }
 
 void memory_transfer_scheduler::submit_transfers()
 {
+    CAPTAL_PROFILE_SCOPE("cpt::memory_transfer_scheduler::submit_transfers");
+
     std::unique_lock lock{m_mutex};
 
     if(!m_begin)
@@ -100,11 +173,52 @@ void memory_transfer_scheduler::submit_transfers()
     m_begin = false;
 
     auto& buffer{next_buffer()};
-    const auto index{buffer_index(buffer)};
-    const auto to_execute{secondary_buffers(index)};
+    const auto index    {buffer_index(buffer)};
+    const auto transfers{secondary_buffers(index, transfer_queue::transfer)};
+    const auto graphics {secondary_buffers(index, transfer_queue::graphics)};
+
+    const bool standalone_transfers{m_standalone && !std::empty(transfers)};
+
+    if(m_standalone)
+    {
+        //Always end the buffer, so it can be begun again on reset even if nothing has been recorded
+        if(standalone_transfers)
+        {
+            tph::cmd::execute(buffer.transfer_buffer, transfers);
+        }
+
+        tph::cmd::end(buffer.transfer_buffer);
+    }
+
+    if(standalone_transfers)
+    {
+        //Standalone transfers only touch resources that are not in use by the graphics queue (fresh textures, free staging chunks)
+        //so they do not have to wait for previous graphics work, and run concurrently with it.
+        tph::submit_info info{};
+        info.command_buffers.emplace_back(buffer.transfer_buffer);
+        info.signal_semaphores.emplace_back(buffer.semaphore);
+
+        tph::submit(*m_renderer, tph::queue::transfer, info, tph::nullref);
+    }
 
     tph::cmd::pipeline_barrier(buffer.buffer, tph::pipeline_stage::bottom_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none);
-    tph::cmd::execute(buffer.buffer, to_execute);
+
+    if(standalone_transfers)
+    {
+        acquire_ownerships(index, buffer.buffer);
+    }
+    else if(!std::empty(transfers))
+    {
+        tph::cmd::execute(buffer.buffer, transfers);
+        tph::cmd::pipeline_barrier(buffer.buffer, tph::resource_access::transfer_write, tph::resource_access::transfer_read, tph::dependency_flags::none,
+                                                  tph::pipeline_stage::transfer, tph::pipeline_stage::transfer);
+    }
+
+    if(!std::empty(graphics))
+    {
+        tph::cmd::execute(buffer.buffer, graphics);
+    }
+
     tph::cmd::end(buffer.buffer);
 
     buffer.fence.reset();
@@ -112,6 +226,12 @@ void memory_transfer_scheduler::submit_transfers()
     tph::submit_info info{};
     info.command_buffers.emplace_back(buffer.buffer);
 
+    if(standalone_transfers)
+    {
+        info.wait_semaphores.emplace_back(buffer.semaphore);
+        info.wait_stages.emplace_back(tph::pipeline_stage::all_commands);
+    }
+
     std::unique_lock queue_lock{engine::instance().submit_mutex()};
     tph::submit(*m_renderer, info, buffer.fence);
     queue_lock.unlock();
@@ -138,10 +258,22 @@ memory_transfer_scheduler::transfer_buffer& memory_transfer_scheduler::add_buffe
     data.buffer = tph::cmd::begin(m_pool, tph::command_buffer_level::primary, tph::command_buffer_options::one_time_submit);
     data.fence  = tph::fence{*m_renderer, true};
 
+    if(m_standalone)
+    {
+        data.transfer_buffer = tph::cmd::begin(m_transfer_pool, tph::command_buffer_level::primary, tph::command_buffer_options::one_time_submit);
+        data.semaphore = tph::semaphore{*m_renderer};
+    }
+
     if constexpr(debug_enabled)
     {
         tph::set_object_name(*m_renderer, data.buffer, "cpt::engine's primary transfer buffer #" + std::to_string(std::size(m_buffers)));
         tph::set_object_name(*m_renderer, data.fence, "cpt::engine's transfer fence #" + std::to_string(std::size(m_buffers)));
+
+        if(m_standalone)
+        {
+            tph::set_object_name(*m_renderer, data.transfer_buffer, "cpt::engine's primary standalone transfer buffer #" + std::to_string(std::size(m_buffers)));
+            tph::set_object_name(*m_renderer, data.semaphore, "cpt::engine's standalone transfer semaphore #" + std::to_string(std::size(m_buffers)));
+        }
     }
 
     return m_buffers.emplace_back(std::move(data));
@@ -168,6 +300,11 @@ void memory_transfer_scheduler::reset_buffer(transfer_buffer& buffer)
     }
 
     tph::cmd::begin(buffer.buffer, tph::command_buffer_reset_options::none, tph::command_buffer_options::one_time_submit);
+
+    if(m_standalone)
+    {
+        tph::cmd::begin(buffer.transfer_buffer, tph::command_buffer_reset_options::none, tph::command_buffer_options::one_time_submit);
+    }
 }
 
 void memory_transfer_scheduler::reset_thread_buffer(thread_transfer_buffer& data)
@@ -175,19 +312,20 @@ void memory_transfer_scheduler::reset_thread_buffer(thread_transfer_buffer& data
     data.signal();
     data.signal.disconnect_all();
     data.keeper.clear();
+    data.ownership.clear();
     data.parent = no_parent;
 }
 
-std::vector<std::reference_wrapper<tph::command_buffer>> memory_transfer_scheduler::secondary_buffers(std::size_t parent)
+frame_vector<std::reference_wrapper<tph::command_buffer>> memory_transfer_scheduler::secondary_buffers(std::size_t parent, transfer_queue queue)
 {
-    std::vector<std::reference_wrapper<tph::command_buffer>> output{};
+    auto output{make_frame_vector<std::reference_wrapper<tph::command_buffer>>()};
     output.reserve(std::size(m_thread_pools));
 
     for(auto&& pool : m_thread_pools)
     {
         for(auto&& thread_buffer : pool.second.buffers)
         {
-            if(thread_buffer.begin)
+            if(thread_buffer.begin && thread_buffer.queue == queue)
             {
                 if constexpr(debug_enabled)
                 {
@@ -207,6 +345,20 @@ std::vector<std::reference_wrapper<tph::command_buffer>> memory_transfer_schedul
     return output;
 }
 
+void memory_transfer_scheduler::acquire_ownerships(std::size_t parent, tph::command_buffer& buffer)
+{
+    for(auto&& pool : m_thread_pools)
+    {
+        for(auto&& thread_buffer : pool.second.buffers)
+        {
+            if(thread_buffer.parent == parent && thread_buffer.queue == transfer_queue::transfer)
+            {
+                thread_buffer.ownership.acquire(buffer);
+            }
+        }
+    }
+}
+
 std::size_t memory_transfer_scheduler::clean_threads()
 {
     return std::erase_if(m_thread_pools, [](const auto& item)
@@ -225,24 +377,42 @@ std::size_t memory_transfer_scheduler::clean_threads()
     });
 }
 
+memory_transfer_scheduler::thread_transfer_pool memory_transfer_scheduler::make_transfer_pool(std::thread::id thread)
+{
+    thread_transfer_pool pool{};
+    pool.pool = tph::command_pool{*m_renderer, tph::command_pool_options::reset | tph::command_pool_options::transient};
+
+    if(m_standalone)
+    {
+        pool.transfer_pool = tph::command_pool{*m_renderer, tph::queue::transfer, tph::command_pool_options::reset | tph::command_pool_options::transient};
+    }
+
+    pool.buffers.reserve(4);
+
+    if(debug_enabled)
+    {
+        const auto name{thread_name(thread)};
+
+        tph::set_object_name(*m_renderer, pool.pool, "cpt::engine's thread transfer pool (thread: " + name + ")");
+
+        if(m_standalone)
+        {
+            tph::set_object_name(*m_renderer, pool.transfer_pool, "cpt::engine's thread standalone transfer pool (thread: " + name + ")");
+        }
+    }
+
+    return pool;
+}
+
 memory_transfer_scheduler::thread_transfer_pool& memory_transfer_scheduler::get_transfer_pool(std::thread::id thread)
 {
     auto it{m_thread_pools.find(thread)};
     if(it == std::end(m_thread_pools))
     {
-        thread_transfer_pool pool{};
-        pool.pool = tph::command_pool{*m_renderer, tph::command_pool_options::reset | tph::command_pool_options::transient};
+        thread_transfer_pool pool{make_transfer_pool(thread)};
         pool.exit_promise = std::promise<void>{};
         pool.exit_promise.set_value_at_thread_exit();
         pool.exit_future = pool.exit_promise.get_future();
-        pool.buffers.reserve(4);
-
-        if(debug_enabled)
-        {
-            const auto name{thread_name(thread)};
-
-            tph::set_object_name(*m_renderer, pool.pool, "cpt::engine's thread transfer pool (thread: " + name + ")");
-        }
 
         it = m_thread_pools.emplace(thread, std::move(pool)).first;
     }
@@ -250,11 +420,11 @@ memory_transfer_scheduler::thread_transfer_pool& memory_transfer_scheduler::get_
     return it->second;
 }
 
-memory_transfer_scheduler::thread_transfer_buffer& memory_transfer_scheduler::next_thread_buffer(thread_transfer_pool& pool, std::thread::id thread)
+memory_transfer_scheduler::thread_transfer_buffer& memory_transfer_scheduler::next_thread_buffer(thread_transfer_pool& pool, std::thread::id thread, transfer_queue queue)
 {
     for(auto& buffer : pool.buffers)
     {
-        if(buffer.begin == true)
+        if(buffer.begin == true && buffer.queue == queue)
         {
             return buffer;
         }
@@ -262,7 +432,7 @@ memory_transfer_scheduler::thread_transfer_buffer& memory_transfer_scheduler::ne
 
     for(auto& buffer : pool.buffers)
     {
-        if(buffer.parent == no_parent)
+        if(buffer.parent == no_parent && !buffer.begin && buffer.queue == queue)
         {
             tph::cmd::begin(buffer.buffer, tph::command_buffer_reset_options::none, tph::command_buffer_options::one_time_submit);
 
@@ -279,14 +449,26 @@ memory_transfer_scheduler::thread_transfer_buffer& memory_transfer_scheduler::ne
         }
     }
 
-    return add_thread_buffer(pool, thread);
+    return add_thread_buffer(pool, thread, queue);
 }
 
-memory_transfer_scheduler::thread_transfer_buffer& memory_transfer_scheduler::add_thread_buffer(thread_transfer_pool& pool, std::thread::id thread)
+memory_transfer_scheduler::thread_transfer_buffer& memory_transfer_scheduler::add_thread_buffer(thread_transfer_pool& pool, std::thread::id thread, transfer_queue queue)
 {
+    const bool standalone{m_standalone && queue == transfer_queue::transfer};
+
     thread_transfer_buffer data{};
-    data.buffer = tph::cmd::begin(pool.pool, tph::command_buffer_level::secondary, tph::command_buffer_options::one_time_submit);
+    data.buffer = tph::cmd::begin(standalone ? pool.transfer_pool : pool.pool, tph::command_buffer_level::secondary, tph::command_buffer_options::one_time_submit);
     data.keeper.reserve(512);
+    data.queue = queue;
+
+    if(standalone)
+    {
+        data.ownership = queue_ownership_transfer{m_renderer->queue_family(tph::queue::transfer), m_renderer->queue_family(tph::queue::graphics)};
+    }
+    else
+    {
+        data.ownership = queue_ownership_transfer{m_renderer->queue_family(tph::queue::graphics), m_renderer->queue_family(tph::queue::graphics)};
+    }
 
     if constexpr(debug_enabled)
     {
@@ -28,6 +28,8 @@
 #include <unordered_map>
 #include <future>
 
+#include <captal_foundation/frame_allocator.hpp>
+
 #include <tephra/renderer.hpp>
 #include <tephra/commands.hpp>
 #include <tephra/synchronization.hpp>
@@ -40,11 +42,60 @@ namespace cpt
 
 using transfer_ended_signal = cpt::signal<>;
 
+enum class transfer_queue : std::uint32_t
+{
+    graphics = 0, //Recorded transfers are executed on the graphics queue, they are visible to any later submission on the graphics queue.
+    transfer = 1  //Recorded transfers are executed on the standalone transfer queue (if any), before the graphics queue transfers of the same batch.
+};
+
+//Records the last barrier of a transfer.
+//If the transfer and the destination are on the same queue family, it is a simple pipeline barrier.
+//Otherwise it records a queue family ownership release, the scheduler records the matching acquire operation on the graphics queue.
+class CAPTAL_API queue_ownership_transfer
+{
+public:
+    queue_ownership_transfer() = default;
+    explicit queue_ownership_transfer(std::uint32_t source_family, std::uint32_t destination_family) noexcept;
+    ~queue_ownership_transfer() = default;
+    queue_ownership_transfer(const queue_ownership_transfer&) = delete;
+    queue_ownership_transfer& operator=(const queue_ownership_transfer&) = delete;
+    queue_ownership_transfer(queue_ownership_transfer&& other) noexcept = default;
+    queue_ownership_transfer& operator=(queue_ownership_transfer&& other) noexcept = default;
+
+    void release(tph::command_buffer& buffer, tph::pipeline_stage destination_stage, tph::buffer_memory_barrier barrier);
+    void release(tph::command_buffer& buffer, tph::pipeline_stage destination_stage, tph::texture_memory_barrier barrier);
+    void acquire(tph::command_buffer& buffer);
+    void clear() noexcept;
+
+    bool empty() const noexcept
+    {
+        return std::empty(m_buffers) && std::empty(m_textures);
+    }
+
+    bool is_same_family() const noexcept
+    {
+        return m_source_family == m_destination_family;
+    }
+
+    tph::pipeline_stage stages() const noexcept
+    {
+        return m_stages;
+    }
+
+private:
+    std::uint32_t m_source_family{};
+    std::uint32_t m_destination_family{};
+    tph::pipeline_stage m_stages{};
+    std::vector<tph::buffer_memory_barrier> m_buffers{};
+    std::vector<tph::texture_memory_barrier> m_textures{};
+};
+
 struct memory_transfer_info
 {
     tph::command_buffer& buffer;
     transfer_ended_signal& signal;
     asynchronous_resource_keeper& keeper;
+    queue_ownership_transfer& ownership;
 };
 
 class CAPTAL_API memory_transfer_scheduler
@@ -59,17 +110,24 @@ public:
     memory_transfer_scheduler(memory_transfer_scheduler&& other) noexcept = delete;
     memory_transfer_scheduler& operator=(memory_transfer_scheduler&& other) noexcept = delete;
 
-    memory_transfer_info begin_transfer();
-    memory_transfer_info begin_transfer(std::thread::id thread);
+    memory_transfer_info begin_transfer(transfer_queue queue = transfer_queue::graphics);
+    memory_transfer_info begin_transfer(std::thread::id thread, transfer_queue queue = transfer_queue::graphics);
     void submit_transfers();
     std::size_t clean_threads();
 
+    bool has_standalone_queue() const noexcept
+    {
+        return m_standalone;
+    }
+
 private:
     struct thread_transfer_buffer
     {
         tph::command_buffer buffer{};
         transfer_ended_signal signal{};
         asynchronous_resource_keeper keeper{};
+        queue_ownership_transfer ownership{};
+        transfer_queue queue{};
         std::size_t parent{no_parent};
         bool begin{};
     };
@@ -77,6 +135,7 @@ private:
     struct thread_transfer_pool
     {
         tph::command_pool pool{};
+        tph::command_pool transfer_pool{};
         std::promise<void> exit_promise{};
         std::future<void> exit_future{};
         std::vector<thread_transfer_buffer> buffers{};
@@ -85,6 +144,8 @@ private:
     struct transfer_buffer
     {
         tph::command_buffer buffer{};
+        tph::command_buffer transfer_buffer{}; //only used with a standalone transfer queue
+        tph::semaphore semaphore{}; //only used with a standalone transfer queue
         tph::fence fence{};
     };
 
@@ -94,18 +155,22 @@ private:
     std::size_t buffer_index(const transfer_buffer& buffer) const noexcept;
     void reset_buffer(transfer_buffer& buffer);
     void reset_thread_buffer(thread_transfer_buffer& data);
-    std::vector<std::reference_wrapper<tph::command_buffer>> secondary_buffers(std::size_t parent);
+    frame_vector<std::reference_wrapper<tph::command_buffer>> secondary_buffers(std::size_t parent, transfer_queue queue);
+    void acquire_ownerships(std::size_t parent, tph::command_buffer& buffer);
 
+    thread_transfer_pool make_transfer_pool(std::thread::id thread);
     thread_transfer_pool& get_transfer_pool(std::thread::id thread);
-    thread_transfer_buffer& next_thread_buffer(thread_transfer_pool& pool, std::thread::id thread);
-    thread_transfer_buffer& add_thread_buffer(thread_transfer_pool& pool, std::thread::id thread);
+    thread_transfer_buffer& next_thread_buffer(thread_transfer_pool& pool, std::thread::id thread, transfer_queue queue);
+    thread_transfer_buffer& add_thread_buffer(thread_transfer_pool& pool, std::thread::id thread, transfer_queue queue);
 
 private:
     tph::renderer* m_renderer{};
     std::unordered_map<std::thread::id, thread_transfer_pool> m_thread_pools{};
     tph::command_pool m_pool{};
+    tph::command_pool m_transfer_pool{};
     std::vector<transfer_buffer> m_buffers{};
     std::mutex m_mutex{};
+    bool m_standalone{};
     bool m_begin{};
 };
 
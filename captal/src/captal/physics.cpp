@@ -23,10 +23,14 @@
 #include "physics.hpp"
 
 #include <stdexcept>
+#include <cstring>
+#include <algorithm>
 
 #include <captal_foundation/stack_allocator.hpp>
+#include <captal_foundation/profiler.hpp>
 
 #include <chipmunk/chipmunk.h>
+#include <chipmunk/chipmunk_structs.h>
 
 namespace cpt
 {
@@ -51,6 +55,57 @@ static inline float fromcp(cpFloat value) noexcept
     return static_cast<float>(value);
 }
 
+//Bodies and shapes are initialized in pooled memory instead of being allocated by Chipmunk
+static constexpr std::size_t shape_size {std::max({sizeof(cpCircleShape), sizeof(cpSegmentShape), sizeof(cpPolyShape)})};
+static constexpr std::size_t shape_align{std::max({alignof(cpCircleShape), alignof(cpSegmentShape), alignof(cpPolyShape)})};
+
+static slab_pool& body_pool()
+{
+    static slab_pool pool{sizeof(cpBody), alignof(cpBody), slab_pool::default_slab_block_count, 32};
+
+    return pool;
+}
+
+static slab_pool& shape_pool()
+{
+    static slab_pool pool{shape_size, shape_align, slab_pool::default_slab_block_count, 32};
+
+    return pool;
+}
+
+static cpBody* allocate_body()
+{
+    return static_cast<cpBody*>(std::memset(body_pool().allocate(sizeof(cpBody), alignof(cpBody)), 0, sizeof(cpBody)));
+}
+
+static void free_body(cpBody* body) noexcept
+{
+    cpBodyDestroy(body);
+    body_pool().deallocate(body, sizeof(cpBody), alignof(cpBody));
+}
+
+template<typename T>
+static T* allocate_shape()
+{
+    return static_cast<T*>(std::memset(shape_pool().allocate(shape_size, shape_align), 0, shape_size));
+}
+
+static void free_shape(cpShape* shape) noexcept
+{
+    cpShapeDestroy(shape);
+    shape_pool().deallocate(shape, shape_size, shape_align);
+}
+
+slab_pool::statistics physical_body_pool_statistics()
+{
+    return body_pool().stats();
+}
+
+slab_pool::statistics physical_shape_pool_statistics()
+{
+    return shape_pool().stats();
+}
+
 void physical_collision_arbiter::set_restitution(float restitution) noexcept
 {
     cpArbiterSetRestitution(m_arbiter, tocp(restitution));
@@ -284,6 +339,8 @@ std::optional<physical_world::ray_hit> physical_world::ray_query_first(vec2f fro
 
 void physical_world::update(float time)
 {
+    CAPTAL_PROFILE_SCOPE("cpt::physical_world::update");
+
     m_time += time;
     const std::uint32_t steps{std::min(static_cast<std::uint32_t>(m_time / m_step), m_max_steps)};
 
@@ -486,23 +543,17 @@ void physical_world::add_callback(cpCollisionHandler *cphandler, collision_handl
 }
 
 physical_shape::physical_shape(physical_body& body, float radius, vec2f offset)
-:m_shape{cpCircleShapeNew(body.handle(), tocp(radius), tocp(offset))}
+:m_shape{&cpCircleShapeInit(allocate_shape<cpCircleShape>(), body.handle(), tocp(radius), tocp(offset))->shape}
 ,m_active{true}
 {
-    if(!m_shape)
-        throw std::runtime_error{"Can not allocate physical shape."};
-
     cpSpaceAddShape(cpBodyGetSpace(body.handle()), m_shape);
     cpShapeSetUserData(m_shape, this);
 }
 
 physical_shape::physical_shape(physical_body& body, vec2f first, vec2f second, float thickness)
-:m_shape{cpSegmentShapeNew(body.handle(), tocp(first), tocp(second), tocp(thickness))}
+:m_shape{&cpSegmentShapeInit(allocate_shape<cpSegmentShape>(), body.handle(), tocp(first), tocp(second), tocp(thickness))->shape}
 ,m_active{true}
 {
-    if(!m_shape)
-        throw std::runtime_error{"Can not allocate physical shape."};
-
     cpSpaceAddShape(cpBodyGetSpace(body.handle()), m_shape);
     cpShapeSetUserData(m_shape, this);
 }
@@ -519,21 +570,16 @@ physical_shape::physical_shape(physical_body& body, std::span<const vec2f> point
         native_vertices.emplace_back(tocp(vertex));
     }
 
-    m_shape = cpPolyShapeNew(body.handle(), static_cast<int>(std::size(points)), std::data(native_vertices), cpTransformIdentity, tocp(radius));
-    if(!m_shape)
-        throw std::runtime_error{"Can not allocate physical shape."};
+    m_shape = &cpPolyShapeInit(allocate_shape<cpPolyShape>(), body.handle(), static_cast<int>(std::size(points)), std::data(native_vertices), cpTransformIdentity, tocp(radius))->shape;
 
     cpSpaceAddShape(cpBodyGetSpace(body.handle()), m_shape);
     cpShapeSetUserData(m_shape, this);
 }
 
 physical_shape::physical_shape(physical_body& body, float width, float height, float radius)
-:m_shape{cpBoxShapeNew(body.handle(), tocp(width), tocp(height), tocp(radius))}
+:m_shape{&cpBoxShapeInit(allocate_shape<cpPolyShape>(), body.handle(), tocp(width), tocp(height), tocp(radius))->shape}
 ,m_active{true}
 {
-    if(!m_shape)
-        throw std::runtime_error{"Can not allocate physical shape."};
-
     cpSpaceAddShape(cpBodyGetSpace(body.handle()), m_shape);
     cpShapeSetUserData(m_shape, this);
 }
@@ -543,7 +589,7 @@ physical_shape::~physical_shape()
     if(m_shape)
     {
         deactivate();
-        cpShapeFree(m_shape);
+        free_shape(m_shape);
     }
 }
 
@@ -687,15 +733,17 @@ physical_body::physical_body(physical_world& world, physical_body_type type, flo
 {
     if(type == physical_body_type::dynamic)
     {
-        m_body = cpBodyNew(tocp(mass), tocp(moment));
+        m_body = cpBodyInit(allocate_body(), tocp(mass), tocp(moment));
     }
     else if(type == physical_body_type::steady)
     {
-        m_body = cpBodyNewStatic();
+        m_body = cpBodyInit(allocate_body(), 0.0, 0.0);
+        cpBodySetType(m_body, CP_BODY_TYPE_STATIC);
     }
     else if(type == physical_body_type::kinematic)
     {
-        m_body = cpBodyNewKinematic();
+        m_body = cpBodyInit(allocate_body(), 0.0, 0.0);
+        cpBodySetType(m_body, CP_BODY_TYPE_KINEMATIC);
     }
 
     if(!m_body)
@@ -711,7 +759,7 @@ physical_body::~physical_body()
     {
         unregister();
         cpSpaceRemoveBody(cpBodyGetSpace(m_body), m_body);
-        cpBodyFree(m_body);
+        free_body(m_body);
     }
 }
 
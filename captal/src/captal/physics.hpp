@@ -33,6 +33,7 @@
 #include <optional>
 
 #include <captal_foundation/math.hpp>
+#include <captal_foundation/pool_allocator.hpp>
 
 struct cpSpace;
 struct cpBody;
@@ -313,6 +314,9 @@ CAPTAL_API float segment_moment(float mass, vec2f first, vec2f second, float thi
 CAPTAL_API float polygon_moment(float mass, std::span<const vec2f> points, vec2f offset = vec2f{}, float radius = 0.0f) noexcept;
 CAPTAL_API float square_moment(float mass, float width, float height) noexcept;
 
+CAPTAL_API slab_pool::statistics physical_body_pool_statistics();
+CAPTAL_API slab_pool::statistics physical_shape_pool_statistics();
+
 inline constexpr float no_rotation{std::numeric_limits<float>::infinity()};
 
 class CAPTAL_API physical_body
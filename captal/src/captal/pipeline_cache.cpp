@@ -0,0 +1,218 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include "pipeline_cache.hpp"
+
+#include <fstream>
+#include <cstring>
+
+namespace cpt
+{
+
+struct pipeline_cache_file_header
+{
+    std::array<char, 4> magic{'C', 'P', 'T', 'C'};
+    std::uint32_t version{1};
+    std::uint32_t vendor_id{};
+    std::uint32_t device_id{};
+    std::uint32_t driver_version{};
+    std::array<std::uint8_t, 16> uuid{};
+    std::uint64_t size{};
+};
+
+static pipeline_cache_file_header make_header(const tph::physical_device& device, std::uint64_t size) noexcept
+{
+    pipeline_cache_file_header output{};
+    output.vendor_id = device.properties().vendor_id;
+    output.device_id = device.properties().device_id;
+    output.driver_version = device.properties().driver_version;
+    output.uuid = device.properties().uuid;
+    output.size = size;
+
+    return output;
+}
+
+static bool is_compatible(const pipeline_cache_file_header& left, const pipeline_cache_file_header& right) noexcept
+{
+    return left.magic == right.magic
+        && left.version == right.version
+        && left.vendor_id == right.vendor_id
+        && left.device_id == right.device_id
+        && left.driver_version == right.driver_version
+        && left.uuid == right.uuid;
+}
+
+pipeline_cache::pipeline_cache(tph::renderer& renderer, const tph::physical_device& device, std::filesystem::path path)
+:m_renderer{&renderer}
+,m_device{&device}
+,m_path{std::move(path)}
+{
+    if(!std::empty(m_path) && std::filesystem::exists(m_path))
+    {
+        std::ifstream ifs{m_path, std::ios_base::binary};
+
+        pipeline_cache_file_header header{};
+        ifs.read(reinterpret_cast<char*>(&header), sizeof(pipeline_cache_file_header));
+
+        if(ifs && is_compatible(header, make_header(device, 0)))
+        {
+            m_initial_data.resize(static_cast<std::size_t>(header.size));
+            ifs.read(std::data(m_initial_data), static_cast<std::streamsize>(header.size));
+
+            if(ifs)
+            {
+                m_state = pipeline_cache_state::loaded;
+                m_loaded_size = header.size;
+            }
+            else
+            {
+                m_initial_data.clear();
+                m_state = pipeline_cache_state::invalidated;
+            }
+        }
+        else
+        {
+            m_state = pipeline_cache_state::invalidated;
+        }
+    }
+
+    //First cache, the others are created on contention
+    release(acquire());
+}
+
+tph::pipeline pipeline_cache::make_pipeline(tph::render_pass& render_pass, const tph::graphics_pipeline_info& info, const tph::pipeline_layout& layout)
+{
+    auto& cache{acquire()};
+
+    try
+    {
+        const auto begin{std::chrono::steady_clock::now()};
+        tph::pipeline output{*m_renderer, render_pass, info, layout, cache};
+        record_creation(begin);
+
+        release(cache);
+
+        return output;
+    }
+    catch(...)
+    {
+        release(cache);
+        throw;
+    }
+}
+
+tph::pipeline pipeline_cache::make_pipeline(const tph::compute_pipeline_info& info, const tph::pipeline_layout& layout)
+{
+    auto& cache{acquire()};
+
+    try
+    {
+        const auto begin{std::chrono::steady_clock::now()};
+        tph::pipeline output{*m_renderer, info, layout, cache};
+        record_creation(begin);
+
+        release(cache);
+
+        return output;
+    }
+    catch(...)
+    {
+        release(cache);
+        throw;
+    }
+}
+
+tph::pipeline_cache& pipeline_cache::acquire()
+{
+    std::lock_guard lock{m_mutex};
+
+    if(!std::empty(m_free_caches))
+    {
+        auto& output{*m_free_caches.back()};
+        m_free_caches.pop_back();
+
+        return output;
+    }
+
+    //Each cache starts with the data loaded from file, so concurrent creations also benefit from it
+    const auto data{std::span{reinterpret_cast<const std::uint8_t*>(std::data(m_initial_data)), std::size(m_initial_data)}};
+
+    auto& output{*m_caches.emplace_back(std::make_unique<tph::pipeline_cache>(*m_renderer, data))};
+    m_free_caches.reserve(std::size(m_caches)); //So release never allocates
+
+    return output;
+}
+
+void pipeline_cache::release(tph::pipeline_cache& cache) noexcept
+{
+    std::lock_guard lock{m_mutex};
+
+    m_free_caches.emplace_back(&cache);
+}
+
+void pipeline_cache::save()
+{
+    if(std::empty(m_path))
+    {
+        return;
+    }
+
+    std::lock_guard lock{m_mutex};
+
+    auto& main_cache{*m_caches.front()};
+
+    std::vector<std::reference_wrapper<tph::pipeline_cache>> others{};
+    others.reserve(std::size(m_caches));
+
+    for(auto it{std::begin(m_caches) + 1}; it != std::end(m_caches); ++it)
+    {
+        others.emplace_back(**it);
+    }
+
+    if(!std::empty(others))
+    {
+        main_cache.merge_with(others);
+    }
+
+    const auto data{main_cache.data()};
+    const auto header{make_header(*m_device, std::size(data))};
+
+    std::ofstream ofs{m_path, std::ios_base::binary};
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(pipeline_cache_file_header));
+    ofs.write(std::data(data), static_cast<std::streamsize>(std::size(data)));
+
+    if(!ofs)
+    {
+        throw std::runtime_error{"Can not write pipeline cache file \"" + m_path.string() + "\"."};
+    }
+}
+
+void pipeline_cache::record_creation(std::chrono::steady_clock::time_point begin) noexcept
+{
+    const auto elapsed{std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin)};
+
+    m_pipeline_count.fetch_add(1, std::memory_order_relaxed);
+    m_creation_time.fetch_add(elapsed.count(), std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,111 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#ifndef CAPTAL_PIPELINE_CACHE_HPP_INCLUDED
+#define CAPTAL_PIPELINE_CACHE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <filesystem>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include <tephra/hardware.hpp>
+#include <tephra/renderer.hpp>
+#include <tephra/render_target.hpp>
+#include <tephra/pipeline.hpp>
+
+namespace cpt
+{
+
+enum class pipeline_cache_state : std::uint32_t
+{
+    empty = 0,        //No file, or persistence disabled
+    loaded = 1,       //Loaded from file
+    invalidated = 2,  //A file was found but it was written by another device or driver
+};
+
+struct pipeline_cache_statistics
+{
+    pipeline_cache_state state{};
+    std::uint64_t loaded_size{};
+    std::uint64_t pipeline_count{};
+    std::chrono::nanoseconds creation_time{};
+};
+
+//Persistent pipeline cache, concurrent creations each borrow their own cache from a pool, all of them are merged on save.
+//The file starts with a small header identifying the device and the driver, it is discarded on mismatch.
+class CAPTAL_API pipeline_cache
+{
+public:
+    pipeline_cache() = default;
+    explicit pipeline_cache(tph::renderer& renderer, const tph::physical_device& device, std::filesystem::path path);
+
+    ~pipeline_cache() = default;
+    pipeline_cache(const pipeline_cache&) = delete;
+    pipeline_cache& operator=(const pipeline_cache&) = delete;
+    pipeline_cache(pipeline_cache&&) noexcept = delete;
+    pipeline_cache& operator=(pipeline_cache&&) noexcept = delete;
+
+    tph::pipeline make_pipeline(tph::render_pass& render_pass, const tph::graphics_pipeline_info& info, const tph::pipeline_layout& layout);
+    tph::pipeline make_pipeline(const tph::compute_pipeline_info& info, const tph::pipeline_layout& layout);
+
+    //Must not be called while other threads are creating pipelines
+    void save();
+
+    const std::filesystem::path& path() const noexcept
+    {
+        return m_path;
+    }
+
+    pipeline_cache_statistics statistics() const noexcept
+    {
+        return pipeline_cache_statistics{m_state, m_loaded_size, m_pipeline_count.load(std::memory_order_relaxed), std::chrono::nanoseconds{m_creation_time.load(std::memory_order_relaxed)}};
+    }
+
+private:
+    tph::pipeline_cache& acquire();
+    void release(tph::pipeline_cache& cache) noexcept;
+    void record_creation(std::chrono::steady_clock::time_point begin) noexcept;
+
+private:
+    tph::renderer* m_renderer{};
+    const tph::physical_device* m_device{};
+    std::filesystem::path m_path{};
+    std::string m_initial_data{};
+    std::vector<std::unique_ptr<tph::pipeline_cache>> m_caches{};
+    std::vector<tph::pipeline_cache*> m_free_caches{};
+    std::mutex m_mutex{};
+
+    pipeline_cache_state m_state{};
+    std::uint64_t m_loaded_size{};
+    std::atomic<std::uint64_t> m_pipeline_count{};
+    std::atomic<std::int64_t> m_creation_time{};
+};
+
+}
+
+#endif
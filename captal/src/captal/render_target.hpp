@@ -77,6 +77,17 @@ public:
         return m_render_pass;
     }
 
+    //Scene epoch of the last frame recorded by systems::render, see scene_epoch()
+    std::uint64_t recorded_epoch() const noexcept
+    {
+        return m_recorded_epoch;
+    }
+
+    void set_recorded_epoch(std::uint64_t epoch) noexcept
+    {
+        m_recorded_epoch = epoch;
+    }
+
 protected:
     render_target(const render_target&) = delete;
     render_target& operator=(const render_target&) = delete;
@@ -85,6 +96,7 @@ protected:
 
 private:
     tph::render_pass m_render_pass{};
+    std::uint64_t m_recorded_epoch{};
 };
 
 using render_target_ptr = std::shared_ptr<render_target>;
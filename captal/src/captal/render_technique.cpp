@@ -198,6 +198,54 @@ descriptor_set_ptr render_layout::make_set(std::uint32_t layout_index)
     return data.pools.back()->allocate();
 }
 
+shared_descriptor_set_ptr render_layout::find_shared_set(std::uint32_t layout_index, std::size_t hash, std::span<const binding_key> key)
+{
+    std::lock_guard lock{m_mutex};
+
+    auto& data{m_layout_data[layout_index]};
+
+    const auto [begin, end] = data.shared_sets.equal_range(hash);
+    for(auto it{begin}; it != end; ++it)
+    {
+        if(auto set{it->second.lock()}; set && set->relocation == buffer_relocation_epoch() && std::equal(std::begin(set->key), std::end(set->key), std::begin(key), std::end(key)))
+        {
+            return set;
+        }
+    }
+
+    return nullptr;
+}
+
+shared_descriptor_set_ptr render_layout::insert_shared_set(std::uint32_t layout_index, std::size_t hash, shared_descriptor_set_ptr set)
+{
+    std::lock_guard lock{m_mutex};
+
+    auto& data{m_layout_data[layout_index]};
+
+    //Another thread may have inserted the same set in the meantime
+    const auto [begin, end] = data.shared_sets.equal_range(hash);
+    for(auto it{begin}; it != end; ++it)
+    {
+        if(auto other{it->second.lock()}; other && other->relocation == set->relocation && other->key == set->key)
+        {
+            return other;
+        }
+    }
+
+    //Expired entries are only removed from time to time, they are cheap to keep around
+    if(++data.shared_sets_insertions % 64 == 0)
+    {
+        std::erase_if(data.shared_sets, [](const auto& item)
+        {
+            return item.second.expired();
+        });
+    }
+
+    data.shared_sets.emplace(hash, set);
+
+    return set;
+}
+
 #ifdef CAPTAL_DEBUG
 void render_layout::set_name(std::string_view name)
 {
@@ -266,10 +314,20 @@ static tph::graphics_pipeline_info make_info(const render_technique_info& info,
         output.stages.emplace_back(engine::instance().default_fragment_shader());
     }
 
-    output.vertex_input.bindings.emplace_back(0, static_cast<std::uint32_t>(sizeof(vertex)));
-    output.vertex_input.attributes.emplace_back(0, 0, tph::vertex_format::vec3f, static_cast<std::uint32_t>(offsetof(vertex, position)));
-    output.vertex_input.attributes.emplace_back(1, 0, tph::vertex_format::vec4f, static_cast<std::uint32_t>(offsetof(vertex, color)));
-    output.vertex_input.attributes.emplace_back(2, 0, tph::vertex_format::vec2f, static_cast<std::uint32_t>(offsetof(vertex, texture_coord)));
+    if(info.vertex_format == vertex_format::packed)
+    {
+        output.vertex_input.bindings.emplace_back(0, static_cast<std::uint32_t>(sizeof(packed_vertex)));
+        output.vertex_input.attributes.emplace_back(0, 0, tph::vertex_format::vec3f, static_cast<std::uint32_t>(offsetof(packed_vertex, position)));
+        output.vertex_input.attributes.emplace_back(1, 0, tph::vertex_format::vec4u8_unorm, static_cast<std::uint32_t>(offsetof(packed_vertex, color)));
+        output.vertex_input.attributes.emplace_back(2, 0, tph::vertex_format::vec2u16_unorm, static_cast<std::uint32_t>(offsetof(packed_vertex, texture_coord)));
+    }
+    else
+    {
+        output.vertex_input.bindings.emplace_back(0, static_cast<std::uint32_t>(sizeof(vertex)));
+        output.vertex_input.attributes.emplace_back(0, 0, tph::vertex_format::vec3f, static_cast<std::uint32_t>(offsetof(vertex, position)));
+        output.vertex_input.attributes.emplace_back(1, 0, tph::vertex_format::vec4f, static_cast<std::uint32_t>(offsetof(vertex, color)));
+        output.vertex_input.attributes.emplace_back(2, 0, tph::vertex_format::vec2f, static_cast<std::uint32_t>(offsetof(vertex, texture_coord)));
+    }
     output.tesselation = info.tesselation;
     output.viewport.viewport_count = 1;
     output.rasterization = info.rasterization;
@@ -283,16 +341,156 @@ static tph::graphics_pipeline_info make_info(const render_technique_info& info,
 
 render_technique::render_technique(const render_target_ptr& target, const render_technique_info& info, render_layout_ptr layout, render_technique_options options)
 :m_layout{layout ? std::move(layout) : engine::instance().default_render_layout()}
-,m_pipeline{engine::instance().renderer(), target->get_render_pass(), make_info(info, options), m_layout->pipeline_layout()}
+,m_pipeline{engine::instance().pipeline_cache().make_pipeline(target->get_render_pass(), make_info(info, options), m_layout->pipeline_layout())}
+,m_vertex_format{info.vertex_format}
 {
 
 }
 
+render_technique::render_technique(compile_async_t, const render_target_ptr& target, const render_technique_info& info, render_layout_ptr layout, render_technique_options options, render_technique_ptr fallback)
+:m_layout{layout ? std::move(layout) : engine::instance().default_render_layout()}
+,m_vertex_format{info.vertex_format}
+,m_status{render_technique_status::compiling}
+,m_fallback{fallback ? std::move(fallback) : engine::instance().default_render_technique(target, info.vertex_format)}
+{
+    assert(m_fallback->vertex_format() == m_vertex_format && "cpt::render_technique fallback must use the same vertex format.");
+
+    //Shaders in info must outlive the compilation, the render target and the layout are kept alive by the task
+    auto task = [target, layout = m_layout, pipeline_info = make_info(info, options)]()
+    {
+        return engine::instance().pipeline_cache().make_pipeline(target->get_render_pass(), pipeline_info, layout->pipeline_layout());
+    };
+
+    m_future = engine::instance().task_pool().submit(std::move(task));
+}
+
+bool render_technique::is_ready()
+{
+    if(status() == render_technique_status::compiling)
+    {
+        poll(false);
+    }
+
+    return status() == render_technique_status::ready;
+}
+
+void render_technique::wait()
+{
+    if(status() == render_technique_status::compiling)
+    {
+        poll(true);
+    }
+
+    if(m_exception)
+    {
+        std::rethrow_exception(m_exception);
+    }
+}
+
+render_technique& render_technique::active() noexcept
+{
+    if(status() == render_technique_status::ready || !m_fallback)
+    {
+        return *this;
+    }
+
+    //Errors are reported by exception() or wait(), rendering keeps using the fallback
+    try
+    {
+        if(is_ready())
+        {
+            return *this;
+        }
+    }
+    catch(...)
+    {
+
+    }
+
+    return m_fallback->active();
+}
+
+void render_technique::poll(bool block)
+{
+    std::lock_guard lock{m_mutex};
+
+    if(status() != render_technique_status::compiling)
+    {
+        return;
+    }
+
+    if(!block && m_future.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+    {
+        return;
+    }
+
+    try
+    {
+        m_pipeline = m_future.get();
+    }
+    catch(...)
+    {
+        m_exception = std::current_exception();
+        m_status.store(render_technique_status::failed, std::memory_order_release);
+
+        return;
+    }
+
+    #ifdef CAPTAL_DEBUG
+    if(!std::empty(m_name))
+    {
+        tph::set_object_name(engine::instance().renderer(), m_pipeline, m_name + " pipeline");
+    }
+    #endif
+
+    m_status.store(render_technique_status::ready, std::memory_order_release);
+}
+
 #ifdef CAPTAL_DEBUG
 void render_technique::set_name(std::string_view name)
 {
-    tph::set_object_name(engine::instance().renderer(), m_pipeline, std::string{name} + " pipeline");
+    m_name = name;
+
+    if(is_ready())
+    {
+        tph::set_object_name(engine::instance().renderer(), m_pipeline, m_name + " pipeline");
+    }
+
+    if(m_fallback)
+    {
+        m_fallback->set_name(m_name + " fallback");
+    }
 }
 #endif
 
+std::vector<render_technique_ptr> precompile_render_techniques(const render_target_ptr& target, std::span<const render_technique_description> descriptions)
+{
+    std::vector<std::future<render_technique_ptr>> futures{};
+    futures.reserve(std::size(descriptions));
+
+    for(auto&& description : descriptions)
+    {
+        futures.emplace_back(engine::instance().task_pool().submit([&target, &description]()
+        {
+            return make_render_technique(target, description.info, description.layout, description.options);
+        }));
+    }
+
+    //Wait for all tasks before rethrowing, they reference descriptions
+    for(auto&& future : futures)
+    {
+        future.wait();
+    }
+
+    std::vector<render_technique_ptr> output{};
+    output.reserve(std::size(descriptions));
+
+    for(auto&& future : futures)
+    {
+        output.emplace_back(future.get());
+    }
+
+    return output;
+}
+
 }
@@ -27,6 +27,10 @@
 
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <future>
+#include <exception>
+#include <unordered_map>
 
 #include <tephra/shader.hpp>
 #include <tephra/pipeline.hpp>
@@ -36,6 +40,7 @@
 #include "render_target.hpp"
 #include "signal.hpp"
 #include "binding.hpp"
+#include "vertex.hpp"
 
 namespace cpt
 {
@@ -130,6 +135,17 @@ private:
     std::array<descriptor_set_ptr, pool_size> m_sets{};
 };
 
+//Descriptor set shared by all renderables with the same bindings
+struct shared_descriptor_set
+{
+    descriptor_set_ptr set{};
+    std::vector<binding_key> key{};
+    std::vector<asynchronous_resource_ptr> to_keep{};
+    std::uint64_t relocation{}; //buffer_relocation_epoch() when the set was written
+};
+
+using shared_descriptor_set_ptr = std::shared_ptr<shared_descriptor_set>;
+
 struct render_layout_info
 {
     std::vector<tph::descriptor_set_layout_binding> bindings{};
@@ -154,6 +170,9 @@ public:
 
     descriptor_set_ptr make_set(std::uint32_t layout_index);
 
+    shared_descriptor_set_ptr find_shared_set(std::uint32_t layout_index, std::size_t hash, std::span<const binding_key> key);
+    shared_descriptor_set_ptr insert_shared_set(std::uint32_t layout_index, std::size_t hash, shared_descriptor_set_ptr set);
+
     tph::descriptor_set_layout& descriptor_set_layout(std::uint32_t layout_index) noexcept
     {
         return m_layout_data[layout_index].layout;
@@ -214,6 +233,8 @@ private:
         std::vector<tph::push_constant_range> push_constants{};
         std::vector<tph::descriptor_pool_size> sizes{};
         std::vector<std::unique_ptr<descriptor_pool>> pools{};
+        std::unordered_multimap<std::size_t, std::weak_ptr<shared_descriptor_set>> shared_sets{};
+        std::size_t shared_sets_insertions{};
     };
 
     static layout_data make_layout_data(const render_layout_info& info);
@@ -255,18 +276,46 @@ struct render_technique_info
     tph::pipeline_multisample multisample{};
     tph::pipeline_depth_stencil depth_stencil{};
     tph::pipeline_color_blend color_blend{};
+    cpt::vertex_format vertex_format{cpt::vertex_format::standard}; //Renderables drawn with this technique must use the same format
+};
+
+enum class render_technique_status : std::uint32_t
+{
+    compiling = 0,
+    ready = 1,
+    failed = 2,
 };
 
+struct compile_async_t{};
+inline constexpr compile_async_t compile_async{};
+
+class render_technique;
+using render_technique_ptr = std::shared_ptr<render_technique>;
+using render_technique_weak_ptr = std::weak_ptr<render_technique>;
+
 class CAPTAL_API render_technique : public asynchronous_resource
 {
 public:
     explicit render_technique(const render_target_ptr& target, const render_technique_info& info, render_layout_ptr layout = nullptr, render_technique_options options = render_technique_options::none);
+
+    //The pipeline is compiled by the engine's task pool, fallback is used for rendering until it is ready.
+    //If fallback is null, the engine's default technique of the target and vertex format is used (see engine::default_render_technique).
+    explicit render_technique(compile_async_t, const render_target_ptr& target, const render_technique_info& info, render_layout_ptr layout = nullptr, render_technique_options options = render_technique_options::none, render_technique_ptr fallback = nullptr);
+
     ~render_technique() = default;
     render_technique(const render_technique&) = delete;
     render_technique& operator=(const render_technique&) = delete;
     render_technique(render_technique&&) noexcept = delete;
     render_technique& operator=(render_technique&&) noexcept = delete;
 
+    //Returns true once the pipeline can be used, never blocks
+    bool is_ready();
+    //Blocks until compilation ends, rethrows compilation error if any
+    void wait();
+
+    //Returns this technique if ready, its fallback otherwise
+    cpt::render_technique& active() noexcept;
+
     const render_layout_ptr& layout() const noexcept
     {
         return m_layout;
@@ -282,6 +331,26 @@ public:
         return m_pipeline;
     }
 
+    cpt::vertex_format vertex_format() const noexcept
+    {
+        return m_vertex_format;
+    }
+
+    render_technique_status status() const noexcept
+    {
+        return m_status.load(std::memory_order_acquire);
+    }
+
+    const render_technique_ptr& fallback() const noexcept
+    {
+        return m_fallback;
+    }
+
+    std::exception_ptr exception() const noexcept
+    {
+        return m_exception;
+    }
+
 #ifdef CAPTAL_DEBUG
     void set_name(std::string_view name);
 #else
@@ -291,13 +360,23 @@ public:
     }
 #endif
 
+private:
+    void poll(bool block);
+
 private:
     render_layout_ptr m_layout{};
     tph::pipeline m_pipeline{};
-};
+    cpt::vertex_format m_vertex_format{};
+    std::atomic<render_technique_status> m_status{render_technique_status::ready};
+    std::future<tph::pipeline> m_future{};
+    render_technique_ptr m_fallback{};
+    std::exception_ptr m_exception{};
+    std::mutex m_mutex{};
 
-using render_technique_ptr = std::shared_ptr<render_technique>;
-using render_technique_weak_ptr = std::weak_ptr<render_technique>;
+#ifdef CAPTAL_DEBUG
+    std::string m_name{};
+#endif
+};
 
 template<typename... Args>
 render_technique_ptr make_render_technique(Args&&... args)
@@ -305,6 +384,23 @@ render_technique_ptr make_render_technique(Args&&... args)
     return std::make_shared<render_technique>(std::forward<Args>(args)...);
 }
 
+template<typename... Args>
+render_technique_ptr make_async_render_technique(Args&&... args)
+{
+    return std::make_shared<render_technique>(compile_async, std::forward<Args>(args)...);
+}
+
+struct render_technique_description
+{
+    render_technique_info info{};
+    render_layout_ptr layout{};
+    render_technique_options options{};
+};
+
+//Compiles all techniques on the engine's task pool and waits for them, this also fills the pipeline cache for next runs.
+//Meant for loading screens, the returned techniques are ready to use. Must not be called from a task of the engine's task pool.
+CAPTAL_API std::vector<render_technique_ptr> precompile_render_techniques(const render_target_ptr& target, std::span<const render_technique_description> descriptions);
+
 }
 
 template<> struct cpt::enable_enum_operations<cpt::render_technique_options> {static constexpr bool value{true};};
@@ -157,6 +157,11 @@ render_texture::render_texture(std::uint32_t width, std::uint32_t height, const
 ,m_framebuffer{engine::instance().renderer(), get_render_pass(), convert_framebuffer_attachments(m_attachments), width, height, 1}
 ,m_pool{engine::instance().renderer(), tph::command_pool_options::reset}
 {
+    for(auto&& attachment : m_attachments)
+    {
+        attachment->set_memory_category(memory_category::render_target);
+    }
+
     m_frames_data.reserve(4);
 }
 
@@ -171,6 +176,11 @@ render_texture::render_texture(texture_ptr texture, tph::sample_count sample_cou
 ,m_has_depth_stencil{depth_format != tph::texture_format::undefined}
 #endif
 {
+    for(auto&& attachment : m_attachments)
+    {
+        attachment->set_memory_category(memory_category::render_target);
+    }
+
     m_frames_data.reserve(4);
 }
 
@@ -235,14 +245,18 @@ void render_texture::present()
 {
     assert(m_data && "cpt::render_texture::present called without prior call to cpt::render_texture::begin_render.");
 
-    tph::cmd::end_render_pass(m_data->buffer);
-
-    if(m_data->timed)
+    //Reused command buffers are already complete
+    if(m_data->epoch != m_epoch)
     {
-        tph::cmd::write_timestamp(m_data->buffer, m_data->query_pool, 1, tph::pipeline_stage::bottom_of_pipe);
-    }
+        tph::cmd::end_render_pass(m_data->buffer);
+
+        if(m_data->timed)
+        {
+            tph::cmd::write_timestamp(m_data->buffer, m_data->query_pool, 1, tph::pipeline_stage::bottom_of_pipe);
+        }
 
-    tph::cmd::end(m_data->buffer);
+        tph::cmd::end(m_data->buffer);
+    }
 
     m_data->fence.reset();
 
@@ -639,6 +639,8 @@ bool render_window::recreate()
     m_depth_texture = std::move(depth_texture);
     m_depth_texture_view = std::move(depth_view);
 
+    m_attachments_memory = memory_tracking{memory_category::render_target, memory_location::device, m_msaa_texture.memory_size() + m_depth_texture.memory_size()};
+
     setup_framebuffers();
 
     if(std::size(m_frames_data) != m_swapchain->info().image_count)
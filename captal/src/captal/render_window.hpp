@@ -155,6 +155,7 @@ private:
     tph::texture_view m_msaa_texture_view{};
     tph::texture m_depth_texture{};
     tph::texture_view m_depth_texture_view{};
+    memory_tracking m_attachments_memory{};
     tph::clear_color_value m_clear_color{};
     tph::clear_depth_stencil_value m_clear_depth_stencil{};
     std::uint32_t m_epoch{1};
@@ -24,6 +24,8 @@
 
 #include <cassert>
 
+#include <captal_foundation/frame_allocator.hpp>
+
 #include <tephra/commands.hpp>
 
 #include "engine.hpp"
@@ -31,21 +33,21 @@
 namespace cpt
 {
 
-static std::array<buffer_part, 2> compute_buffer_parts(std::uint32_t vertex_count)
+static std::array<buffer_part, 2> compute_buffer_parts(std::uint32_t vertex_count, vertex_format format)
 {
     return std::array<buffer_part, 2>
     {
         buffer_part{buffer_part_type::uniform, sizeof(basic_renderable::uniform_data)},
-        buffer_part{buffer_part_type::vertex, vertex_count * sizeof(vertex)},
+        buffer_part{buffer_part_type::vertex, vertex_count * vertex_size(format)},
     };
 }
 
-static std::array<buffer_part, 3> compute_buffer_parts(std::uint32_t vertex_count, std::uint32_t index_count)
+static std::array<buffer_part, 3> compute_buffer_parts(std::uint32_t vertex_count, std::uint32_t index_count, vertex_format format)
 {
     return std::array<buffer_part, 3>
     {
         buffer_part{buffer_part_type::uniform, sizeof(basic_renderable::uniform_data)},
-        buffer_part{buffer_part_type::vertex, vertex_count * sizeof(vertex)},
+        buffer_part{buffer_part_type::vertex, vertex_count * vertex_size(format)},
         buffer_part{buffer_part_type::index, index_count * sizeof(std::uint32_t)},
     };
 }
@@ -54,10 +56,12 @@ basic_renderable::basic_renderable(std::uint32_t vertex_count, std::uint32_t uni
 :m_vertex_count{vertex_count}
 ,m_uniform_index{uniform_index}
 {
-    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count))};
+    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, m_vertex_format))};
     m_buffer = buffer.get();
 
     m_bindings.set(m_uniform_index, uniform_buffer_part{std::move(buffer), 0});
+
+    touch_scene();
 }
 
 basic_renderable::basic_renderable(std::uint32_t vertex_count, std::uint32_t index_count, std::uint32_t uniform_index)
@@ -65,19 +69,35 @@ basic_renderable::basic_renderable(std::uint32_t vertex_count, std::uint32_t ind
 ,m_index_count{index_count}
 ,m_uniform_index{uniform_index}
 {
-    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, index_count))};
+    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, index_count, m_vertex_format))};
     m_buffer = buffer.get();
 
     m_bindings.set(m_uniform_index, uniform_buffer_part{std::move(buffer), 0});
+
+    touch_scene();
+}
+
+//Destroyed renderables disappear from the next frames
+basic_renderable::~basic_renderable()
+{
+    touch_scene();
 }
 
 void basic_renderable::set_vertices(std::span<const vertex> vertices) noexcept
 {
     assert(std::size(vertices) == m_vertex_count && "cpt::basic_renderable::set_vertices called with a wrong number of vertices.");
 
-    std::memcpy(&m_buffer->get<vertex>(1), std::data(vertices), std::size(vertices) * sizeof(vertex));
+    if(m_vertex_format == cpt::vertex_format::packed)
+    {
+        std::copy(std::begin(vertices), std::end(vertices), std::begin(m_vertices));
+    }
+    else
+    {
+        std::memcpy(&m_buffer->get<vertex>(1), std::data(vertices), std::size(vertices) * sizeof(vertex));
+    }
 
     m_upload_vertices = true;
+    touch_scene();
 }
 
 void basic_renderable::set_indices(std::span<const std::uint32_t> indices) noexcept
@@ -88,50 +108,65 @@ void basic_renderable::set_indices(std::span<const std::uint32_t> indices) noexc
     std::memcpy(&m_buffer->get<std::uint32_t>(2), std::data(indices), std::size(indices) * sizeof(std::uint32_t));
 
     m_upload_indices = true;
+    touch_scene();
 }
 
 void basic_renderable::reset(std::uint32_t vertex_count)
 {
-    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count))};
+    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, m_vertex_format))};
 
     m_buffer = buffer.get();
     m_vertex_count = vertex_count;
     m_upload_model = true;
+    ++m_descriptors_epoch;
+
+    if(m_vertex_format == cpt::vertex_format::packed)
+    {
+        m_vertices.resize(vertex_count);
+    }
 
     m_bindings.set(m_uniform_index, uniform_buffer_part{std::move(buffer), 0});
+    touch_scene();
 }
 
 void basic_renderable::reset(std::uint32_t vertex_count, std::uint32_t index_count)
 {
-    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, index_count))};
+    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, index_count, m_vertex_format))};
 
     m_buffer = buffer.get();
     m_vertex_count = vertex_count;
     m_index_count = index_count;
     m_upload_model = true;
+    ++m_descriptors_epoch;
+
+    if(m_vertex_format == cpt::vertex_format::packed)
+    {
+        m_vertices.resize(vertex_count);
+    }
 
     m_bindings.set(m_uniform_index, uniform_buffer_part{std::move(buffer), 0});
+    touch_scene();
 }
 
 void basic_renderable::bind(frame_render_info info, cpt::view& view)
 {
-    const auto& layout{view.render_technique()->layout()};
+    assert(view.active_render_technique().vertex_format() == m_vertex_format && "cpt::basic_renderable::bind called with a view whose render technique uses another vertex format.");
+
+    const auto& layout{view.active_render_technique().layout()};
 
-    const auto write_set = [this, &layout](descriptor_set_data& data)
+    const auto make_data = [this, &layout]()
     {
-        #ifdef CAPTAL_DEBUG
-        if(!std::empty(m_name))
-        {
-            const std::string layout_name{std::empty(layout->m_name) ? std::string{"unknown"} : layout->m_name};
+        const auto to_bind{layout->bindings(render_layout::renderable_index)};
 
-            tph::set_object_name(engine::instance().renderer(), data.set->set(), m_name + " descriptor set for render layout " + layout_name);
-        }
-        #endif
+        auto bindings{make_frame_vector<std::reference_wrapper<const cpt::binding>>()};
+        bindings.reserve(std::size(to_bind));
 
-        const auto to_bind{layout->bindings(render_layout::renderable_index)};
+        descriptor_set_data output{};
+        output.epoch = m_descriptors_epoch;
+        output.relocation = buffer_relocation_epoch();
 
-        std::vector<tph::descriptor_write> writes{};
-        writes.reserve(std::size(to_bind));
+        std::vector<binding_key> key{};
+        key.reserve(std::size(to_bind));
 
         for(auto&& binding : to_bind)
         {
@@ -139,38 +174,74 @@ void basic_renderable::bind(frame_render_info info, cpt::view& view)
 
             if(local)
             {
-                writes.emplace_back(make_descriptor_write(data.set->set(), binding.binding, *local));
-                data.to_keep.emplace_back(get_binding_resource(*local));
+                bindings.emplace_back(*local);
             }
             else
             {
                 const auto fallback{layout->default_binding(render_layout::renderable_index, binding.binding)};
                 assert(fallback && "cpt::basic_renderable::bind can not find any suitable binding, neither the renderable nor the render layout have a binding for specified index.");
 
-                writes.emplace_back(make_descriptor_write(data.set->set(), binding.binding, *fallback));
-                data.to_keep.emplace_back(get_binding_resource(*fallback));
+                bindings.emplace_back(*fallback);
             }
+
+            key.emplace_back(make_binding_key(bindings.back(), binding.type));
+
+            if(binding.type == tph::descriptor_type::uniform_buffer_dynamic)
+            {
+                output.dynamic_offsets.emplace_back(dynamic_offset(bindings.back()));
+            }
+        }
+
+        //Renderables with the same bindings share the same descriptor set
+        const auto hash{hash_binding_keys(key)};
+
+        if(auto set{layout->find_shared_set(render_layout::renderable_index, hash, key)}; set)
+        {
+            output.set = std::move(set);
+
+            return output;
+        }
+
+        auto set{std::make_shared<shared_descriptor_set>()};
+        set->set = layout->make_set(render_layout::renderable_index);
+        set->key = std::move(key);
+        set->relocation = output.relocation;
+        set->to_keep.reserve(std::size(bindings));
+
+        #ifdef CAPTAL_DEBUG
+        if(!std::empty(m_name))
+        {
+            const std::string layout_name{std::empty(layout->m_name) ? std::string{"unknown"} : layout->m_name};
+
+            tph::set_object_name(engine::instance().renderer(), set->set->set(), m_name + " descriptor set for render layout " + layout_name);
+        }
+        #endif
+
+        auto writes{make_frame_vector<tph::descriptor_write>()};
+        writes.reserve(std::size(to_bind));
+
+        for(std::size_t i{}; i < std::size(to_bind); ++i)
+        {
+            writes.emplace_back(make_descriptor_write(set->set->set(), to_bind[i].binding, bindings[i], to_bind[i].type));
+            set->to_keep.emplace_back(get_binding_resource(bindings[i]));
         }
 
         tph::write_descriptors(engine::instance().renderer(), writes);
+
+        output.set = layout->insert_shared_set(render_layout::renderable_index, hash, std::move(set));
+
+        return output;
     };
 
     auto it{m_sets.find(layout)};
 
     if(it == std::end(m_sets)) //New layout
     {
-        it = m_sets.emplace(layout, descriptor_set_data{layout->make_set(render_layout::renderable_index), std::vector<asynchronous_resource_ptr>{}, m_descriptors_epoch}).first;
-
-        write_set(it->second);
+        it = m_sets.emplace(layout, make_data()).first;
     }
-    else if(it->second.epoch < m_descriptors_epoch) //Already known layout but not up to date
+    else if(it->second.epoch < m_descriptors_epoch || it->second.relocation != buffer_relocation_epoch()) //Already known layout but not up to date
     {
-        it->second.set.reset();
-        it->second.set = layout->make_set(1);
-        it->second.to_keep.clear();
-        it->second.epoch = m_descriptors_epoch;
-
-        write_set(it->second);
+        it->second = make_data();
     }
 
     auto buffer{m_buffer->get_buffer()};
@@ -181,12 +252,12 @@ void basic_renderable::bind(frame_render_info info, cpt::view& view)
     }
 
     tph::cmd::bind_vertex_buffer (info.buffer, buffer.buffer, buffer.offset + m_buffer->part_offset(1));
-    tph::cmd::bind_descriptor_set(info.buffer, 1, it->second.set->set(), layout->pipeline_layout());
+    tph::cmd::bind_descriptor_set(info.buffer, 1, it->second.set->set->set(), layout->pipeline_layout(), it->second.dynamic_offsets);
 
     m_push_constants.push(info.buffer, layout, render_layout::renderable_index);
 
-    info.keeper.keep(std::begin(it->second.to_keep), std::end(it->second.to_keep));
-    info.keeper.keep(it->second.set);
+    info.keeper.keep(std::begin(it->second.set->to_keep), std::end(it->second.set->to_keep));
+    info.keeper.keep(it->second.set->set);
 }
 
 void basic_renderable::draw(frame_render_info info)
@@ -213,7 +284,7 @@ void basic_renderable::upload(memory_transfer_info info)
 
     if(std::exchange(m_upload_model, false))
     {
-        m_buffer->get<uniform_data>(0).model = cpt::model(m_position, m_rotation, vec3f{0.0f, 0.0f, 1.0f}, m_scale, m_origin);
+        m_buffer->get<uniform_data>(0).model = cpt::model_2d(m_position, m_rotation, m_scale, m_origin);
         m_buffer->upload(0);
 
         keep = true;
@@ -221,6 +292,14 @@ void basic_renderable::upload(memory_transfer_info info)
 
     if(std::exchange(m_upload_vertices, false))
     {
+        if(m_vertex_format == cpt::vertex_format::packed)
+        {
+            std::transform(std::begin(m_vertices), std::end(m_vertices), &m_buffer->get<packed_vertex>(1), [](const vertex& vertex)
+            {
+                return pack(vertex);
+            });
+        }
+
         m_buffer->upload(1);
 
         keep = true;
@@ -239,30 +318,64 @@ void basic_renderable::upload(memory_transfer_info info)
     }
 }
 
+void basic_renderable::set_vertex_format(cpt::vertex_format format)
+{
+    if(format == m_vertex_format)
+    {
+        return;
+    }
+
+    const std::vector<vertex> vertices{std::begin(cvertices()), std::end(cvertices())};
+
+    std::vector<std::uint32_t> indices{};
+    if(m_index_count > 0)
+    {
+        indices.assign(std::begin(cindices()), std::end(cindices()));
+    }
+
+    m_vertex_format = format;
+
+    if(m_vertex_format == cpt::vertex_format::standard)
+    {
+        m_vertices = std::vector<vertex>{};
+    }
+
+    if(m_index_count > 0)
+    {
+        reset(m_vertex_count, m_index_count);
+        set_indices(indices);
+    }
+    else
+    {
+        reset(m_vertex_count);
+    }
+
+    set_vertices(vertices);
+}
+
 void basic_renderable::set_binding(std::uint32_t index, cpt::binding binding)
 {
     assert(index != m_uniform_index && "cpt::basic_renderable::set_binding must never be called with index == uniform_index.");
 
     m_bindings.set(index, std::move(binding));
     ++m_descriptors_epoch;
+    touch_scene();
 }
 
 #ifdef CAPTAL_DEBUG
 void basic_renderable::set_name(std::string_view name)
 {
+    //Descriptor sets are shared, they are named after the renderable that created them
     m_name = name;
+}
+#endif
 
-    for(auto&& [layout_weak, set] : m_sets)
-    {
-        if(const auto layout{layout_weak.lock()}; layout)
-        {
-            const std::string layout_name{std::empty(layout->m_name) ? std::string{"unknown"} : layout->m_name};
+slab_pool& basic_renderable::descriptor_set_pool()
+{
+    static slab_pool pool{node_block_size<descriptor_set_map_value>, node_block_align<descriptor_set_map_value>, slab_pool::default_slab_block_count, 32};
 
-            tph::set_object_name(engine::instance().renderer(), set.set->set(), m_name + " descriptor set for render layout " + layout_name);
-        }
-    }
+    return pool;
 }
-#endif
 
 sprite::sprite(std::uint32_t width, std::uint32_t height, const color& color)
 :basic_renderable{4, 6, 0}
@@ -290,11 +403,47 @@ sprite::sprite(std::uint32_t width, std::uint32_t height, texture_ptr texture, c
     set_texture(std::move(texture));
 }
 
+sprite::sprite(const texture_region& region, const color& color)
+:basic_renderable{4, 6, 0}
+,m_width{region.flipped ? region.rect.height : region.rect.width}
+,m_height{region.flipped ? region.rect.width : region.rect.height}
+{
+    init(color);
+    set_texture(region);
+}
+
 void sprite::set_texture(texture_ptr texture)
 {
     set_binding(1, std::move(texture));
 }
 
+void sprite::set_texture(const texture_region& region)
+{
+    assert(region.texture && "cpt::sprite::set_texture called with a region of a texture atlas that has not been built.");
+
+    const auto texture_width{static_cast<float>(region.texture->width())};
+    const auto texture_height{static_cast<float>(region.texture->height())};
+
+    const vec2f top_left{static_cast<float>(region.rect.x) / texture_width, static_cast<float>(region.rect.y) / texture_height};
+    const vec2f bottom_right{static_cast<float>(region.rect.x + region.rect.width) / texture_width, static_cast<float>(region.rect.y + region.rect.height) / texture_height};
+
+    set_binding(1, region.texture);
+
+    if(region.flipped) //The image is stored transposed
+    {
+        const auto vertices{basic_renderable::vertices()};
+
+        vertices[0].texture_coord = top_left;
+        vertices[1].texture_coord = vec2f{top_left.x(), bottom_right.y()};
+        vertices[2].texture_coord = bottom_right;
+        vertices[3].texture_coord = vec2f{bottom_right.x(), top_left.y()};
+    }
+    else
+    {
+        set_relative_texture_coords(top_left.x(), top_left.y(), bottom_right.x(), bottom_right.y());
+    }
+}
+
 void sprite::set_color(const color& color) noexcept
 {
     const auto vertices{basic_renderable::vertices()};
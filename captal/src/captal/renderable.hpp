@@ -38,6 +38,8 @@
 #include "view.hpp"
 #include "vertex.hpp"
 #include "texture.hpp"
+#include "texture_atlas.hpp"
+#include "scene_epoch.hpp"
 
 namespace cpt
 {
@@ -104,7 +106,7 @@ protected:
     explicit basic_renderable(std::uint32_t vertex_count, std::uint32_t uniform_index);
     explicit basic_renderable(std::uint32_t vertex_count, std::uint32_t index_count, std::uint32_t uniform_index);
 
-    ~basic_renderable() = default;
+    ~basic_renderable();
     basic_renderable(const basic_renderable&) = delete;
     basic_renderable& operator=(const basic_renderable&) = delete;
     basic_renderable(basic_renderable&&) noexcept = default;
@@ -124,9 +126,14 @@ public:
 
     void set_binding(std::uint32_t index, cpt::binding binding);
 
+    //Must match the vertex format of the render techniques used to draw this renderable
+    void set_vertex_format(cpt::vertex_format format);
+
     template<typename T>
     void set_push_constant(tph::shader_stage stages, std::uint32_t offset, T&& value)
     {
+        touch_scene();
+
         return m_push_constants.set(stages, offset, std::forward<T>(value));
     }
 
@@ -134,58 +141,68 @@ public:
     {
         m_position += relative;
         m_upload_model = true;
+        touch_scene();
     }
 
     void move_to(const vec3f& position) noexcept
     {
         m_position = position;
         m_upload_model = true;
+        touch_scene();
     }
 
     void set_origin(const vec3f& origin) noexcept
     {
         m_origin = origin;
         m_upload_model = true;
+        touch_scene();
     }
 
     void move_origin(const vec3f& relative) noexcept
     {
         m_origin += relative;
         m_upload_model = true;
+        touch_scene();
     }
 
     void rotate(float angle) noexcept
     {
         m_rotation = std::fmod(m_rotation + angle, std::numbers::pi_v<float> * 2.0f);
         m_upload_model = true;
+        touch_scene();
     }
 
     void set_rotation(float angle) noexcept
     {
         m_rotation = std::fmod(angle, std::numbers::pi_v<float> * 2.0f);
         m_upload_model = true;
+        touch_scene();
     }
 
     void scale(const vec3f& scale) noexcept
     {
         m_scale *= scale;
         m_upload_model = true;
+        touch_scene();
     }
 
     void set_scale(const vec3f& scale) noexcept
     {
         m_scale = scale;
         m_upload_model = true;
+        touch_scene();
     }
 
     void hide() noexcept
     {
         m_hidden = true;
+        touch_scene();
     }
 
     void show() noexcept
     {
         m_hidden = false;
+        touch_scene();
     }
 
     const cpt::binding& get_binding(std::uint32_t index) const
@@ -245,9 +262,21 @@ public:
         return m_hidden;
     }
 
+    cpt::vertex_format vertex_format() const noexcept
+    {
+        return m_vertex_format;
+    }
+
+    //Packed renderables are edited in standard format, vertices are packed on upload
     std::span<vertex> vertices() noexcept
     {
         m_upload_vertices = true;
+        touch_scene();
+
+        if(m_vertex_format == cpt::vertex_format::packed)
+        {
+            return std::span{m_vertices};
+        }
 
         return std::span{&m_buffer->get<vertex>(1), static_cast<std::size_t>(m_vertex_count)};
     }
@@ -259,6 +288,11 @@ public:
 
     std::span<const vertex> cvertices() const noexcept
     {
+        if(m_vertex_format == cpt::vertex_format::packed)
+        {
+            return std::span{m_vertices};
+        }
+
         return std::span{&m_buffer->get<const vertex>(1), static_cast<std::size_t>(m_vertex_count)};
     }
 
@@ -267,6 +301,7 @@ public:
         assert(m_index_count > 0 && "cpt::basic_renderable::get_indices called on basic_renderable with no index buffer");
 
         m_upload_indices = true;
+        touch_scene();
 
         return std::span{&m_buffer->get<std::uint32_t>(2), static_cast<std::size_t>(m_index_count)};
     }
@@ -292,27 +327,34 @@ public:
     }
 #endif
 
+    //Memory of the per render layout descriptor set entries of all renderables
+    static slab_pool& descriptor_set_pool();
+
 private:
     struct descriptor_set_data
     {
-        descriptor_set_ptr set{};
-        std::vector<asynchronous_resource_ptr> to_keep{};
+        shared_descriptor_set_ptr set{};
+        std::vector<std::uint32_t> dynamic_offsets{};
         std::uint32_t epoch{};
+        std::uint64_t relocation{};
     };
 
 private:
-    using descriptor_set_map = std::map<render_layout_weak_ptr, descriptor_set_data, std::owner_less<render_layout_weak_ptr>>;
+    using descriptor_set_map_value = std::pair<const render_layout_weak_ptr, descriptor_set_data>;
+    using descriptor_set_map = std::map<render_layout_weak_ptr, descriptor_set_data, std::owner_less<render_layout_weak_ptr>, pool_allocator<descriptor_set_map_value>>;
 
 private:
     binding_buffer m_bindings{};
     push_constants_buffer m_push_constants{};
-    descriptor_set_map m_sets{};
+    descriptor_set_map m_sets{descriptor_set_map::allocator_type{descriptor_set_pool()}};
     uniform_buffer* m_buffer{};
 
     std::uint32_t m_vertex_count{};
     std::uint32_t m_index_count{};
     std::uint32_t m_uniform_index{};
     std::uint32_t m_descriptors_epoch{};
+    cpt::vertex_format m_vertex_format{};
+    std::vector<vertex> m_vertices{}; //Only used by packed renderables
 
     vec3f m_position{};
     vec3f m_origin{};
@@ -336,6 +378,7 @@ public:
     explicit sprite(std::uint32_t width, std::uint32_t height, const color& color = colors::white);
     explicit sprite(texture_ptr texture, const color& color = colors::white);
     explicit sprite(std::uint32_t width, std::uint32_t height, texture_ptr texture, const color& color = colors::white);
+    explicit sprite(const texture_region& region, const color& color = colors::white);
 
     ~sprite() = default;
     sprite(const sprite&) = delete;
@@ -344,6 +387,8 @@ public:
     sprite& operator=(sprite&&) noexcept = default;
 
     void set_texture(texture_ptr texture);
+    //Binds the atlas page and maps the texture coordinates on the region
+    void set_texture(const texture_region& region);
     void set_color(const color& color) noexcept;
 
     void set_texture_coords(std::int32_t x1, std::int32_t y1, std::int32_t x2, std::int32_t y2) noexcept;
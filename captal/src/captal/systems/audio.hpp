@@ -27,6 +27,8 @@
 
 #include <entt/entity/registry.hpp>
 
+#include <captal_foundation/profiler.hpp>
+
 #include "../engine.hpp"
 
 #include "../components/node.hpp"
@@ -38,6 +40,8 @@ namespace cpt::systems
 
 inline void audio(entt::registry& world)
 {
+    CAPTAL_PROFILE_SCOPE("cpt::systems::audio");
+
     const auto update_listener = [](const components::node& node)
     {
         if(node.is_updated())
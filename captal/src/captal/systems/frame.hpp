@@ -27,6 +27,8 @@
 
 #include <entt/entity/registry.hpp>
 
+#include <captal_foundation/profiler.hpp>
+
 #include "../components/node.hpp"
 
 namespace cpt::systems
@@ -34,6 +36,8 @@ namespace cpt::systems
 
 inline void end_frame(entt::registry& world)
 {
+    CAPTAL_PROFILE_SCOPE("cpt::systems::end_frame");
+
     world.view<components::node>().each([](components::node& node)
     {
         node.clear();
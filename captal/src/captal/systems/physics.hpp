@@ -27,6 +27,8 @@
 
 #include <entt/entity/registry.hpp>
 
+#include <captal_foundation/profiler.hpp>
+
 #include "../components/node.hpp"
 #include "../components/rigid_body.hpp"
 
@@ -35,6 +37,8 @@ namespace cpt::systems
 
 inline void physics(entt::registry& world)
 {
+    CAPTAL_PROFILE_SCOPE("cpt::systems::physics");
+
     world.view<components::node, const components::rigid_body>().each([](components::node& node, const components::rigid_body& body)
     {
         if(body && !body->sleeping())
@@ -49,6 +53,8 @@ inline void physics(entt::registry& world)
 
 inline void physics_floored(entt::registry& world)
 {
+    CAPTAL_PROFILE_SCOPE("cpt::systems::physics_floored");
+
     world.view<components::node, const components::rigid_body>().each([](components::node& node, const components::rigid_body& body)
     {
         if(body && !body->sleeping())
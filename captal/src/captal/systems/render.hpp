@@ -27,6 +27,8 @@
 
 #include <entt/entity/registry.hpp>
 
+#include <captal_foundation/profiler.hpp>
+
 #include <tephra/commands.hpp>
 
 #include "../components/node.hpp"
@@ -37,6 +39,7 @@
 #include "../view.hpp"
 #include "../render_window.hpp"
 #include "../renderable.hpp"
+#include "../scene_epoch.hpp"
 
 namespace cpt::systems
 {
@@ -44,6 +47,8 @@ namespace cpt::systems
 template<components::drawable_specialization Drawable = components::drawable>
 void prepare_render(entt::registry& world)
 {
+    CAPTAL_PROFILE_SCOPE("cpt::systems::prepare_render");
+
     const auto drawable_update = [](const components::node& node, Drawable& drawable)
     {
         if(drawable && node.is_updated())
@@ -76,13 +81,42 @@ void prepare_render(entt::registry& world)
 template<components::drawable_specialization Drawable = components::drawable>
 void render(entt::registry& world, cpt::begin_render_options options = cpt::begin_render_options::none)
 {
-    prepare_render<Drawable>(world);
+    CAPTAL_PROFILE_SCOPE("cpt::systems::render");
+
+    //Nothing visible changed since the last recording of any of the targets
+    bool changed{};
+    world.view<components::camera>().each([&changed](components::camera& camera)
+    {
+        if(camera && camera->target().recorded_epoch() != scene_epoch())
+        {
+            changed = true;
+        }
+    });
 
-    world.view<components::camera>().each([&world, options](components::camera& camera)
+    if(changed)
+    {
+        prepare_render<Drawable>(world);
+    }
+
+    //Read after prepare_render, which modifies the renderables of updated nodes
+    const auto epoch{scene_epoch()};
+
+    world.view<components::camera>().each([&world, options, epoch](components::camera& camera)
     {
         if(camera)
         {
-            auto render  {camera->target().begin_render(options)};
+            auto& target{camera->target()};
+
+            //Command buffers of unchanged targets are submitted again as is
+            const bool target_changed{target.recorded_epoch() != epoch};
+            auto render{target.begin_render(target_changed ? options | begin_render_options::reset : options)};
+            target.set_recorded_epoch(epoch);
+
+            if(!render && !target_changed)
+            {
+                return;
+            }
+
             auto transfer{engine::instance().begin_transfer()};
 
             if(render)
@@ -27,6 +27,8 @@
 
 #include <entt/entity/registry.hpp>
 
+#include <captal_foundation/profiler.hpp>
+
 #include "../components/node.hpp"
 #include "../components/drawable.hpp"
 #include "../components/draw_index.hpp"
@@ -37,6 +39,8 @@ namespace cpt::systems
 template<components::drawable_specialization Drawable = components::drawable>
 void z_sorting(entt::registry& world)
 {
+    CAPTAL_PROFILE_SCOPE("cpt::systems::z_sorting");
+
     world.sort<components::node>([](const components::node& left, const components::node& right) -> bool
     {
         const vec3f left_position{left.position() - left.origin()};
@@ -51,6 +55,8 @@ void z_sorting(entt::registry& world)
 template<components::drawable_specialization Drawable = components::drawable>
 void index_sorting(entt::registry& world)
 {
+    CAPTAL_PROFILE_SCOPE("cpt::systems::index_sorting");
+
     world.sort<components::draw_index>([](components::draw_index left, components::draw_index right) -> bool
     {
         return left.index < right.index;
@@ -62,6 +68,8 @@ void index_sorting(entt::registry& world)
 template<components::drawable_specialization Drawable = components::drawable>
 void index_z_sorting(entt::registry& world)
 {
+    CAPTAL_PROFILE_SCOPE("cpt::systems::index_z_sorting");
+
     world.sort<components::node>([&world](entt::entity left, entt::entity right) -> bool
     {
         const auto left_draw_index {world.get<components::draw_index>(left)};
@@ -35,6 +35,7 @@
 
 #include <captal_foundation/utility.hpp>
 #include <captal_foundation/stack_allocator.hpp>
+#include <captal_foundation/profiler.hpp>
 
 #include "external/pugixml.hpp"
 
@@ -179,7 +180,7 @@ static std::uint64_t adjust(subpixel_adjustment adjustment, float x) noexcept
     return static_cast<std::uint64_t>(shift) % 64;
 }
 
-static void add_glyph(std::vector<vertex>& vertices, float x, float y, float width, float height, const vec4f& color, vec2f texpos, vec2f texsize, bool flipped)
+static void add_glyph(frame_vector<vertex>& vertices, float x, float y, float width, float height, const vec4f& color, vec2f texpos, vec2f texsize, bool flipped)
 {
     if(flipped)
     {
@@ -197,7 +198,7 @@ static void add_glyph(std::vector<vertex>& vertices, float x, float y, float wid
     }
 }
 
-static void add_line(std::vector<vertex>& vertices, float x, float y, float width, float height, const vec4f& color, vec2f texpos, vec2f texsize, bool flipped)
+static void add_line(frame_vector<vertex>& vertices, float x, float y, float width, float height, const vec4f& color, vec2f texpos, vec2f texsize, bool flipped)
 {
     if(flipped)
     {
@@ -215,9 +216,9 @@ static void add_line(std::vector<vertex>& vertices, float x, float y, float widt
     }
 }
 
-static std::vector<std::uint32_t> generate_indices(std::size_t codepoint_count)
+static frame_vector<std::uint32_t> generate_indices(std::size_t codepoint_count)
 {
-    std::vector<std::uint32_t> indices{};
+    auto indices{make_frame_vector<std::uint32_t>()};
     indices.reserve(codepoint_count * 6);
 
     for(std::uint32_t i{}; i < codepoint_count; ++i)
@@ -310,6 +311,8 @@ text_bounds text_drawer::bounds(std::string_view string, std::uint32_t line_widt
 
 text text_drawer::draw(std::string_view string, std::uint32_t line_width)
 {
+    CAPTAL_PROFILE_SCOPE("cpt::text_drawer::draw");
+
     const auto outline   {static_cast<std::uint64_t>(m_outline * 64.0f)};
     const auto bold      {static_cast<bool>(m_style & text_style::bold)};
     const auto italic    {static_cast<bool>(m_style & text_style::italic)};
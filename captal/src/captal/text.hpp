@@ -25,6 +25,8 @@
 
 #include "config.hpp"
 
+#include <captal_foundation/frame_allocator.hpp>
+
 #include "color.hpp"
 #include "renderable.hpp"
 #include "font.hpp"
@@ -274,8 +276,8 @@ private:
         vec2f texture_size{};
         std::uint64_t base_key{};
         std::u32string_view codepoints{};
-        std::vector<vertex> vertices{};
-        std::vector<vertex> lines{};
+        frame_vector<vertex> vertices{&frame_memory()};
+        frame_vector<vertex> lines{&frame_memory()};
     };
 
     struct word_width_info
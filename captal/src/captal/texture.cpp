@@ -22,7 +22,15 @@
 
 #include "texture.hpp"
 
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <bit>
+#include <limits>
+
 #include "engine.hpp"
+#include "async_texture.hpp"
+#include "texture_container.hpp"
 
 namespace cpt
 {
@@ -60,12 +68,88 @@ static tph::image make_image(Args&&... args)
     return output;
 }
 
+std::uint32_t mip_level_count(std::uint32_t width, std::uint32_t height) noexcept
+{
+    return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+}
+
+//2x2 box filter, the last row/column is duplicated on odd sizes
+void downsample(const tph::pixel* source, std::uint32_t source_width, std::uint32_t source_height, tph::pixel* destination, std::uint32_t width, std::uint32_t height) noexcept
+{
+    for(std::uint32_t y{}; y < height; ++y)
+    {
+        const std::uint32_t y0{std::min(y * 2, source_height - 1)};
+        const std::uint32_t y1{std::min(y * 2 + 1, source_height - 1)};
+
+        for(std::uint32_t x{}; x < width; ++x)
+        {
+            const std::uint32_t x0{std::min(x * 2, source_width - 1)};
+            const std::uint32_t x1{std::min(x * 2 + 1, source_width - 1)};
+
+            const tph::pixel& p00{source[y0 * source_width + x0]};
+            const tph::pixel& p01{source[y0 * source_width + x1]};
+            const tph::pixel& p10{source[y1 * source_width + x0]};
+            const tph::pixel& p11{source[y1 * source_width + x1]};
+
+            const auto average = [&](std::uint8_t tph::pixel::* component)
+            {
+                return static_cast<std::uint8_t>((std::uint32_t{p00.*component} + p01.*component + p10.*component + p11.*component + 2) / 4);
+            };
+
+            destination[y * width + x] = tph::pixel{average(&tph::pixel::red), average(&tph::pixel::green), average(&tph::pixel::blue), average(&tph::pixel::alpha)};
+        }
+    }
+}
+
+static bool can_blit_mipmaps(tph::texture_format format)
+{
+    const auto features{tph::format_feature::blit_source | tph::format_feature::blit_destination | tph::format_feature::sampled_image_filter_linear};
+
+    return engine::instance().graphics_device().support_texture_format(format, features);
+}
+
 static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::texture_format format, tph::image image)
 {
     const tph::texture_info info{format, tph::texture_usage::sampled | tph::texture_usage::transfer_destination};
     texture_ptr texture{make_texture(sampling, static_cast<std::uint32_t>(image.width()), static_cast<std::uint32_t>(image.height()), info)};
 
-    auto&& [buffer, signal, keeper] = cpt::engine::instance().begin_transfer();
+    //The texture is not in use yet, it can be uploaded on the standalone transfer queue (if any)
+    auto&& [buffer, signal, keeper, ownership] = cpt::engine::instance().begin_transfer(transfer_queue::transfer);
+
+    tph::texture_memory_barrier barrier{texture->get_texture()};
+    barrier.source_access      = tph::resource_access::none;
+    barrier.destination_access = tph::resource_access::transfer_write;
+    barrier.old_layout         = tph::texture_layout::undefined;
+    barrier.new_layout         = tph::texture_layout::transfer_destination_optimal;
+
+    tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::top_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+
+    tph::image_texture_copy region{};
+    region.texture_size.width  = static_cast<std::uint32_t>(image.width());
+    region.texture_size.height = static_cast<std::uint32_t>(image.height());
+
+    tph::cmd::copy(buffer, image, texture->get_texture(), region);
+
+    barrier.source_access      = tph::resource_access::transfer_write;
+    barrier.destination_access = tph::resource_access::shader_read;
+    barrier.old_layout         = tph::texture_layout::transfer_destination_optimal;
+    barrier.new_layout         = tph::texture_layout::shader_read_only_optimal;
+
+    ownership.release(buffer, tph::pipeline_stage::fragment_shader, barrier);
+
+    signal.connect([memory = memory_tracking{memory_category::staging, memory_location::host, image.byte_size()}, image = std::move(image)](){});
+    keeper.keep(texture);
+
+    return texture;
+}
+
+//Blits need a graphics queue, so the whole upload is recorded on it
+static texture_ptr make_mipmapped_texture_gpu(const tph::sampler_info& sampling, tph::texture_format format, tph::image image, std::uint32_t level_count)
+{
+    const tph::texture_info info{format, tph::texture_usage::sampled | tph::texture_usage::transfer_destination | tph::texture_usage::transfer_source, level_count};
+    texture_ptr texture{make_texture(sampling, static_cast<std::uint32_t>(image.width()), static_cast<std::uint32_t>(image.height()), info)};
+
+    auto&& [buffer, signal, keeper, ownership] = cpt::engine::instance().begin_transfer(transfer_queue::graphics);
 
     tph::texture_memory_barrier barrier{texture->get_texture()};
     barrier.source_access      = tph::resource_access::none;
@@ -81,42 +165,141 @@ static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::tex
 
     tph::cmd::copy(buffer, image, texture->get_texture(), region);
 
+    const tph::mipmap_generation_info mipmaps
+    {
+        .texture            = texture->get_texture(),
+        .filter             = tph::filter::linear,
+        .source_access      = tph::resource_access::transfer_write,
+        .destination_access = tph::resource_access::shader_read,
+        .old_layout         = tph::texture_layout::transfer_destination_optimal,
+        .new_layout         = tph::texture_layout::shader_read_only_optimal
+    };
+
+    tph::cmd::generate_mipmaps(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::fragment_shader, tph::dependency_flags::none, std::span{&mipmaps, 1});
+
+    signal.connect([memory = memory_tracking{memory_category::staging, memory_location::host, image.byte_size()}, image = std::move(image)](){});
+    keeper.keep(texture);
+
+    return texture;
+}
+
+//Fallback for formats without linear blit support, the chain is built in a staging buffer
+static texture_ptr make_mipmapped_texture_cpu(const tph::sampler_info& sampling, tph::texture_format format, tph::image& image, std::uint32_t level_count)
+{
+    const auto width {static_cast<std::uint32_t>(image.width())};
+    const auto height{static_cast<std::uint32_t>(image.height())};
+
+    std::vector<std::uint64_t> offsets{};
+    offsets.reserve(level_count);
+
+    std::uint64_t total_size{};
+    for(std::uint32_t i{}; i < level_count; ++i)
+    {
+        offsets.emplace_back(total_size);
+        total_size += std::uint64_t{std::max(width >> i, 1u)} * std::max(height >> i, 1u) * sizeof(tph::pixel);
+    }
+
+    tph::buffer staging{engine::instance().renderer(), total_size, tph::buffer_usage::staging | tph::buffer_usage::transfer_source};
+
+    auto* const data{reinterpret_cast<tph::pixel*>(staging.map())};
+
+    image.map();
+    std::copy(std::begin(image), std::end(image), data);
+    image.unmap();
+
+    for(std::uint32_t i{1}; i < level_count; ++i)
+    {
+        downsample(data + offsets[i - 1] / sizeof(tph::pixel), std::max(width >> (i - 1), 1u), std::max(height >> (i - 1), 1u), data + offsets[i] / sizeof(tph::pixel), std::max(width >> i, 1u), std::max(height >> i, 1u));
+    }
+
+    staging.unmap();
+
+    const tph::texture_info info{format, tph::texture_usage::sampled | tph::texture_usage::transfer_destination, level_count};
+    texture_ptr texture{make_texture(sampling, width, height, info)};
+
+    auto&& [buffer, signal, keeper, ownership] = cpt::engine::instance().begin_transfer(transfer_queue::transfer);
+
+    tph::texture_memory_barrier barrier{texture->get_texture()};
+    barrier.subresource.mip_level_count = level_count;
+    barrier.source_access      = tph::resource_access::none;
+    barrier.destination_access = tph::resource_access::transfer_write;
+    barrier.old_layout         = tph::texture_layout::undefined;
+    barrier.new_layout         = tph::texture_layout::transfer_destination_optimal;
+
+    tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::top_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+
+    for(std::uint32_t i{}; i < level_count; ++i)
+    {
+        tph::buffer_texture_copy region{};
+        region.buffer_offset = offsets[i];
+        region.texture_subresource.mip_level = i;
+        region.texture_size.width  = std::max(width >> i, 1u);
+        region.texture_size.height = std::max(height >> i, 1u);
+
+        tph::cmd::copy(buffer, staging, texture->get_texture(), region);
+    }
+
     barrier.source_access      = tph::resource_access::transfer_write;
     barrier.destination_access = tph::resource_access::shader_read;
     barrier.old_layout         = tph::texture_layout::transfer_destination_optimal;
     barrier.new_layout         = tph::texture_layout::shader_read_only_optimal;
 
-    tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::fragment_shader, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+    ownership.release(buffer, tph::pipeline_stage::fragment_shader, barrier);
 
-    signal.connect([image = std::move(image)](){});
+    signal.connect([memory = memory_tracking{memory_category::staging, memory_location::host, staging.size()}, staging = std::move(staging)](){});
     keeper.keep(texture);
 
     return texture;
 }
 
-texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling, color_space space)
+static texture_ptr make_texture_impl(tph::sampler_info sampling, tph::texture_format format, tph::image image, texture_mipmaps mipmaps)
+{
+    const std::uint32_t level_count{mip_level_count(static_cast<std::uint32_t>(image.width()), static_cast<std::uint32_t>(image.height()))};
+
+    if(mipmaps == texture_mipmaps::none || level_count == 1)
+    {
+        return make_texture_impl(sampling, format, std::move(image));
+    }
+
+    sampling.min_lod = 0.0f;
+    sampling.max_lod = static_cast<float>(level_count);
+
+    if(can_blit_mipmaps(format))
+    {
+        return make_mipmapped_texture_gpu(sampling, format, std::move(image), level_count);
+    }
+
+    return make_mipmapped_texture_cpu(sampling, format, image, level_count);
+}
+
+texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(file));
+    if(is_texture_container(file)) //Mip levels come from the file
+    {
+        return make_texture_from_container(file, sampling, space);
+    }
+
+    return make_texture_impl(sampling, format_from_color_space(space), make_image(file), mipmaps);
 }
 
-texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(data));
+    return make_texture_impl(sampling, format_from_color_space(space), make_image(data), mipmaps);
 }
 
-texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(stream));
+    return make_texture_impl(sampling, format_from_color_space(space), make_image(stream), mipmaps);
 }
 
-texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(width, height, rgba));
+    return make_texture_impl(sampling, format_from_color_space(space), make_image(width, height, rgba), mipmaps);
 }
 
-texture_ptr make_texture(tph::image&& image, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(tph::image&& image, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), std::move(image));
+    return make_texture_impl(sampling, format_from_color_space(space), std::move(image), mipmaps);
 }
 
 tph::renderer& texture::get_renderer() noexcept
@@ -136,6 +319,17 @@ cpt::texture_ptr texture_pool::default_load_callback(const std::filesystem::path
     return output;
 }
 
+cpt::texture_ptr texture_pool::mipmapped_load_callback(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space)
+{
+    auto output{make_texture(path, sampling, space, texture_mipmaps::generate)};
+
+#ifdef CAPTAL_DEBUG
+   output->set_name(convert_to<narrow>(path.u8string()));
+#endif
+
+    return output;
+}
+
 texture_pool::texture_pool()
 :m_load_callback{default_load_callback}
 {
@@ -148,24 +342,57 @@ texture_pool::texture_pool(load_callback_t load_callback)
 
 }
 
+texture_pool::~texture_pool()
+{
+    std::unique_lock lock{m_mutex};
+    m_stop = true;
+    lock.unlock();
+
+    m_condition.notify_all();
+
+    //Pending decodings are abandoned, their textures end up failed
+    for(auto& thread : m_decoders)
+    {
+        thread.join();
+    }
+}
+
 cpt::texture_ptr texture_pool::load(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space)
 {
-    return load(path, m_load_callback, sampling, space);
+    std::unique_lock lock{m_mutex};
+    const auto callback{m_load_callback};
+    lock.unlock();
+
+    return load(path, callback, sampling, space);
 }
 
 cpt::texture_ptr texture_pool::load(const std::filesystem::path& path, const load_callback_t& load_callback, const tph::sampler_info& sampling, color_space space)
 {
-    const auto it{m_pool.find(path)};
-    if(it != std::end(m_pool))
+    std::unique_lock lock{m_mutex};
+
+    if(const auto it{m_pool.find(path)}; it != std::end(m_pool))
     {
         return it->second;
     }
 
-    return m_pool.emplace(std::make_pair(path, load_callback(path, sampling, space))).first->second;
+    if(const auto it{m_async_pool.find(path)}; it != std::end(m_async_pool) && it->second->is_ready())
+    {
+        return it->second->texture();
+    }
+
+    //The callback may be slow, don't block other threads meanwhile
+    lock.unlock();
+    auto texture{load_callback(path, sampling, space)};
+    lock.lock();
+
+    //Another thread may have loaded the same texture in the meantime
+    return m_pool.emplace(std::make_pair(path, std::move(texture))).first->second;
 }
 
 cpt::texture_weak_ptr texture_pool::weak_load(const std::filesystem::path& path) const
 {
+    std::lock_guard lock{m_mutex};
+
     const auto it{m_pool.find(path)};
     if(it != std::end(m_pool))
     {
@@ -177,13 +404,122 @@ cpt::texture_weak_ptr texture_pool::weak_load(const std::filesystem::path& path)
 
 std::pair<cpt::texture_ptr, bool> texture_pool::emplace(std::filesystem::path path, texture_ptr texture)
 {
+    std::lock_guard lock{m_mutex};
+
     auto [it, success] = m_pool.emplace(std::make_pair(std::move(path), std::move(texture)));
 
     return std::make_pair(it->second, success);
 }
 
+cpt::async_texture_ptr texture_pool::load_async(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
+{
+    std::lock_guard lock{m_mutex};
+
+    if(const auto it{m_async_pool.find(path)}; it != std::end(m_async_pool))
+    {
+        return it->second;
+    }
+
+    if(const auto it{m_pool.find(path)}; it != std::end(m_pool))
+    {
+        return m_async_pool.emplace(std::make_pair(path, std::make_shared<async_texture>(it->second))).first->second;
+    }
+
+    if(!m_placeholder)
+    {
+        const std::array<std::uint8_t, 4> white{255, 255, 255, 255};
+        m_placeholder = make_texture(1, 1, std::data(white));
+    }
+
+    //Asynchronous textures build their mip chain while decoding, up to the sampler max LOD
+    auto decode_sampling{sampling};
+    if(mipmaps == texture_mipmaps::generate)
+    {
+        decode_sampling.min_lod = 0.0f;
+        decode_sampling.max_lod = std::numeric_limits<float>::max();
+    }
+
+    std::promise<async_texture::decoded_data> promise{};
+    auto output{std::make_shared<async_texture>(path, promise.get_future(), m_placeholder)};
+
+    m_decode_queue.emplace_back([path, sampling = decode_sampling, space, promise = std::move(promise)]() mutable
+    {
+        try
+        {
+            promise.set_value(async_texture::decode(path, sampling, space));
+        }
+        catch(...)
+        {
+            promise.set_exception(std::current_exception());
+        }
+    });
+
+    if(std::empty(m_decoders))
+    {
+        for(std::size_t i{}; i < m_decoder_count; ++i)
+        {
+            m_decoders.emplace_back(&texture_pool::decode_worker, this);
+        }
+    }
+
+    m_condition.notify_one();
+
+    engine::instance().stream_texture(output);
+
+    return m_async_pool.emplace(std::make_pair(path, std::move(output))).first->second;
+}
+
+texture_loading_progress texture_pool::progress() const
+{
+    std::lock_guard lock{m_mutex};
+
+    texture_loading_progress output{};
+    output.total = std::size(m_async_pool);
+
+    for(auto&& [path, texture] : m_async_pool)
+    {
+        if(texture->status() == async_texture_status::ready)
+        {
+            ++output.ready;
+        }
+        else if(texture->status() == async_texture_status::failed)
+        {
+            ++output.failed;
+        }
+    }
+
+    return output;
+}
+
+void texture_pool::decode_worker()
+{
+    std::unique_lock lock{m_mutex};
+
+    while(true)
+    {
+        m_condition.wait(lock, [this]()
+        {
+            return m_stop || !std::empty(m_decode_queue);
+        });
+
+        if(m_stop)
+        {
+            return;
+        }
+
+        auto task{std::move(m_decode_queue.front())};
+        m_decode_queue.pop_front();
+
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
 void texture_pool::clear(std::size_t threshold)
 {
+    std::lock_guard lock{m_mutex};
+
     auto it = std::begin(m_pool);
     while(it != std::end(m_pool))
     {
@@ -196,19 +532,31 @@ void texture_pool::clear(std::size_t threshold)
             ++it;
         }
     }
+
+    //Textures still streaming are also referenced by the engine, so they are kept
+    std::erase_if(m_async_pool, [threshold](const auto& pair)
+    {
+        return static_cast<std::size_t>(pair.second.use_count()) <= threshold;
+    });
 }
 
 void texture_pool::remove(const std::filesystem::path& path)
 {
+    std::lock_guard lock{m_mutex};
+
     const auto it{m_pool.find(path)};
     if(it != std::end(m_pool))
     {
         m_pool.erase(it);
     }
+
+    m_async_pool.erase(path);
 }
 
 void texture_pool::remove(const texture_ptr& texture)
 {
+    std::lock_guard lock{m_mutex};
+
     const auto predicate = [&texture](const std::pair<std::filesystem::path, texture_ptr>& pair)
     {
         return pair.second == texture;
@@ -219,6 +567,11 @@ void texture_pool::remove(const texture_ptr& texture)
     {
         m_pool.erase(it);
     }
+
+    std::erase_if(m_async_pool, [&texture](const auto& pair)
+    {
+        return pair.second->is_ready() && pair.second->texture() == texture;
+    });
 }
 
 }
@@ -31,6 +31,14 @@
 #include <istream>
 #include <memory>
 #include <functional>
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
 
 #include <tephra/image.hpp>
 #include <tephra/texture.hpp>
@@ -38,6 +46,7 @@
 #include <captal_foundation/math.hpp>
 
 #include "asynchronous_resource.hpp"
+#include "memory_statistics.hpp"
 
 namespace cpt
 {
@@ -48,6 +57,12 @@ enum class color_space : std::uint32_t
     linear = 1
 };
 
+enum class texture_mipmaps : std::uint32_t
+{
+    none = 0,
+    generate = 1 //Full chain built on the GPU after upload (CPU box filter if the format can not be blitted), sampler LOD range is set to match
+};
+
 class CAPTAL_API texture : public asynchronous_resource
 {
 public:
@@ -178,6 +193,17 @@ public:
         return m_sampler;
     }
 
+    //Textures are accounted as memory_category::texture by default
+    void set_memory_category(cpt::memory_category category) noexcept
+    {
+        m_memory.set_category(category);
+    }
+
+    cpt::memory_category memory_category() const noexcept
+    {
+        return m_memory.category();
+    }
+
 #ifdef CAPTAL_DEBUG
     void set_name(std::string_view name);
 #else
@@ -194,23 +220,47 @@ private:
     tph::texture m_texture{};
     tph::texture_view m_texture_view{};
     tph::sampler m_sampler{};
+    memory_tracking m_memory{cpt::memory_category::texture, memory_location::device, m_texture.memory_size()};
 };
 
 using texture_ptr = std::shared_ptr<texture>;
 using texture_weak_ptr = std::weak_ptr<texture>;
 
+class async_texture;
+using async_texture_ptr = std::shared_ptr<async_texture>;
+using async_texture_weak_ptr = std::weak_ptr<async_texture>;
+
 template<typename... Args> requires std::constructible_from<texture, Args...>
 texture_ptr make_texture(Args&&... args)
 {
     return std::make_shared<texture>(std::forward<Args>(args)...);
 }
 
-CAPTAL_API texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(tph::image&& image, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
+CAPTAL_API texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+CAPTAL_API texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+CAPTAL_API texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+CAPTAL_API texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+CAPTAL_API texture_ptr make_texture(tph::image&& image, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+
+//Number of levels of a full mip chain
+CAPTAL_API std::uint32_t mip_level_count(std::uint32_t width, std::uint32_t height) noexcept;
+//2x2 box filter from a mip level to the next one, the last row/column is duplicated on odd sizes
+CAPTAL_API void downsample(const tph::pixel* source, std::uint32_t source_width, std::uint32_t source_height, tph::pixel* destination, std::uint32_t width, std::uint32_t height) noexcept;
+
+struct texture_loading_progress
+{
+    std::size_t total{};
+    std::size_t ready{};
+    std::size_t failed{};
+
+    bool done() const noexcept
+    {
+        return ready + failed == total;
+    }
+};
 
+//All member functions are thread-safe.
+//Asynchronous loads are decoded by a few threads owned by the pool, started on the first call to load_async.
 class CAPTAL_API texture_pool
 {
     struct path_hash
@@ -223,6 +273,8 @@ class CAPTAL_API texture_pool
 
 public:
     static cpt::texture_ptr default_load_callback(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space);
+    //Same as default_load_callback, with texture_mipmaps::generate
+    static cpt::texture_ptr mipmapped_load_callback(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space);
 
 public:
     using load_callback_t = std::function<cpt::texture_ptr(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space)>;
@@ -231,22 +283,29 @@ public:
     texture_pool();
     explicit texture_pool(load_callback_t load_callback);
 
-    ~texture_pool() = default;
+    ~texture_pool();
     texture_pool(const texture_pool&) = delete;
-    texture_pool& operator=(const texture_pool&) = default;
-    texture_pool(texture_pool&&) noexcept = default;
-    texture_pool& operator=(texture_pool&&) noexcept = default;
+    texture_pool& operator=(const texture_pool&) = delete;
+    texture_pool(texture_pool&&) noexcept = delete;
+    texture_pool& operator=(texture_pool&&) noexcept = delete;
 
     cpt::texture_ptr load(const std::filesystem::path& path, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
     cpt::texture_ptr load(const std::filesystem::path& path, const load_callback_t& load_callback, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
     cpt::texture_weak_ptr weak_load(const std::filesystem::path& path) const;
     std::pair<cpt::texture_ptr, bool> emplace(std::filesystem::path path, texture_ptr texture);
 
+    //Returns immediately, the handle shows the placeholder until the texture is fully uploaded.
+    //Concurrent calls for the same path return the same handle.
+    cpt::async_texture_ptr load_async(const std::filesystem::path& path, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+    texture_loading_progress progress() const;
+
     void clear(std::size_t threshold = 1);
 
     template<typename Predicate>
     void clear_if(Predicate predicate)
     {
+        std::lock_guard lock{m_mutex};
+
         auto it = std::begin(m_pool);
         while(it != std::end(m_pool))
         {
@@ -266,17 +325,46 @@ public:
 
     void set_load_callback(load_callback_t new_callback)
     {
+        std::lock_guard lock{m_mutex};
+
         m_load_callback = std::move(new_callback);
     }
 
+    //Shared by all asynchronous loads, a 1x1 white texture is created if none is set
+    void set_placeholder(texture_ptr placeholder)
+    {
+        std::lock_guard lock{m_mutex};
+
+        m_placeholder = std::move(placeholder);
+    }
+
+    //Only affects decoding threads that are not started yet
+    void set_decoder_count(std::size_t count)
+    {
+        std::lock_guard lock{m_mutex};
+
+        m_decoder_count = std::max(count, std::size_t{1});
+    }
+
     const load_callback_t& load_callback() const noexcept
     {
         return m_load_callback;
     }
 
+private:
+    void decode_worker();
+
 private:
     std::unordered_map<std::filesystem::path, texture_ptr, path_hash> m_pool{};
+    std::unordered_map<std::filesystem::path, async_texture_ptr, path_hash> m_async_pool{};
     load_callback_t m_load_callback{};
+    texture_ptr m_placeholder{};
+    std::size_t m_decoder_count{std::max(std::thread::hardware_concurrency(), 2u) - 1};
+    std::deque<std::packaged_task<void()>> m_decode_queue{};
+    std::vector<std::thread> m_decoders{};
+    bool m_stop{};
+    mutable std::mutex m_mutex{};
+    std::condition_variable m_condition{};
 };
 
 class CAPTAL_API tileset
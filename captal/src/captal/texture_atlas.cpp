@@ -0,0 +1,299 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "texture_atlas.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <bit>
+
+#include <tephra/commands.hpp>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+static constexpr std::uint32_t initial_page_size{256};
+
+static tph::texture_format format_from_color_space(color_space space) noexcept
+{
+    switch(space)
+    {
+        case color_space::srgb:   return tph::texture_format::r8g8b8a8_srgb;
+        case color_space::linear: return tph::texture_format::r8g8b8a8_unorm;
+        default: std::terminate();
+    }
+}
+
+texture_atlas::texture_atlas(const tph::sampler_info& sampling, color_space space, std::uint32_t page_size)
+:m_sampling{sampling}
+,m_space{space}
+,m_page_size{std::min(page_size, engine::instance().graphics_device().limits().max_2d_texture_size)}
+{
+
+}
+
+texture_atlas_handle texture_atlas::add(const std::filesystem::path& file)
+{
+    return add(tph::image{engine::instance().renderer(), file, tph::image_usage::none});
+}
+
+texture_atlas_handle texture_atlas::add(std::span<const std::uint8_t> data)
+{
+    return add(tph::image{engine::instance().renderer(), data, tph::image_usage::none});
+}
+
+texture_atlas_handle texture_atlas::add(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba)
+{
+    return add(tph::image{engine::instance().renderer(), width, height, rgba, tph::image_usage::none});
+}
+
+texture_atlas_handle texture_atlas::add(tph::image image)
+{
+    const texture_atlas_handle handle{std::size(m_regions)};
+
+    m_regions.emplace_back();
+    m_pending.emplace_back(pending_image{handle, std::move(image)});
+
+    return handle;
+}
+
+void texture_atlas::build()
+{
+    const std::uint32_t padding{has_padding() ? 2u : 0u};
+    const std::uint32_t max_size{engine::instance().graphics_device().limits().max_2d_texture_size};
+
+    //Biggest images first, the packer wastes less space this way
+    std::vector<pending_image*> images{};
+    images.reserve(std::size(m_pending));
+
+    for(auto& image : m_pending)
+    {
+        images.emplace_back(&image);
+    }
+
+    std::stable_sort(std::begin(images), std::end(images), [](const pending_image* left, const pending_image* right)
+    {
+        return std::max(left->image.width(), left->image.height()) > std::max(right->image.width(), right->image.height());
+    });
+
+    std::vector<page> pages{};
+
+    for(auto* image : images)
+    {
+        const auto it{std::find_if(std::begin(pages), std::end(pages), [this, image](page& page)
+        {
+            return place(page, *image);
+        })};
+
+        if(it == std::end(pages))
+        {
+            const auto image_size{static_cast<std::uint32_t>(std::max(image->image.width(), image->image.height())) + padding};
+            if(image_size > max_size)
+            {
+                throw std::runtime_error{"Image is too big to fit in a texture atlas page."};
+            }
+
+            //Images bigger than the page size get their own page
+            const auto size{std::min(std::max(std::bit_ceil(image_size), initial_page_size), std::max(m_page_size, image_size))};
+
+            auto& new_page{pages.emplace_back(page{bin_packer{size, size}})};
+            [[maybe_unused]] const bool placed{place(new_page, *image)};
+            assert(placed && "cpt::texture_atlas::build failed to place an image in an empty page.");
+        }
+    }
+
+    for(auto& page : pages)
+    {
+        upload(page);
+    }
+
+    m_pending.clear();
+}
+
+#ifdef CAPTAL_DEBUG
+void texture_atlas::set_name(std::string_view name)
+{
+    m_name = name;
+
+    for(std::size_t i{}; i < std::size(m_pages); ++i)
+    {
+        m_pages[i]->set_name(m_name + " page " + std::to_string(i));
+    }
+}
+#endif
+
+bool texture_atlas::place(page& page, pending_image& image)
+{
+    const std::uint32_t padding{has_padding() ? 2u : 0u};
+    const auto width{static_cast<std::uint32_t>(image.image.width())};
+    const auto height{static_cast<std::uint32_t>(image.image.height())};
+
+    auto rect{page.packer.append(width + padding, height + padding)};
+    while(!rect.has_value())
+    {
+        const bool can_grow_width{page.packer.width() * 2 <= m_page_size};
+        const bool can_grow_height{page.packer.height() * 2 <= m_page_size};
+
+        if(!can_grow_width && !can_grow_height)
+        {
+            return false;
+        }
+
+        //Same growth pattern as font_atlas, the page stays roughly square
+        if((page.grow && can_grow_width) || !can_grow_height)
+        {
+            page.packer.grow(page.packer.width(), 0);
+            page.grow = false;
+        }
+        else
+        {
+            page.packer.grow(0, page.packer.height());
+            page.grow = true;
+        }
+
+        rect = page.packer.append(width + padding, height + padding);
+    }
+
+    rect->x += padding / 2;
+    rect->y += padding / 2;
+    rect->width -= padding;
+    rect->height -= padding;
+
+    auto& region{m_regions[image.handle]};
+    region.rect = *rect;
+    region.flipped = rect->width != width;
+
+    page.images.emplace_back(&image);
+
+    return true;
+}
+
+void texture_atlas::upload(page& page)
+{
+    const std::uint32_t padding{has_padding() ? 1u : 0u};
+
+    std::uint64_t total_size{};
+    for(auto* image : page.images)
+    {
+        const auto& rect{m_regions[image->handle].rect};
+
+        total_size += std::uint64_t{rect.width + padding * 2} * (rect.height + padding * 2) * sizeof(tph::pixel);
+    }
+
+    tph::buffer staging{engine::instance().renderer(), total_size, tph::buffer_usage::staging | tph::buffer_usage::transfer_source};
+    auto* const data{reinterpret_cast<tph::pixel*>(staging.map())};
+
+    std::vector<tph::buffer_texture_copy> copies{};
+    copies.reserve(std::size(page.images));
+
+    std::uint64_t offset{};
+    for(auto* image : page.images)
+    {
+        const auto& region{m_regions[image->handle]};
+        const auto image_width{static_cast<std::uint32_t>(image->image.width())};
+        const auto cell_width{region.rect.width + padding * 2};
+        const auto cell_height{region.rect.height + padding * 2};
+
+        //The padding is filled with the border of the image, so linear filtering does not bleed neighbours in
+        image->image.map();
+
+        auto* const cell{data + offset / sizeof(tph::pixel)};
+        for(std::uint32_t y{}; y < cell_height; ++y)
+        {
+            const auto region_y{std::clamp(static_cast<std::int64_t>(y) - padding, std::int64_t{0}, static_cast<std::int64_t>(region.rect.height) - 1)};
+
+            for(std::uint32_t x{}; x < cell_width; ++x)
+            {
+                const auto region_x{std::clamp(static_cast<std::int64_t>(x) - padding, std::int64_t{0}, static_cast<std::int64_t>(region.rect.width) - 1)};
+
+                const auto source_x{region.flipped ? region_y : region_x};
+                const auto source_y{region.flipped ? region_x : region_y};
+
+                cell[y * cell_width + x] = image->image.data()[source_y * image_width + source_x];
+            }
+        }
+
+        image->image.unmap();
+
+        tph::buffer_texture_copy copy{};
+        copy.buffer_offset = offset;
+        copy.buffer_image_width = cell_width;
+        copy.buffer_image_height = cell_height;
+        copy.texture_offset.x = static_cast<std::int32_t>(region.rect.x - padding);
+        copy.texture_offset.y = static_cast<std::int32_t>(region.rect.y - padding);
+        copy.texture_size.width = cell_width;
+        copy.texture_size.height = cell_height;
+        copy.texture_size.depth = 1;
+
+        copies.emplace_back(copy);
+
+        offset += std::uint64_t{cell_width} * cell_height * sizeof(tph::pixel);
+    }
+
+    staging.unmap();
+
+    const tph::texture_info info{format_from_color_space(m_space), tph::texture_usage::sampled | tph::texture_usage::transfer_destination};
+    texture_ptr texture{make_texture(m_sampling, page.packer.width(), page.packer.height(), info)};
+
+#ifdef CAPTAL_DEBUG
+    if(!std::empty(m_name))
+    {
+        texture->set_name(m_name + " page " + std::to_string(std::size(m_pages)));
+    }
+#endif
+
+    //Pages are new textures, they can be uploaded on the standalone transfer queue (if any)
+    auto&& [buffer, signal, keeper, ownership] = engine::instance().begin_transfer(transfer_queue::transfer);
+
+    tph::texture_memory_barrier barrier{texture->get_texture()};
+    barrier.source_access      = tph::resource_access::none;
+    barrier.destination_access = tph::resource_access::transfer_write;
+    barrier.old_layout         = tph::texture_layout::undefined;
+    barrier.new_layout         = tph::texture_layout::transfer_destination_optimal;
+
+    tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::top_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+
+    tph::cmd::copy(buffer, staging, texture->get_texture(), copies);
+
+    barrier.source_access      = tph::resource_access::transfer_write;
+    barrier.destination_access = tph::resource_access::shader_read;
+    barrier.old_layout         = tph::texture_layout::transfer_destination_optimal;
+    barrier.new_layout         = tph::texture_layout::shader_read_only_optimal;
+
+    ownership.release(buffer, tph::pipeline_stage::fragment_shader, barrier);
+
+    signal.connect([memory = memory_tracking{memory_category::staging, memory_location::host, staging.size()}, staging = std::move(staging)](){});
+    keeper.keep(texture);
+
+    for(auto* image : page.images)
+    {
+        m_regions[image->handle].texture = texture;
+    }
+
+    m_pages.emplace_back(std::move(texture));
+}
+
+}
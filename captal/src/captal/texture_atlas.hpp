@@ -0,0 +1,144 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_TEXTURE_ATLAS_HPP_INCLUDED
+#define CAPTAL_TEXTURE_ATLAS_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <filesystem>
+#include <vector>
+#include <span>
+#include <string_view>
+
+#include <tephra/image.hpp>
+#include <tephra/texture.hpp>
+
+#include "texture.hpp"
+#include "bin_packing.hpp"
+
+namespace cpt
+{
+
+//A part of an atlas page. Flipped regions store the image transposed, the packer may rotate images to fit them.
+struct texture_region
+{
+    texture_ptr texture{};
+    bin_packer::rect rect{};
+    bool flipped{};
+};
+
+using texture_atlas_handle = std::size_t;
+
+//Packs many small images in a few big textures, so sprites using them can share the same descriptor set.
+//Images are added first, then packed and uploaded all at once by build(). Pages are never modified after build():
+//images added later go in new pages on the next call to build().
+class CAPTAL_API texture_atlas
+{
+public:
+    static constexpr std::uint32_t default_page_size{2048};
+
+public:
+    texture_atlas() = default;
+    explicit texture_atlas(const tph::sampler_info& sampling, color_space space = color_space::srgb, std::uint32_t page_size = default_page_size);
+
+    ~texture_atlas() = default;
+    texture_atlas(const texture_atlas&) = delete;
+    texture_atlas& operator=(const texture_atlas&) = delete;
+    texture_atlas(texture_atlas&&) noexcept = default;
+    texture_atlas& operator=(texture_atlas&&) noexcept = default;
+
+    texture_atlas_handle add(const std::filesystem::path& file);
+    texture_atlas_handle add(std::span<const std::uint8_t> data);
+    texture_atlas_handle add(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba);
+    texture_atlas_handle add(tph::image image);
+
+    void build();
+
+    //The texture of the region is null until build() is called
+    const texture_region& region(texture_atlas_handle handle) const noexcept
+    {
+        return m_regions[handle];
+    }
+
+    std::span<const texture_ptr> pages() const noexcept
+    {
+        return m_pages;
+    }
+
+    std::size_t region_count() const noexcept
+    {
+        return std::size(m_regions);
+    }
+
+    bool need_build() const noexcept
+    {
+        return !std::empty(m_pending);
+    }
+
+    bool has_padding() const noexcept
+    {
+        return m_sampling.mag_filter != tph::filter::nearest || m_sampling.min_filter != tph::filter::nearest;
+    }
+
+#ifdef CAPTAL_DEBUG
+    void set_name(std::string_view name);
+#else
+    void set_name(std::string_view name [[maybe_unused]]) const noexcept
+    {
+
+    }
+#endif
+
+private:
+    struct pending_image
+    {
+        texture_atlas_handle handle{};
+        tph::image image{};
+    };
+
+    struct page
+    {
+        bin_packer packer{};
+        std::vector<pending_image*> images{};
+        bool grow{};
+    };
+
+private:
+    bool place(page& page, pending_image& image);
+    void upload(page& page);
+
+private:
+    tph::sampler_info m_sampling{};
+    color_space m_space{color_space::srgb};
+    std::uint32_t m_page_size{default_page_size};
+    std::vector<texture_region> m_regions{};
+    std::vector<pending_image> m_pending{};
+    std::vector<texture_ptr> m_pages{};
+#ifdef CAPTAL_DEBUG
+    std::string m_name{};
+#endif
+};
+
+}
+
+#endif
@@ -0,0 +1,559 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "texture_container.hpp"
+
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+static constexpr std::array<std::uint8_t, 12> ktx2_identifier{0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+static constexpr std::uint32_t dds_magic{0x20534444}; //"DDS "
+
+static constexpr std::uint32_t make_fourcc(char a, char b, char c, char d) noexcept
+{
+    return static_cast<std::uint32_t>(a) | (static_cast<std::uint32_t>(b) << 8) | (static_cast<std::uint32_t>(c) << 16) | (static_cast<std::uint32_t>(d) << 24);
+}
+
+template<typename T>
+static T read_value(std::istream& stream)
+{
+    T output{};
+    if(!stream.read(reinterpret_cast<char*>(&output), sizeof(T)))
+    {
+        throw std::runtime_error{"Can not read texture container, unexpected end of file."};
+    }
+
+    return output; //Both formats are little endian
+}
+
+struct block_info
+{
+    std::uint32_t width{};
+    std::uint32_t height{};
+    std::uint32_t size{};
+};
+
+struct format_blocks
+{
+    tph::texture_format first{};
+    tph::texture_format last{};
+    block_info block{};
+};
+
+//Formats of each range have the same block, ranges follow the order of VkFormat values
+static constexpr std::array format_block_ranges
+{
+    format_blocks{tph::texture_format::r4g4_unorm_pack,           tph::texture_format::r4g4_unorm_pack,          block_info{1, 1, 1}},
+    format_blocks{tph::texture_format::r4g4b4a4_unorm_pack,       tph::texture_format::a1r5g5b5_unorm_pack,      block_info{1, 1, 2}},
+    format_blocks{tph::texture_format::r8_unorm,                  tph::texture_format::r8_srgb,                  block_info{1, 1, 1}},
+    format_blocks{tph::texture_format::r8g8_unorm,                tph::texture_format::r8g8_srgb,                block_info{1, 1, 2}},
+    format_blocks{tph::texture_format::r8g8b8_unorm,              tph::texture_format::b8g8r8_srgb,              block_info{1, 1, 3}},
+    format_blocks{tph::texture_format::r8g8b8a8_unorm,            tph::texture_format::a2b10g10r10_sint_pack,    block_info{1, 1, 4}},
+    format_blocks{tph::texture_format::r16_unorm,                 tph::texture_format::r16_sfloat,               block_info{1, 1, 2}},
+    format_blocks{tph::texture_format::r16g16_unorm,              tph::texture_format::r16g16_sfloat,            block_info{1, 1, 4}},
+    format_blocks{tph::texture_format::r16g16b16_unorm,           tph::texture_format::r16g16b16_sfloat,         block_info{1, 1, 6}},
+    format_blocks{tph::texture_format::r16g16b16a16_unorm,        tph::texture_format::r16g16b16a16_sfloat,      block_info{1, 1, 8}},
+    format_blocks{tph::texture_format::r32_uint,                  tph::texture_format::r32_sfloat,               block_info{1, 1, 4}},
+    format_blocks{tph::texture_format::r32g32_uint,               tph::texture_format::r32g32_sfloat,            block_info{1, 1, 8}},
+    format_blocks{tph::texture_format::r32g32b32_uint,            tph::texture_format::r32g32b32_sfloat,         block_info{1, 1, 12}},
+    format_blocks{tph::texture_format::r32g32b32a32_uint,         tph::texture_format::r32g32b32a32_sfloat,      block_info{1, 1, 16}},
+    format_blocks{tph::texture_format::r64_uint,                  tph::texture_format::r64_sfloat,               block_info{1, 1, 8}},
+    format_blocks{tph::texture_format::r64g64_uint,               tph::texture_format::r64g64_sfloat,            block_info{1, 1, 16}},
+    format_blocks{tph::texture_format::r64g64b64_uint,            tph::texture_format::r64g64b64_sfloat,         block_info{1, 1, 24}},
+    format_blocks{tph::texture_format::r64g64b64a64_uint,         tph::texture_format::r64g64b64a64_sfloat,      block_info{1, 1, 32}},
+    format_blocks{tph::texture_format::b10g11r11_ufloat_pack,     tph::texture_format::e5b9g9r9_ufloat_pack,     block_info{1, 1, 4}},
+    format_blocks{tph::texture_format::bc1_rgb_unorm_block,       tph::texture_format::bc1_rgba_srgb_block,      block_info{4, 4, 8}},
+    format_blocks{tph::texture_format::bc2_unorm_block,           tph::texture_format::bc3_srgb_block,           block_info{4, 4, 16}},
+    format_blocks{tph::texture_format::bc4_unorm_block,           tph::texture_format::bc4_snorm_block,          block_info{4, 4, 8}},
+    format_blocks{tph::texture_format::bc5_unorm_block,           tph::texture_format::bc7_srgb_block,           block_info{4, 4, 16}},
+    format_blocks{tph::texture_format::etc2_r8g8b8_unorm_block,   tph::texture_format::etc2_r8g8b8a1_srgb_block, block_info{4, 4, 8}},
+    format_blocks{tph::texture_format::etc2_r8g8b8a8_unorm_block, tph::texture_format::etc2_r8g8b8a8_srgb_block, block_info{4, 4, 16}},
+    format_blocks{tph::texture_format::eac_r11_unorm_block,       tph::texture_format::eac_r11_snorm_block,      block_info{4, 4, 8}},
+    format_blocks{tph::texture_format::eac_r11g11_unorm_block,    tph::texture_format::eac_r11g11_snorm_block,   block_info{4, 4, 16}},
+    format_blocks{tph::texture_format::astc_4x4_unorm_block,      tph::texture_format::astc_4x4_srgb_block,      block_info{4, 4, 16}},
+    format_blocks{tph::texture_format::astc_5x4_unorm_block,      tph::texture_format::astc_5x4_srgb_block,      block_info{5, 4, 16}},
+    format_blocks{tph::texture_format::astc_5x5_unorm_block,      tph::texture_format::astc_5x5_srgb_block,      block_info{5, 5, 16}},
+    format_blocks{tph::texture_format::astc_6x5_unorm_block,      tph::texture_format::astc_6x5_srgb_block,      block_info{6, 5, 16}},
+    format_blocks{tph::texture_format::astc_6x6_unorm_block,      tph::texture_format::astc_6x6_srgb_block,      block_info{6, 6, 16}},
+    format_blocks{tph::texture_format::astc_8x5_unorm_block,      tph::texture_format::astc_8x5_srgb_block,      block_info{8, 5, 16}},
+    format_blocks{tph::texture_format::astc_8x6_unorm_block,      tph::texture_format::astc_8x6_srgb_block,      block_info{8, 6, 16}},
+    format_blocks{tph::texture_format::astc_8x8_unorm_block,      tph::texture_format::astc_8x8_srgb_block,      block_info{8, 8, 16}},
+    format_blocks{tph::texture_format::astc_10x5_unorm_block,     tph::texture_format::astc_10x5_srgb_block,     block_info{10, 5, 16}},
+    format_blocks{tph::texture_format::astc_10x6_unorm_block,     tph::texture_format::astc_10x6_srgb_block,     block_info{10, 6, 16}},
+    format_blocks{tph::texture_format::astc_10x8_unorm_block,     tph::texture_format::astc_10x8_srgb_block,     block_info{10, 8, 16}},
+    format_blocks{tph::texture_format::astc_10x10_unorm_block,    tph::texture_format::astc_10x10_srgb_block,    block_info{10, 10, 16}},
+    format_blocks{tph::texture_format::astc_12x10_unorm_block,    tph::texture_format::astc_12x10_srgb_block,    block_info{12, 10, 16}},
+    format_blocks{tph::texture_format::astc_12x12_unorm_block,    tph::texture_format::astc_12x12_srgb_block,    block_info{12, 12, 16}},
+};
+
+//Depth/stencil and extension formats are not supported
+static block_info format_block(tph::texture_format format)
+{
+    const auto value{static_cast<std::uint32_t>(format)};
+
+    for(const auto& range : format_block_ranges)
+    {
+        if(value >= static_cast<std::uint32_t>(range.first) && value <= static_cast<std::uint32_t>(range.last))
+        {
+            return range.block;
+        }
+    }
+
+    throw std::runtime_error{"Unsupported texture container format."};
+}
+
+//Tightly packed size of a level, throws if it does not fit in 64 bits
+static std::uint64_t level_size(const block_info& block, std::uint32_t width, std::uint32_t height)
+{
+    const std::uint64_t columns{(std::uint64_t{width} + block.width - 1) / block.width};
+    const std::uint64_t rows{(std::uint64_t{height} + block.height - 1) / block.height};
+
+    if(columns * rows > std::numeric_limits<std::uint64_t>::max() / block.size)
+    {
+        throw std::runtime_error{"Invalid texture container, level is too big."};
+    }
+
+    return columns * rows * block.size;
+}
+
+//A full mip chain of a width x height texture has at most this number of levels
+static std::uint32_t max_level_count(std::uint32_t width, std::uint32_t height) noexcept
+{
+    return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+}
+
+static std::uint64_t stream_size(std::istream& stream)
+{
+    const auto position{stream.tellg()};
+    stream.seekg(0, std::ios_base::end);
+    const auto output{stream.tellg()};
+    stream.seekg(position);
+
+    if(position < 0 || output < 0)
+    {
+        throw std::runtime_error{"Can not read texture container, the stream is not seekable."};
+    }
+
+    return static_cast<std::uint64_t>(output);
+}
+
+static void check_level_range(const texture_container_level& level, std::uint64_t file_size)
+{
+    if(level.offset > file_size || level.size > file_size - level.offset)
+    {
+        throw std::runtime_error{"Can not read texture container, level data is past the end of file."};
+    }
+}
+
+static tph::texture_format dds_format_from_dxgi(std::uint32_t format)
+{
+    switch(format)
+    {
+        case 28: return tph::texture_format::r8g8b8a8_unorm;
+        case 29: return tph::texture_format::r8g8b8a8_srgb;
+        case 71: return tph::texture_format::bc1_rgba_unorm_block;
+        case 72: return tph::texture_format::bc1_rgba_srgb_block;
+        case 74: return tph::texture_format::bc2_unorm_block;
+        case 75: return tph::texture_format::bc2_srgb_block;
+        case 77: return tph::texture_format::bc3_unorm_block;
+        case 78: return tph::texture_format::bc3_srgb_block;
+        case 80: return tph::texture_format::bc4_unorm_block;
+        case 81: return tph::texture_format::bc4_snorm_block;
+        case 83: return tph::texture_format::bc5_unorm_block;
+        case 84: return tph::texture_format::bc5_snorm_block;
+        case 87: return tph::texture_format::b8g8r8a8_unorm;
+        case 91: return tph::texture_format::b8g8r8a8_srgb;
+        case 95: return tph::texture_format::bc6h_ufloat_block;
+        case 96: return tph::texture_format::bc6h_sfloat_block;
+        case 98: return tph::texture_format::bc7_unorm_block;
+        case 99: return tph::texture_format::bc7_srgb_block;
+        default: throw std::runtime_error{"Unsupported DDS DXGI format."};
+    }
+}
+
+static tph::texture_format dds_format_from_fourcc(std::uint32_t fourcc, color_space space)
+{
+    const bool srgb{space == color_space::srgb};
+
+    switch(fourcc)
+    {
+        case make_fourcc('D', 'X', 'T', '1'): return srgb ? tph::texture_format::bc1_rgba_srgb_block : tph::texture_format::bc1_rgba_unorm_block;
+        case make_fourcc('D', 'X', 'T', '2'): [[fallthrough]];
+        case make_fourcc('D', 'X', 'T', '3'): return srgb ? tph::texture_format::bc2_srgb_block : tph::texture_format::bc2_unorm_block;
+        case make_fourcc('D', 'X', 'T', '4'): [[fallthrough]];
+        case make_fourcc('D', 'X', 'T', '5'): return srgb ? tph::texture_format::bc3_srgb_block : tph::texture_format::bc3_unorm_block;
+        case make_fourcc('A', 'T', 'I', '1'): [[fallthrough]];
+        case make_fourcc('B', 'C', '4', 'U'): return tph::texture_format::bc4_unorm_block;
+        case make_fourcc('B', 'C', '4', 'S'): return tph::texture_format::bc4_snorm_block;
+        case make_fourcc('A', 'T', 'I', '2'): [[fallthrough]];
+        case make_fourcc('B', 'C', '5', 'U'): return tph::texture_format::bc5_unorm_block;
+        case make_fourcc('B', 'C', '5', 'S'): return tph::texture_format::bc5_snorm_block;
+        default: throw std::runtime_error{"Unsupported DDS FourCC."};
+    }
+}
+
+bool is_texture_container(const std::filesystem::path& file)
+{
+    const auto extension{file.extension()};
+
+    return extension == ".ktx2" || extension == ".KTX2" || extension == ".dds" || extension == ".DDS";
+}
+
+texture_container read_ktx2_header(std::istream& stream)
+{
+    std::array<std::uint8_t, 12> identifier{};
+    if(!stream.read(reinterpret_cast<char*>(std::data(identifier)), std::size(identifier)) || identifier != ktx2_identifier)
+    {
+        throw std::runtime_error{"Invalid KTX2 file."};
+    }
+
+    const auto format      {read_value<std::uint32_t>(stream)};
+    [[maybe_unused]] const auto type_size{read_value<std::uint32_t>(stream)};
+    const auto width       {read_value<std::uint32_t>(stream)};
+    const auto height      {read_value<std::uint32_t>(stream)};
+    const auto depth       {read_value<std::uint32_t>(stream)};
+    const auto layer_count {read_value<std::uint32_t>(stream)};
+    const auto face_count  {read_value<std::uint32_t>(stream)};
+    const auto level_count {read_value<std::uint32_t>(stream)};
+    const auto compression {read_value<std::uint32_t>(stream)};
+
+    if(format == 0 || compression != 0)
+    {
+        throw std::runtime_error{"Supercompressed KTX2 files (Basis Universal, Zstandard) are not supported."};
+    }
+
+    if(height == 0 || depth > 1 || layer_count > 1 || face_count != 1)
+    {
+        throw std::runtime_error{"Only 2D KTX2 textures are supported."};
+    }
+
+    if(width == 0 || level_count > max_level_count(width, height))
+    {
+        throw std::runtime_error{"Invalid KTX2 file."};
+    }
+
+    //Data format descriptor, key/value data and supercompression global data are not needed
+    stream.ignore(4 * sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t));
+
+    texture_container output{};
+    output.format = static_cast<tph::texture_format>(format);
+    output.width  = width;
+    output.height = height;
+    output.levels.reserve(std::max(level_count, 1u));
+
+    const auto block{format_block(output.format)};
+    const auto file_size{stream_size(stream)};
+
+    for(std::uint32_t i{}; i < std::max(level_count, 1u); ++i)
+    {
+        texture_container_level level{};
+        level.offset = read_value<std::uint64_t>(stream);
+        level.size   = read_value<std::uint64_t>(stream);
+        level.width  = std::max(width >> i, 1u);
+        level.height = std::max(height >> i, 1u);
+
+        [[maybe_unused]] const auto uncompressed_size{read_value<std::uint64_t>(stream)};
+
+        //The copy to the texture reads the tightly packed size, a smaller level would read past its data
+        const auto expected_size{level_size(block, level.width, level.height)};
+        if(level.size < expected_size)
+        {
+            throw std::runtime_error{"Invalid KTX2 file, level " + std::to_string(i) + " is too small."};
+        }
+
+        level.size = expected_size;
+        check_level_range(level, file_size);
+
+        output.levels.emplace_back(level);
+    }
+
+    return output;
+}
+
+texture_container read_dds_header(std::istream& stream, color_space space)
+{
+    if(read_value<std::uint32_t>(stream) != dds_magic || read_value<std::uint32_t>(stream) != 124)
+    {
+        throw std::runtime_error{"Invalid DDS file."};
+    }
+
+    [[maybe_unused]] const auto flags{read_value<std::uint32_t>(stream)};
+    const auto height     {read_value<std::uint32_t>(stream)};
+    const auto width      {read_value<std::uint32_t>(stream)};
+    [[maybe_unused]] const auto pitch{read_value<std::uint32_t>(stream)};
+    const auto depth      {read_value<std::uint32_t>(stream)};
+    const auto level_count{read_value<std::uint32_t>(stream)};
+    stream.ignore(11 * sizeof(std::uint32_t));
+
+    //Pixel format
+    stream.ignore(sizeof(std::uint32_t));
+    const auto pixel_flags{read_value<std::uint32_t>(stream)};
+    const auto fourcc     {read_value<std::uint32_t>(stream)};
+    const auto bit_count  {read_value<std::uint32_t>(stream)};
+    const auto red_mask   {read_value<std::uint32_t>(stream)};
+    [[maybe_unused]] const auto green_mask{read_value<std::uint32_t>(stream)};
+    const auto blue_mask  {read_value<std::uint32_t>(stream)};
+    [[maybe_unused]] const auto alpha_mask{read_value<std::uint32_t>(stream)};
+
+    stream.ignore(sizeof(std::uint32_t));
+    const auto caps2{read_value<std::uint32_t>(stream)};
+    stream.ignore(3 * sizeof(std::uint32_t));
+
+    if(depth > 1 || (caps2 & 0x200) != 0) //Volume or cubemap
+    {
+        throw std::runtime_error{"Only 2D DDS textures are supported."};
+    }
+
+    if(width == 0 || height == 0 || level_count > max_level_count(width, height))
+    {
+        throw std::runtime_error{"Invalid DDS file."};
+    }
+
+    texture_container output{};
+    output.width  = width;
+    output.height = height;
+
+    if((pixel_flags & 0x4) != 0 && fourcc == make_fourcc('D', 'X', '1', '0'))
+    {
+        const auto format   {read_value<std::uint32_t>(stream)};
+        const auto dimension{read_value<std::uint32_t>(stream)};
+        const auto misc     {read_value<std::uint32_t>(stream)};
+        const auto array    {read_value<std::uint32_t>(stream)};
+        stream.ignore(sizeof(std::uint32_t));
+
+        if(dimension != 3 || (misc & 0x4) != 0 || array > 1)
+        {
+            throw std::runtime_error{"Only 2D DDS textures are supported."};
+        }
+
+        output.format = dds_format_from_dxgi(format);
+    }
+    else if((pixel_flags & 0x4) != 0)
+    {
+        output.format = dds_format_from_fourcc(fourcc, space);
+    }
+    else if((pixel_flags & 0x40) != 0 && bit_count == 32) //Uncompressed RGBA
+    {
+        const bool srgb{space == color_space::srgb};
+
+        if(red_mask == 0x000000FF && blue_mask == 0x00FF0000)
+        {
+            output.format = srgb ? tph::texture_format::r8g8b8a8_srgb : tph::texture_format::r8g8b8a8_unorm;
+        }
+        else if(red_mask == 0x00FF0000 && blue_mask == 0x000000FF)
+        {
+            output.format = srgb ? tph::texture_format::b8g8r8a8_srgb : tph::texture_format::b8g8r8a8_unorm;
+        }
+        else
+        {
+            throw std::runtime_error{"Unsupported DDS pixel format."};
+        }
+    }
+    else
+    {
+        throw std::runtime_error{"Unsupported DDS pixel format."};
+    }
+
+    //Levels are stored one after another, right after the headers
+    const auto block{format_block(output.format)};
+    const auto file_size{stream_size(stream)};
+    auto offset{static_cast<std::uint64_t>(stream.tellg())};
+
+    output.levels.reserve(std::max(level_count, 1u));
+
+    for(std::uint32_t i{}; i < std::max(level_count, 1u); ++i)
+    {
+        texture_container_level level{};
+        level.width  = std::max(width >> i, 1u);
+        level.height = std::max(height >> i, 1u);
+        level.offset = offset;
+        level.size   = level_size(block, level.width, level.height);
+
+        check_level_range(level, file_size);
+        offset += level.size;
+
+        output.levels.emplace_back(level);
+    }
+
+    return output;
+}
+
+texture_container read_texture_container_header(std::istream& stream, color_space space)
+{
+    const auto begin{stream.tellg()};
+    const auto magic{read_value<std::uint32_t>(stream)};
+    stream.seekg(begin);
+
+    if(magic == dds_magic)
+    {
+        return read_dds_header(stream, space);
+    }
+
+    return read_ktx2_header(stream);
+}
+
+bool is_texture_format_supported(tph::texture_format format)
+{
+    return engine::instance().graphics_device().support_texture_format(format, tph::format_feature::sampled_image);
+}
+
+tph::buffer load_texture_container(std::istream& stream, texture_container& container)
+{
+    //Buffer offsets of copies must be a multiple of the block size
+    const auto aligned = [](std::uint64_t offset)
+    {
+        return (offset + 15) & ~std::uint64_t{15};
+    };
+
+    std::uint64_t total_size{};
+    for(const auto& level : container.levels)
+    {
+        const auto begin{aligned(total_size)};
+        if(begin < total_size || level.size > std::numeric_limits<std::uint64_t>::max() - begin)
+        {
+            throw std::runtime_error{"Can not load texture container, levels are too big."};
+        }
+
+        total_size = begin + level.size;
+    }
+
+    tph::buffer output{engine::instance().renderer(), total_size, tph::buffer_usage::transfer_source};
+
+    auto* const data{output.map()};
+
+    std::uint64_t offset{};
+    for(auto& level : container.levels)
+    {
+        offset = aligned(offset);
+
+        stream.seekg(static_cast<std::streamoff>(level.offset));
+        if(!stream.read(reinterpret_cast<char*>(data + offset), static_cast<std::streamsize>(level.size)))
+        {
+            output.unmap();
+            throw std::runtime_error{"Can not read texture container, unexpected end of file."};
+        }
+
+        level.offset = offset;
+        offset += level.size;
+    }
+
+    output.unmap();
+
+    return output;
+}
+
+std::filesystem::path find_fallback_image(const std::filesystem::path& file)
+{
+    for(const auto extension : {".png", ".jpg", ".jpeg", ".tga", ".bmp"})
+    {
+        auto candidate{file};
+        candidate.replace_extension(extension);
+
+        if(std::filesystem::exists(candidate))
+        {
+            return candidate;
+        }
+    }
+
+    return std::filesystem::path{};
+}
+
+texture_ptr make_texture_from_container(const std::filesystem::path& file, const tph::sampler_info& sampling, color_space space)
+{
+    std::ifstream stream{file, std::ios_base::binary};
+    if(!stream)
+    {
+        throw std::runtime_error{"Can not open file \"" + file.string() + "\"."};
+    }
+
+    auto container{read_texture_container_header(stream, space)};
+
+    if(!is_texture_format_supported(container.format))
+    {
+        const auto fallback{find_fallback_image(file)};
+        if(fallback.empty())
+        {
+            throw std::runtime_error{"Texture format of \"" + file.string() + "\" is not supported by the device, and no fallback image has been found."};
+        }
+
+        return make_texture(fallback, sampling, space);
+    }
+
+    tph::buffer staging{load_texture_container(stream, container)};
+
+    const auto level_count{static_cast<std::uint32_t>(std::size(container.levels))};
+    const tph::texture_info info{container.format, tph::texture_usage::sampled | tph::texture_usage::transfer_destination, level_count};
+    texture_ptr texture{make_texture(sampling, container.width, container.height, info)};
+
+    //The texture is not in use yet, it can be uploaded on the standalone transfer queue (if any)
+    auto&& [buffer, signal, keeper, ownership] = engine::instance().begin_transfer(transfer_queue::transfer);
+
+    tph::texture_memory_barrier barrier{texture->get_texture()};
+    barrier.subresource.mip_level_count = level_count;
+    barrier.source_access      = tph::resource_access::none;
+    barrier.destination_access = tph::resource_access::transfer_write;
+    barrier.old_layout         = tph::texture_layout::undefined;
+    barrier.new_layout         = tph::texture_layout::transfer_destination_optimal;
+
+    tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::top_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+
+    for(std::uint32_t i{}; i < level_count; ++i)
+    {
+        const auto& level{container.levels[i]};
+
+        tph::buffer_texture_copy region{};
+        region.buffer_offset = level.offset;
+        region.texture_subresource.mip_level = i;
+        region.texture_size.width  = level.width;
+        region.texture_size.height = level.height;
+
+        tph::cmd::copy(buffer, staging, texture->get_texture(), region);
+    }
+
+    barrier.source_access      = tph::resource_access::transfer_write;
+    barrier.destination_access = tph::resource_access::shader_read;
+    barrier.old_layout         = tph::texture_layout::transfer_destination_optimal;
+    barrier.new_layout         = tph::texture_layout::shader_read_only_optimal;
+
+    ownership.release(buffer, tph::pipeline_stage::fragment_shader, barrier);
+
+    signal.connect([memory = memory_tracking{memory_category::staging, memory_location::host, staging.size()}, staging = std::move(staging)](){});
+    keeper.keep(texture);
+
+#ifdef CAPTAL_DEBUG
+    texture->set_name(convert_to<narrow>(file.u8string()));
+#endif
+
+    return texture;
+}
+
+}
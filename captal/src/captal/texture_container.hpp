@@ -0,0 +1,82 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_TEXTURE_CONTAINER_HPP_INCLUDED
+#define CAPTAL_TEXTURE_CONTAINER_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <filesystem>
+#include <istream>
+#include <vector>
+
+#include <tephra/buffer.hpp>
+#include <tephra/texture.hpp>
+
+#include "texture.hpp"
+
+namespace cpt
+{
+
+struct texture_container_level
+{
+    std::uint64_t offset{};
+    std::uint64_t size{};
+    std::uint32_t width{};
+    std::uint32_t height{};
+};
+
+//Layout of a KTX2 or DDS file, holding a 2D texture already in its GPU format (usually block-compressed).
+//Level offsets are relative to the beginning of the file, levels go from the largest to the smallest.
+struct texture_container
+{
+    tph::texture_format format{};
+    std::uint32_t width{};
+    std::uint32_t height{};
+    std::vector<texture_container_level> levels{};
+};
+
+//Checks the extension only (.ktx2 or .dds)
+CAPTAL_API bool is_texture_container(const std::filesystem::path& file);
+
+CAPTAL_API texture_container read_ktx2_header(std::istream& stream);
+//Legacy DDS files do not tell the color space of BC1-3 data, space is used for them
+CAPTAL_API texture_container read_dds_header(std::istream& stream, color_space space = color_space::srgb);
+//Detects the container from its magic number
+CAPTAL_API texture_container read_texture_container_header(std::istream& stream, color_space space = color_space::srgb);
+
+//Checks that the graphics device can sample textures of the given format
+CAPTAL_API bool is_texture_format_supported(tph::texture_format format);
+
+//Reads all levels in a new staging buffer, packed in the same order. Level offsets are updated to be relative to the buffer.
+CAPTAL_API tph::buffer load_texture_container(std::istream& stream, texture_container& container);
+
+//Returns an image next to the file with the same name (.png, .jpg...), or an empty path if there is none
+CAPTAL_API std::filesystem::path find_fallback_image(const std::filesystem::path& file);
+
+//Uploads the levels as is, without any CPU decoding.
+//If the device does not support the format, an image next to the file with the same name (.png, .jpg...) is loaded instead.
+CAPTAL_API texture_ptr make_texture_from_container(const std::filesystem::path& file, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
+
+}
+
+#endif
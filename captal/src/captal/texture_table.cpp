@@ -0,0 +1,176 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include "texture_table.hpp"
+
+#include <cassert>
+
+#include <tephra/commands.hpp>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+static std::uint32_t table_capacity(const render_layout& layout, std::uint32_t layout_index, std::uint32_t binding) noexcept
+{
+    for(auto&& layout_binding : layout.bindings(layout_index))
+    {
+        if(layout_binding.binding == binding)
+        {
+            assert(layout_binding.type == tph::descriptor_type::image_sampler && "cpt::texture_table binding must be an image sampler.");
+
+            return layout_binding.count;
+        }
+    }
+
+    assert(false && "cpt::texture_table binding not found in render layout.");
+
+    return 0;
+}
+
+texture_table::texture_table(render_layout_ptr layout, std::uint32_t layout_index, std::uint32_t binding, texture_ptr fallback)
+:m_layout{std::move(layout)}
+,m_layout_index{layout_index}
+,m_binding{binding}
+,m_fallback{std::move(fallback)}
+{
+    assert(m_layout_index >= render_layout::user_index && "cpt::texture_table must use a user layout.");
+
+    m_textures.resize(table_capacity(*m_layout, m_layout_index, m_binding));
+    m_free_indices.reserve(std::size(m_textures));
+
+    for(std::uint32_t i{capacity()}; i > 0; --i)
+    {
+        m_free_indices.emplace_back(i - 1);
+    }
+}
+
+std::uint32_t texture_table::insert(texture_ptr texture)
+{
+    if(const auto it{m_indices.find(texture.get())}; it != std::end(m_indices))
+    {
+        return it->second;
+    }
+
+    if(std::empty(m_free_indices))
+    {
+        throw std::runtime_error{"cpt::texture_table is full."};
+    }
+
+    const std::uint32_t index{m_free_indices.back()};
+    m_free_indices.pop_back();
+
+    m_indices.emplace(texture.get(), index);
+    m_textures[index] = std::move(texture);
+    m_need_update = true;
+
+    return index;
+}
+
+void texture_table::remove(const texture_ptr& texture)
+{
+    if(const auto it{m_indices.find(texture.get())}; it != std::end(m_indices))
+    {
+        m_textures[it->second].reset();
+        m_free_indices.emplace_back(it->second);
+        m_indices.erase(it);
+
+        m_need_update = true;
+    }
+}
+
+void texture_table::clear()
+{
+    m_indices.clear();
+    m_free_indices.clear();
+
+    for(std::uint32_t i{capacity()}; i > 0; --i)
+    {
+        m_textures[i - 1].reset();
+        m_free_indices.emplace_back(i - 1);
+    }
+
+    m_need_update = true;
+}
+
+void texture_table::bind(frame_render_info info)
+{
+    if(std::exchange(m_need_update, false))
+    {
+        write_set();
+    }
+
+    tph::cmd::bind_descriptor_set(info.buffer, m_layout_index, m_set->set(), m_layout->pipeline_layout());
+
+    info.keeper.keep(m_set);
+    info.keeper.keep(m_fallback);
+
+    for(auto&& texture : m_textures)
+    {
+        if(texture)
+        {
+            info.keeper.keep(texture);
+        }
+    }
+}
+
+void texture_table::write_set()
+{
+    //The previous set may still be in use by frames in flight, so a new one is written instead of updating it
+    m_set = m_layout->make_set(m_layout_index);
+
+    #ifdef CAPTAL_DEBUG
+    if(!std::empty(m_name))
+    {
+        tph::set_object_name(engine::instance().renderer(), m_set->set(), m_name + " descriptor set");
+    }
+    #endif
+
+    std::vector<tph::descriptor_write> writes{};
+    writes.reserve(std::size(m_textures));
+
+    for(std::uint32_t i{}; i < capacity(); ++i)
+    {
+        auto& texture{m_textures[i] ? *m_textures[i] : *m_fallback};
+
+        const tph::descriptor_texture_info texture_info{&texture.get_sampler(), &texture.get_texture_view(), tph::texture_layout::shader_read_only_optimal};
+        writes.emplace_back(tph::descriptor_write{m_set->set(), m_binding, i, tph::descriptor_type::image_sampler, texture_info});
+    }
+
+    tph::write_descriptors(engine::instance().renderer(), writes);
+}
+
+#ifdef CAPTAL_DEBUG
+void texture_table::set_name(std::string_view name)
+{
+    m_name = name;
+
+    if(m_set)
+    {
+        tph::set_object_name(engine::instance().renderer(), m_set->set(), m_name + " descriptor set");
+    }
+}
+#endif
+
+}
@@ -0,0 +1,116 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#ifndef CAPTAL_TEXTURE_TABLE_HPP_INCLUDED
+#define CAPTAL_TEXTURE_TABLE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <unordered_map>
+#include <optional>
+
+#include "texture.hpp"
+#include "render_target.hpp"
+#include "render_technique.hpp"
+
+namespace cpt
+{
+
+//Bindless texturing: all textures live in one descriptor array (an image_sampler binding with count > 1 in a user layout),
+//and draws select their texture with an index, usually given as a push constant.
+//The shader must index the array with a dynamically uniform value, this requires the shader_sampled_image_array_dynamic_indexing feature.
+//The descriptor set is only rewritten when textures are inserted or removed, the table binding must be the only one of its user layout.
+class CAPTAL_API texture_table
+{
+public:
+    texture_table() = default;
+    explicit texture_table(render_layout_ptr layout, std::uint32_t layout_index, std::uint32_t binding, texture_ptr fallback);
+
+    ~texture_table() = default;
+    texture_table(const texture_table&) = delete;
+    texture_table& operator=(const texture_table&) = delete;
+    texture_table(texture_table&&) noexcept = default;
+    texture_table& operator=(texture_table&&) noexcept = default;
+
+    std::uint32_t insert(texture_ptr texture);
+    void remove(const texture_ptr& texture);
+    void clear();
+
+    void bind(frame_render_info info);
+
+    std::optional<std::uint32_t> index(const texture_ptr& texture) const
+    {
+        if(const auto it{m_indices.find(texture.get())}; it != std::end(m_indices))
+        {
+            return it->second;
+        }
+
+        return std::nullopt;
+    }
+
+    std::uint32_t capacity() const noexcept
+    {
+        return static_cast<std::uint32_t>(std::size(m_textures));
+    }
+
+    std::size_t size() const noexcept
+    {
+        return std::size(m_indices);
+    }
+
+    const render_layout_ptr& layout() const noexcept
+    {
+        return m_layout;
+    }
+
+#ifdef CAPTAL_DEBUG
+    void set_name(std::string_view name);
+#else
+    void set_name(std::string_view name [[maybe_unused]]) const noexcept
+    {
+
+    }
+#endif
+
+private:
+    void write_set();
+
+private:
+    render_layout_ptr m_layout{};
+    std::uint32_t m_layout_index{};
+    std::uint32_t m_binding{};
+    texture_ptr m_fallback{};
+    std::vector<texture_ptr> m_textures{};
+    std::unordered_map<const texture*, std::uint32_t> m_indices{};
+    std::vector<std::uint32_t> m_free_indices{};
+    descriptor_set_ptr m_set{};
+    bool m_need_update{true};
+
+#ifdef CAPTAL_DEBUG
+    std::string m_name{};
+#endif
+};
+
+}
+
+#endif
@@ -55,4 +55,11 @@ std::vector<uniform_buffer::buffer_part_info> uniform_buffer::compute_part_info(
     return output;
 }
 
+slab_pool& uniform_buffer_pool()
+{
+    static slab_pool pool{node_block_size<uniform_buffer>, node_block_align<uniform_buffer>, slab_pool::default_slab_block_count, 32};
+
+    return pool;
+}
+
 }
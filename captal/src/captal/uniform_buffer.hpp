@@ -29,6 +29,8 @@
 #include <cstring>
 #include <memory>
 
+#include <captal_foundation/pool_allocator.hpp>
+
 #include <tephra/buffer.hpp>
 
 #include "asynchronous_resource.hpp"
@@ -105,7 +107,7 @@ public:
 
     buffer_info get_buffer() noexcept
     {
-        return buffer_info{m_buffer.heap().buffer(), m_buffer.offset()};
+        return buffer_info{m_buffer.heap().buffer(), m_buffer.heap().slice_offset() + m_buffer.offset()};
     }
 
     std::uint64_t size() const noexcept
@@ -124,10 +126,13 @@ private:
 using uniform_buffer_ptr = std::shared_ptr<uniform_buffer>;
 using uniform_buffer_weak_ptr = std::weak_ptr<uniform_buffer>;
 
+//Memory of all uniform buffers made by cpt::make_uniform_buffer, along with their shared_ptr control block
+CAPTAL_API slab_pool& uniform_buffer_pool();
+
 template<typename... Args>
 uniform_buffer_ptr make_uniform_buffer(Args&&... args)
 {
-    return std::make_shared<uniform_buffer>(std::forward<Args>(args)...);
+    return std::allocate_shared<uniform_buffer>(pool_allocator<uniform_buffer>{uniform_buffer_pool()}, std::forward<Args>(args)...);
 }
 
 }
@@ -25,11 +25,21 @@
 
 #include "config.hpp"
 
+#include <array>
+#include <algorithm>
+#include <cmath>
+
 #include <captal_foundation/math.hpp>
 
 namespace cpt
 {
 
+enum class vertex_format : std::uint32_t
+{
+    standard = 0, //cpt::vertex, 36 bytes
+    packed = 1,   //cpt::packed_vertex, 20 bytes
+};
+
 struct vertex
 {
     vec3f position{};
@@ -37,6 +47,42 @@ struct vertex
     vec2f texture_coord{};
 };
 
+//Color is stored as 8-bit unorm and texture coordinates as 16-bit unorm, they are expanded by the vertex fetch,
+//so the same shaders are used with both formats. Texture coordinates are clamped to [0; 1].
+struct packed_vertex
+{
+    vec3f position{};
+    std::array<std::uint8_t, 4> color{};
+    std::array<std::uint16_t, 2> texture_coord{};
+};
+
+static_assert(sizeof(packed_vertex) == 20);
+
+inline packed_vertex pack(const vertex& vertex) noexcept
+{
+    const auto to_unorm8 = [](float value)
+    {
+        return static_cast<std::uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    };
+
+    const auto to_unorm16 = [](float value)
+    {
+        return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    };
+
+    packed_vertex output{};
+    output.position = vertex.position;
+    output.color = {to_unorm8(vertex.color.x()), to_unorm8(vertex.color.y()), to_unorm8(vertex.color.z()), to_unorm8(vertex.color.w())};
+    output.texture_coord = {to_unorm16(vertex.texture_coord.x()), to_unorm16(vertex.texture_coord.y())};
+
+    return output;
+}
+
+constexpr std::size_t vertex_size(vertex_format format) noexcept
+{
+    return format == vertex_format::packed ? sizeof(packed_vertex) : sizeof(vertex);
+}
+
 }
 
 #endif
@@ -22,6 +22,8 @@
 
 #include "view.hpp"
 
+#include <captal_foundation/frame_allocator.hpp>
+
 #include "render_window.hpp"
 #include "render_texture.hpp"
 #include "engine.hpp"
@@ -41,6 +43,8 @@ view::view(const render_target_ptr& target, render_technique_ptr technique)
 ,m_need_upload{true}
 {
     m_bindings.set(0, make_uniform_buffer(std::array{buffer_part{buffer_part_type::uniform, sizeof(view::uniform_data)}}));
+
+    touch_scene();
 }
 
 void view::upload(memory_transfer_info info)
@@ -59,14 +63,36 @@ void view::upload(memory_transfer_info info)
 
 void view::bind(frame_render_info info)
 {
+    //Switching from the fallback may change the layout
+    auto& technique{m_render_technique->active()};
+    if(m_active_technique && m_active_technique->layout() != technique.layout())
+    {
+        m_need_descriptor_update = true;
+    }
+
+    m_active_technique = &technique;
+
+    //Keep recording new frames until the real technique replaces the fallback
+    if(m_active_technique != m_render_technique.get())
+    {
+        touch_scene();
+    }
+
+    //Uniform buffers have been moved by buffer_pool::compact
+    if(m_relocation_epoch != buffer_relocation_epoch())
+    {
+        m_relocation_epoch = buffer_relocation_epoch();
+        m_need_descriptor_update = true;
+    }
+
     if(std::exchange(m_need_descriptor_update, false))
     {
         m_set.reset();
         m_to_keep.clear();
 
-        const auto to_bind{m_render_technique->layout()->bindings(render_layout::view_index)};
+        const auto to_bind{technique.layout()->bindings(render_layout::view_index)};
 
-        m_set = m_render_technique->layout()->make_set(render_layout::view_index);
+        m_set = technique.layout()->make_set(render_layout::view_index);
 
         #ifdef CAPTAL_DEBUG
         if(!std::empty(m_name))
@@ -75,7 +101,7 @@ void view::bind(frame_render_info info)
         }
         #endif
 
-        std::vector<tph::descriptor_write> writes{};
+        auto writes{make_frame_vector<tph::descriptor_write>()};
         writes.reserve(std::size(to_bind));
 
         for(auto&& binding : to_bind)
@@ -89,7 +115,7 @@ void view::bind(frame_render_info info)
             }
             else
             {
-                const auto fallback{m_render_technique->layout()->default_binding(render_layout::view_index, binding.binding)};
+                const auto fallback{technique.layout()->default_binding(render_layout::view_index, binding.binding)};
                 assert(fallback && "cpt::view::bind can not find any suitable binding, neither the view nor the render layout have a binding for specified index.");
 
                 writes.emplace_back(make_descriptor_write(m_set->set(), binding.binding, *fallback));
@@ -103,10 +129,10 @@ void view::bind(frame_render_info info)
     tph::cmd::set_viewport(info.buffer, m_viewport);
     tph::cmd::set_scissor(info.buffer, m_scissor);
 
-    tph::cmd::bind_pipeline(info.buffer, m_render_technique->pipeline());
-    tph::cmd::bind_descriptor_set(info.buffer, 0, m_set->set(), m_render_technique->layout()->pipeline_layout());
+    tph::cmd::bind_pipeline(info.buffer, technique.pipeline());
+    tph::cmd::bind_descriptor_set(info.buffer, 0, m_set->set(), technique.layout()->pipeline_layout());
 
-    m_push_constants.push(info.buffer, m_render_technique->layout(), render_layout::view_index);
+    m_push_constants.push(info.buffer, technique.layout(), render_layout::view_index);
 
     info.keeper.keep(std::begin(m_to_keep), std::end(m_to_keep));
     info.keeper.keep(m_set);
@@ -120,6 +146,7 @@ void view::fit(std::uint32_t width, std::uint32_t height)
     m_size = vec2f{static_cast<float>(width), static_cast<float>(height)};
 
     m_need_upload = true;
+    touch_scene();
 }
 
 void view::fit(const window_ptr& window)
@@ -160,6 +187,7 @@ void view::set_binding(std::uint32_t index, cpt::binding binding)
 
     m_bindings.set(index, std::move(binding));
     m_need_descriptor_update = true;
+    touch_scene();
 }
 
 #ifdef CAPTAL_DEBUG
@@ -37,6 +37,7 @@
 #include "render_technique.hpp"
 #include "render_window.hpp"
 #include "render_texture.hpp"
+#include "scene_epoch.hpp"
 
 namespace cpt
 {
@@ -78,17 +79,21 @@ public:
     template<typename T>
     void set_push_constant(tph::shader_stage stages, std::uint32_t offset, T&& value)
     {
+        touch_scene();
+
         return m_push_constants.set(stages, offset, std::forward<T>(value));
     }
 
     void set_viewport(const tph::viewport& viewport) noexcept
     {
         m_viewport = viewport;
+        touch_scene();
     }
 
     void set_scissor(const tph::scissor& scissor) noexcept
     {
         m_scissor = scissor;
+        touch_scene();
     }
 
     void move_to(const vec3f& position) noexcept
@@ -160,6 +165,7 @@ public:
     void update() noexcept
     {
         m_need_upload = true;
+        touch_scene();
     }
 
     render_target& target() const noexcept
@@ -172,6 +178,12 @@ public:
         return m_render_technique;
     }
 
+    //The technique used by the last bind, it differs from render_technique() while its pipeline is compiling
+    cpt::render_technique& active_render_technique() const noexcept
+    {
+        return m_active_technique ? *m_active_technique : *m_render_technique;
+    }
+
     const cpt::binding& get_binding(std::uint32_t index) const noexcept
     {
         return m_bindings.get(index);
@@ -271,6 +283,7 @@ public:
 private:
     render_target* m_target{};
     render_technique_ptr m_render_technique{};
+    cpt::render_technique* m_active_technique{};
     binding_buffer m_bindings{};
     push_constants_buffer m_push_constants{};
     descriptor_set_ptr m_set{};
@@ -289,6 +302,7 @@ private:
 
     bool m_need_upload{true};
     bool m_need_descriptor_update{true};
+    std::uint64_t m_relocation_epoch{};
 
 #ifdef CAPTAL_DEBUG
     std::string m_name{};
@@ -0,0 +1,203 @@
+#include <captal/texture_container.hpp>
+
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_CONSOLE_WIDTH 120
+#include <catch2/catch.hpp>
+
+template<typename T>
+static void write_value(std::string& output, T value)
+{
+    output.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+struct ktx2_level
+{
+    std::uint64_t offset{};
+    std::uint64_t size{};
+};
+
+static constexpr std::uint64_t ktx2_header_size(std::size_t level_count) noexcept
+{
+    return 80 + 24 * level_count;
+}
+
+static std::string make_ktx2(tph::texture_format format, std::uint32_t width, std::uint32_t height, const std::vector<ktx2_level>& levels, std::size_t data_size)
+{
+    std::string output{"\xAB\x4B\x54\x58\x20\x32\x30\xBB\x0D\x0A\x1A\x0A", 12};
+
+    write_value(output, static_cast<std::uint32_t>(format));
+    write_value(output, std::uint32_t{1}); //type size
+    write_value(output, width);
+    write_value(output, height);
+    write_value(output, std::uint32_t{0}); //depth
+    write_value(output, std::uint32_t{0}); //layer count
+    write_value(output, std::uint32_t{1}); //face count
+    write_value(output, static_cast<std::uint32_t>(std::size(levels)));
+    write_value(output, std::uint32_t{0}); //supercompression
+    output.append(32, '\0'); //dfd, kvd and sgd ranges
+
+    for(const auto& level : levels)
+    {
+        write_value(output, level.offset);
+        write_value(output, level.size);
+        write_value(output, level.size);
+    }
+
+    output.append(data_size, '\0');
+
+    return output;
+}
+
+static std::string make_dds(std::uint32_t fourcc, std::uint32_t width, std::uint32_t height, std::uint32_t level_count, std::size_t data_size, std::optional<std::uint32_t> dxgi_format = std::nullopt)
+{
+    std::string output{};
+
+    write_value(output, std::uint32_t{0x20534444}); //"DDS "
+    write_value(output, std::uint32_t{124});
+    write_value(output, std::uint32_t{0x1007}); //flags
+    write_value(output, height);
+    write_value(output, width);
+    write_value(output, std::uint32_t{0}); //pitch
+    write_value(output, std::uint32_t{0}); //depth
+    write_value(output, level_count);
+    output.append(11 * sizeof(std::uint32_t), '\0');
+
+    write_value(output, std::uint32_t{32}); //pixel format size
+    write_value(output, std::uint32_t{0x4}); //FourCC flag
+    write_value(output, dxgi_format ? std::uint32_t{0x30315844} : fourcc);
+    output.append(5 * sizeof(std::uint32_t), '\0'); //bit count and masks
+    output.append(5 * sizeof(std::uint32_t), '\0'); //caps
+
+    if(dxgi_format)
+    {
+        write_value(output, *dxgi_format);
+        write_value(output, std::uint32_t{3}); //2D
+        write_value(output, std::uint32_t{0}); //misc
+        write_value(output, std::uint32_t{1}); //array size
+        write_value(output, std::uint32_t{0});
+    }
+
+    output.append(data_size, '\0');
+
+    return output;
+}
+
+static constexpr std::uint32_t dxt1{0x31545844};
+
+TEST_CASE("KTX2 header", "[texture_container]")
+{
+    const auto read = [](const std::string& data)
+    {
+        std::istringstream stream{data, std::ios_base::binary};
+
+        return cpt::read_ktx2_header(stream);
+    };
+
+    constexpr auto bc1{tph::texture_format::bc1_rgba_srgb_block};
+    constexpr auto offset{ktx2_header_size(3)};
+
+    SECTION("Valid levels are read")
+    {
+        const auto container{read(make_ktx2(bc1, 32, 32, {{offset, 512}, {offset + 512, 128}, {offset + 640, 32}}, 672))};
+
+        REQUIRE(container.format == bc1);
+        REQUIRE(container.width == 32);
+        REQUIRE(container.height == 32);
+        REQUIRE(std::size(container.levels) == 3);
+        REQUIRE(container.levels[1].offset == offset + 512);
+        REQUIRE(container.levels[1].size == 128);
+        REQUIRE(container.levels[2].width == 8);
+        REQUIRE(container.levels[2].height == 8);
+    }
+
+    SECTION("Levels bigger than their packed size are only read up to it")
+    {
+        const auto container{read(make_ktx2(bc1, 32, 32, {{ktx2_header_size(1), 600}}, 600))};
+
+        REQUIRE(container.levels[0].size == 512);
+    }
+
+    SECTION("Levels smaller than their packed size are rejected")
+    {
+        REQUIRE_THROWS_AS(read(make_ktx2(bc1, 32, 32, {{offset, 512}, {offset + 512, 64}, {offset + 576, 32}}, 608)), std::runtime_error);
+    }
+
+    SECTION("Levels past the end of file are rejected")
+    {
+        REQUIRE_THROWS_AS(read(make_ktx2(bc1, 32, 32, {{offset, 512}, {offset + 512, 128}, {offset + 640, 32}}, 600)), std::runtime_error);
+        REQUIRE_THROWS_AS(read(make_ktx2(bc1, 32, 32, {{std::numeric_limits<std::uint64_t>::max() - 8, 512}}, 512)), std::runtime_error);
+        REQUIRE_THROWS_AS(read(make_ktx2(bc1, 32, 32, {{offset, std::numeric_limits<std::uint64_t>::max()}}, 512)), std::runtime_error);
+    }
+
+    SECTION("Malformed headers are rejected")
+    {
+        const auto valid{make_ktx2(bc1, 32, 32, {{offset, 512}, {offset + 512, 128}, {offset + 640, 32}}, 672)};
+
+        REQUIRE_THROWS_AS(read(valid.substr(0, 40)), std::runtime_error);
+        REQUIRE_THROWS_AS(read(valid.substr(0, offset - 8)), std::runtime_error);
+        REQUIRE_THROWS_AS(read("not a ktx2 file"), std::runtime_error);
+
+        //A 32x32 texture has 6 levels at most
+        std::vector<ktx2_level> levels(7, ktx2_level{ktx2_header_size(7), 8});
+        REQUIRE_THROWS_AS(read(make_ktx2(bc1, 32, 32, levels, 1024)), std::runtime_error);
+
+        REQUIRE_THROWS_AS(read(make_ktx2(bc1, 0, 32, {{ktx2_header_size(1), 512}}, 512)), std::runtime_error);
+        REQUIRE_THROWS_AS(read(make_ktx2(tph::texture_format::d32_sfloat, 32, 32, {{ktx2_header_size(1), 4096}}, 4096)), std::runtime_error);
+    }
+}
+
+TEST_CASE("DDS header", "[texture_container]")
+{
+    const auto read = [](const std::string& data)
+    {
+        std::istringstream stream{data, std::ios_base::binary};
+
+        return cpt::read_dds_header(stream, cpt::color_space::linear);
+    };
+
+    SECTION("FourCC levels follow the header")
+    {
+        const auto container{read(make_dds(dxt1, 16, 16, 2, 160))};
+
+        REQUIRE(container.format == tph::texture_format::bc1_rgba_unorm_block);
+        REQUIRE(std::size(container.levels) == 2);
+        REQUIRE(container.levels[0].offset == 128);
+        REQUIRE(container.levels[0].size == 128);
+        REQUIRE(container.levels[1].offset == 256);
+        REQUIRE(container.levels[1].size == 32);
+    }
+
+    SECTION("DX10 levels follow the extended header")
+    {
+        const auto container{read(make_dds(0, 6, 6, 1, 64, 98))};
+
+        REQUIRE(container.format == tph::texture_format::bc7_unorm_block);
+        REQUIRE(container.levels[0].offset == 148);
+        REQUIRE(container.levels[0].size == 64); //Partial blocks are counted
+    }
+
+    SECTION("Truncated files are rejected")
+    {
+        REQUIRE_THROWS_AS(read(make_dds(dxt1, 16, 16, 2, 159)), std::runtime_error);
+        REQUIRE_THROWS_AS(read(make_dds(dxt1, 16, 16, 2, 160).substr(0, 100)), std::runtime_error);
+        REQUIRE_THROWS_AS(read(make_dds(0, 8, 8, 1, 64, 98).substr(0, 140)), std::runtime_error);
+    }
+
+    SECTION("Malformed headers are rejected")
+    {
+        auto bad_magic{make_dds(dxt1, 16, 16, 1, 128)};
+        bad_magic[0] = 'X';
+
+        REQUIRE_THROWS_AS(read(bad_magic), std::runtime_error);
+        REQUIRE_THROWS_AS(read(make_dds(dxt1, 16, 16, 6, 1024)), std::runtime_error); //16x16 has 5 levels at most
+        REQUIRE_THROWS_AS(read(make_dds(dxt1, 0, 16, 1, 128)), std::runtime_error);
+        REQUIRE_THROWS_AS(read(make_dds(0x12345678, 16, 16, 1, 128)), std::runtime_error);
+        REQUIRE_THROWS_AS(read(make_dds(0, 16, 16, 1, 256, 1000)), std::runtime_error);
+    }
+}
@@ -28,10 +28,25 @@
 #include <iterator>
 #include <concepts>
 #include <ranges>
+#include <memory>
+#include <limits>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CAPTAL_FOUNDATION_SSE2
+    #include <emmintrin.h>
+#endif
 
 namespace cpt
 {
 
+inline namespace foundation
+{
+
 namespace impl
 {
 
@@ -191,10 +206,128 @@ inline constexpr std::array<char32_t, 666> uppers
     0xFF32, 0xFF33, 0xFF34, 0xFF35, 0xFF36, 0xFF37, 0xFF38, 0xFF39, 0xFF3A
 };
 
+//Returns the length of the leading run of values below 0x80 in [begin, end[
+//ASCII runs are the common case in most texts, even non-latin ones (spaces, digits, markup)
+template<typename CharT>
+std::size_t ascii_length(const CharT* begin, const CharT* end) noexcept
+{
+    static_assert(sizeof(CharT) <= 2);
+
+    const CharT* it{begin};
+
+#ifdef CAPTAL_FOUNDATION_SSE2
+    if constexpr(sizeof(CharT) == 1)
+    {
+        while(end - it >= 16)
+        {
+            const auto mask{static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(it))))};
+
+            if(mask != 0)
+            {
+                return static_cast<std::size_t>(it - begin) + std::countr_zero(mask);
+            }
+
+            it += 16;
+        }
+    }
+    else
+    {
+        const auto limit{_mm_set1_epi16(0x7F)};
+
+        while(end - it >= 8)
+        {
+            const auto values{_mm_loadu_si128(reinterpret_cast<const __m128i*>(it))};
+            const auto ascii{_mm_cmpeq_epi16(_mm_subs_epu16(values, limit), _mm_setzero_si128())};
+            const auto mask{~static_cast<std::uint32_t>(_mm_movemask_epi8(ascii)) & 0xFFFF};
+
+            if(mask != 0)
+            {
+                return static_cast<std::size_t>(it - begin) + std::countr_zero(mask) / 2;
+            }
+
+            it += 8;
+        }
+    }
+#else
+    if constexpr(sizeof(CharT) == 1)
+    {
+        while(end - it >= 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, it, sizeof(word));
+
+            if((word & 0x8080808080808080ull) != 0)
+            {
+                break;
+            }
+
+            it += 8;
+        }
+    }
+#endif
+
+    while(it != end && static_cast<std::uint32_t>(static_cast<std::make_unsigned_t<CharT>>(*it)) < 0x80)
+    {
+        ++it;
+    }
+
+    return static_cast<std::size_t>(it - begin);
 }
 
-inline namespace foundation
+//Copies "count" ASCII values, widening or narrowing them to the output type
+template<typename InputChar, typename OutputChar>
+OutputChar* copy_ascii(const InputChar* begin, std::size_t count, OutputChar* output) noexcept
 {
+    const InputChar* const end{begin + count};
+
+#ifdef CAPTAL_FOUNDATION_SSE2
+    const auto zero{_mm_setzero_si128()};
+
+    if constexpr(sizeof(InputChar) == 1 && sizeof(OutputChar) == 4)
+    {
+        for(; end - begin >= 16; begin += 16, output += 16)
+        {
+            const auto bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin))};
+            const auto low{_mm_unpacklo_epi8(bytes, zero)};
+            const auto high{_mm_unpackhi_epi8(bytes, zero)};
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output),      _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 4),  _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 8),  _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 12), _mm_unpackhi_epi16(high, zero));
+        }
+    }
+    else if constexpr(sizeof(InputChar) == 1 && sizeof(OutputChar) == 2)
+    {
+        for(; end - begin >= 16; begin += 16, output += 16)
+        {
+            const auto bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin))};
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output),     _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 8), _mm_unpackhi_epi8(bytes, zero));
+        }
+    }
+    else if constexpr(sizeof(InputChar) == 2 && sizeof(OutputChar) == 1)
+    {
+        for(; end - begin >= 16; begin += 16, output += 16)
+        {
+            const auto low{_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin))};
+            const auto high{_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + 8))};
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_packus_epi16(low, high));
+        }
+    }
+#endif
+
+    for(; begin != end; ++begin, ++output)
+    {
+        *output = static_cast<OutputChar>(*begin);
+    }
+
+    return output;
+}
+
+}
 
 /*
 struct some_encoding
@@ -407,6 +540,78 @@ public:
     {
         return 4;
     }
+
+    //Returns true if [begin, end[ is well-formed UTF-8 (no overlong forms, surrogates or values above U+10FFFF)
+    template<std::input_iterator InputIt>
+    static constexpr bool validate(InputIt begin, InputIt end) noexcept
+    {
+        while(begin != end)
+        {
+            if constexpr(std::contiguous_iterator<InputIt>)
+            {
+                if(!std::is_constant_evaluated() && static_cast<std::uint8_t>(*begin) < 0x80)
+                {
+                    const auto address{std::to_address(begin)};
+                    std::advance(begin, impl::ascii_length(address, address + std::distance(begin, end)));
+
+                    if(begin == end)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            const auto lead{static_cast<std::uint8_t>(*begin++)};
+
+            const auto next_in_range = [&begin, &end](std::uint8_t lower, std::uint8_t upper) noexcept
+            {
+                if(begin == end)
+                {
+                    return false;
+                }
+
+                const auto value{static_cast<std::uint8_t>(*begin++)};
+
+                return value >= lower && value <= upper;
+            };
+
+            if(lead < 0x80)
+            {
+                continue;
+            }
+            else if(lead < 0xC2) //continuation byte or overlong
+            {
+                return false;
+            }
+            else if(lead < 0xE0)
+            {
+                if(!next_in_range(0x80, 0xBF))
+                {
+                    return false;
+                }
+            }
+            else if(lead < 0xF0) //E0 may be overlong, ED may be a surrogate
+            {
+                if(!next_in_range(lead == 0xE0 ? 0xA0 : 0x80, lead == 0xED ? 0x9F : 0xBF) || !next_in_range(0x80, 0xBF))
+                {
+                    return false;
+                }
+            }
+            else if(lead < 0xF5) //F0 may be overlong, F4 may be above U+10FFFF
+            {
+                if(!next_in_range(lead == 0xF0 ? 0x90 : 0x80, lead == 0xF4 ? 0x8F : 0xBF) || !next_in_range(0x80, 0xBF) || !next_in_range(0x80, 0xBF))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
 };
 
 struct utf16
@@ -646,18 +851,369 @@ template<> struct char_encoding<char32_t> {using type = utf32;};
 template<typename CharT>
 using char_encoding_t = typename char_encoding<CharT>::type;
 
+namespace impl
+{
+
+//A -> B and B -> A are no-op if they are based on the same type
+template<typename Input, typename Output>
+inline constexpr bool is_same_encoding{std::is_same_v<Input, Output> || std::is_base_of_v<Input, Output> || std::is_base_of_v<Output, Input>};
+
+//Encodings that represent ASCII values as themselves, with a single value
+template<typename Encoding>
+inline constexpr bool is_ascii_compatible{std::is_base_of_v<utf8, Encoding> || std::is_base_of_v<utf16, Encoding> || std::is_base_of_v<utf32, Encoding>};
+
+//ASCII runs of the input can be processed in bulk, skipping the per-codepoint decode/encode
+template<typename Input, typename Output, typename InputIt>
+concept ascii_skippable = !is_same_encoding<Input, Output>
+                       && (std::is_base_of_v<utf8, Input> || std::is_base_of_v<utf16, Input>)
+                       && is_ascii_compatible<Output>
+                       && std::contiguous_iterator<InputIt>;
+
+template<typename Input, typename Output, typename InputIt, typename OutputIt>
+concept fast_convertible = ascii_skippable<Input, Output, InputIt> && std::contiguous_iterator<OutputIt>;
+
+//Count of trailing bytes after a UTF-8 lead byte, as used by utf8::decode
+constexpr std::size_t utf8_trailing_bytes(std::uint8_t lead) noexcept
+{
+    return lead < 0xC0 ? 0 : lead < 0xE0 ? 1 : lead < 0xF0 ? 2 : lead < 0xF8 ? 3 : 4;
+}
+
+template<typename CharT>
+constexpr bool utf8_valid_continuation(const CharT* begin, std::size_t count) noexcept
+{
+    for(std::size_t i{}; i < count; ++i)
+    {
+        if((static_cast<std::uint8_t>(begin[i]) & 0xC0) != 0x80)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//Isolated ASCII values (e.g. spaces between words) are not worth a bulk copy
+template<typename CharT>
+constexpr bool starts_ascii_run(const CharT* begin, const CharT* end) noexcept
+{
+    return end - begin >= 2 && static_cast<std::uint32_t>(begin[0]) < 0x80 && static_cast<std::uint32_t>(begin[1]) < 0x80;
+}
+
+//Exact count of Output values produced by convert<Input, Output>(begin, end, ...)
+template<encoding Input, encoding Output, std::input_iterator InputIt>
+constexpr std::size_t converted_length(InputIt begin, InputIt end)
+{
+    if constexpr(is_same_encoding<Input, Output>)
+    {
+        return static_cast<std::size_t>(std::distance(begin, end));
+    }
+    else
+    {
+        std::array<typename Output::char_type, Output::max_char_length()> buffer{};
+        std::size_t output{};
+
+        while(begin < end)
+        {
+            if constexpr(ascii_skippable<Input, Output, InputIt>)
+            {
+                if(!std::is_constant_evaluated())
+                {
+                    const auto address{std::to_address(begin)};
+
+                    if(starts_ascii_run(address, address + (end - begin)))
+                    {
+                        const auto count{ascii_length(address, address + (end - begin))};
+
+                        output += count;
+                        begin  += count;
+
+                        continue;
+                    }
+
+                    //Well-formed sequences of less than 4 bytes decode below U+10000 and never need more than one UTF-16 value.
+                    //Ill-formed continuation bytes may decode to any value, so these sequences go through the generic path.
+                    if constexpr(std::is_base_of_v<utf8, Input> && !std::is_base_of_v<utf8, Output>)
+                    {
+                        const auto trailing{utf8_trailing_bytes(static_cast<std::uint8_t>(*begin))};
+
+                        if(trailing < 3 && static_cast<std::size_t>(end - begin) > trailing && utf8_valid_continuation(address + 1, trailing))
+                        {
+                            output += 1;
+                            begin  += trailing + 1;
+
+                            continue;
+                        }
+                    }
+                }
+            }
+
+            codepoint_t code{};
+            begin   = Input::decode(begin, end, code);
+            output += static_cast<std::size_t>(Output::encode(code, std::data(buffer)) - std::data(buffer));
+        }
+
+        return output;
+    }
+}
+
+//Same result as the generic decode/encode loop, but ASCII runs are copied in bulk
+template<encoding Input, encoding Output, typename InputChar, typename OutputChar>
+OutputChar* convert_contiguous(const InputChar* input, const InputChar* input_end, OutputChar* output) noexcept
+{
+    while(input != input_end)
+    {
+        if(starts_ascii_run(input, input_end))
+        {
+            const auto count{ascii_length(input, input_end)};
+
+            output = copy_ascii(input, count, output);
+            input += count;
+
+            continue;
+        }
+
+        do
+        {
+            codepoint_t code{};
+
+            //Same arithmetic as utf8::decode, without the generic switch for the common cases
+            if constexpr(std::is_base_of_v<utf8, Input>)
+            {
+                const auto lead{static_cast<std::uint32_t>(static_cast<std::uint8_t>(input[0]))};
+                const auto trailing{utf8_trailing_bytes(static_cast<std::uint8_t>(lead))};
+                const auto available{static_cast<std::size_t>(input_end - input)};
+
+                if(trailing == 0)
+                {
+                    code = lead;
+                    input += 1;
+                }
+                else if(trailing == 1 && available > 1)
+                {
+                    code = (lead << 6) + static_cast<std::uint8_t>(input[1]) - 0x00003080;
+                    input += 2;
+                }
+                else if(trailing == 2 && available > 2)
+                {
+                    code = (lead << 12) + (static_cast<std::uint32_t>(static_cast<std::uint8_t>(input[1])) << 6) + static_cast<std::uint8_t>(input[2]) - 0x000E2080;
+                    input += 3;
+                }
+                else
+                {
+                    input = Input::decode(input, input_end, code);
+                }
+            }
+            else
+            {
+                input = Input::decode(input, input_end, code);
+            }
+
+            output = Output::encode(code, output);
+        } while(input != input_end && !starts_ascii_run(input, input_end));
+    }
+
+    return output;
+}
+
+template<encoding Input, encoding Output, std::contiguous_iterator InputIt, std::contiguous_iterator OutputIt>
+OutputIt fast_convert(InputIt begin, InputIt end, OutputIt output)
+{
+    const auto input{std::to_address(begin)};
+    const auto output_begin{std::to_address(output)};
+
+    return output + (convert_contiguous<Input, Output>(input, input + (end - begin), output_begin) - output_begin);
+}
+
+//Upper bound of converted_length, exact for well-formed input
+template<encoding Input, encoding Output, typename InputChar>
+std::size_t converted_length_bound(const InputChar* begin, const InputChar* end) noexcept
+{
+    if constexpr(std::is_base_of_v<utf8, Input>)
+    {
+        //If every lead byte is followed by the right count of continuation bytes, and only them,
+        //utf8::decode does exactly one step per lead byte, otherwise fallback to the exact length
+        const auto byte = [begin](std::size_t index) noexcept
+        {
+            return static_cast<std::uint8_t>(begin[index]);
+        };
+
+        const auto expects_continuation = [&byte](std::size_t index) noexcept
+        {
+            return (index >= 1 && byte(index - 1) >= 0xC0) || (index >= 2 && byte(index - 2) >= 0xE0) || (index >= 3 && byte(index - 3) >= 0xF0);
+        };
+
+        //One value per lead byte, plus one per 4-bytes sequence for UTF-16
+        constexpr bool count_pairs{std::is_base_of_v<utf16, Output>};
+
+        const auto size{static_cast<std::size_t>(end - begin)};
+        std::size_t output{};
+        std::size_t index{};
+        bool ill_formed{};
+
+        const auto scalar_step = [&]() noexcept
+        {
+            const auto value{byte(index)};
+            const bool continuation{(value & 0xC0) == 0x80};
+
+            ill_formed = ill_formed || continuation != expects_continuation(index) || value >= 0xF8;
+            output    += !continuation;
+
+            if constexpr(count_pairs)
+            {
+                output += value >= 0xF0;
+            }
+
+            ++index;
+        };
+
+        for(; index < std::min(size, std::size_t{3}); )
+        {
+            scalar_step();
+        }
+
+#ifdef CAPTAL_FOUNDATION_SSE2
+        const auto zero{_mm_setzero_si128()};
+        const auto load = [begin](std::size_t index) noexcept
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + index));
+        };
+
+        //Bytes are compared as signed values, 0x80-0xBF are continuations, 0xC0-0xFF are lead bytes
+        const auto at_least = [&zero](__m128i bytes, std::int8_t limit) noexcept
+        {
+            return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(static_cast<char>(limit - 1))), _mm_cmplt_epi8(bytes, zero));
+        };
+
+        auto errors{zero};
+
+        while(size - index >= 16)
+        {
+            //8-bit counters, a lane gets at most 2 per iteration
+            auto counts{zero};
+
+            for(std::size_t i{}; i < 127 && size - index >= 16; ++i, index += 16)
+            {
+                const auto bytes{load(index)};
+                const auto continuations{_mm_cmplt_epi8(bytes, _mm_set1_epi8(-64))};
+                const auto expected{_mm_or_si128(_mm_or_si128(at_least(load(index - 1), -64), at_least(load(index - 2), -32)), at_least(load(index - 3), -16))};
+
+                errors = _mm_or_si128(errors, _mm_xor_si128(continuations, expected));
+                errors = _mm_or_si128(errors, at_least(bytes, -8));
+                counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(continuations, zero));
+
+                if constexpr(count_pairs)
+                {
+                    counts = _mm_sub_epi8(counts, at_least(bytes, -16));
+                }
+            }
+
+            const auto sums{_mm_sad_epu8(counts, zero)};
+            output += static_cast<std::size_t>(_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4));
+        }
+
+        ill_formed = ill_formed || _mm_movemask_epi8(errors) != 0;
+#endif
+
+        while(index < size)
+        {
+            scalar_step();
+        }
+
+        //The last sequence must not be truncated
+        if(ill_formed || expects_continuation(size))
+        {
+            return converted_length<Input, Output>(begin, end);
+        }
+
+        return output;
+    }
+    else if constexpr(std::is_base_of_v<utf8, Output>)
+    {
+        //From UTF-16: 1 to 3 bytes per value, a high surrogate counts for 1 and a low surrogate for 3
+        //A valid surrogate pair gives 4 bytes, a lone low surrogate 3 bytes and an unpaired high surrogate at most 1 byte
+        std::size_t output{};
+
+#ifdef CAPTAL_FOUNDATION_SSE2
+        const auto zero{_mm_setzero_si128()};
+        const auto surrogate_first{_mm_set1_epi16(static_cast<short>(0xD800))};
+
+        while(end - begin >= 8)
+        {
+            //16-bit counters of the values to subtract from the maximum, a lane gets at most 2 per iteration
+            auto counts{zero};
+            std::size_t maximum{};
+
+            for(std::size_t i{}; i < 4096 && end - begin >= 8; ++i, begin += 8)
+            {
+                const auto values{_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin))};
+                const auto high_surrogates{_mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(values, surrogate_first), _mm_set1_epi16(0x3FF)), zero)};
+
+                counts = _mm_add_epi16(counts, _mm_cmpeq_epi16(_mm_subs_epu16(values, _mm_set1_epi16(0x7F)), zero));
+                counts = _mm_add_epi16(counts, _mm_cmpeq_epi16(_mm_subs_epu16(values, _mm_set1_epi16(0x7FF)), zero));
+                counts = _mm_add_epi16(counts, _mm_add_epi16(high_surrogates, high_surrogates));
+
+                maximum += 24;
+            }
+
+            //Counters are negative, sum them as 32-bit values
+            auto sums{_mm_madd_epi16(counts, _mm_set1_epi16(1))};
+            sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0x4E));
+            sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0xB1));
+
+            output += maximum - static_cast<std::size_t>(-_mm_cvtsi128_si32(sums));
+        }
+#endif
+
+        for(; begin != end; ++begin)
+        {
+            const auto value{static_cast<std::uint32_t>(*begin)};
+
+            output += 1 + (value >= 0x80) + (value >= 0x800) - 2 * (value >= 0xD800 && value <= 0xDBFF);
+        }
+
+        return output;
+    }
+    else
+    {
+        return converted_length<Input, Output>(begin, end);
+    }
+}
+
+//Single conversion pass, the string is shrunk to the actual length at the end (only needed for ill-formed input)
+template<encoding Input, encoding Output, typename StringOut, typename InputChar>
+StringOut fast_convert_string(const InputChar* input, const InputChar* input_end)
+{
+    StringOut output{};
+    output.resize(converted_length_bound<Input, Output>(input, input_end));
+
+    const auto end{convert_contiguous<Input, Output>(input, input_end, std::data(output))};
+    output.resize(static_cast<std::size_t>(end - std::data(output)));
+
+    return output;
+}
+
+}
+
 template<encoding Input, encoding Output, std::input_iterator InputIt, std::output_iterator<typename Output::char_type> OutputIt>
 constexpr OutputIt convert(InputIt begin, InputIt end, OutputIt output)
 {
     //A -> A is a no-op
     //A -> B and B -> A is also a no-op if their are based on the same type (I do this to prevent from code duplication)
     //Ex: on Windows cpt::wide and cpt::utf16 would be the same (because wide is just a public inheritance of utf16)
-    if constexpr(std::is_same_v<Input, Output> || std::is_base_of_v<Input, Output> || std::is_base_of_v<Output, Input>)
+    if constexpr(impl::is_same_encoding<Input, Output>)
     {
         return std::copy(begin, end, output);
     }
     else
     {
+        if constexpr(impl::fast_convertible<Input, Output, InputIt, OutputIt>)
+        {
+            if(!std::is_constant_evaluated())
+            {
+                return impl::fast_convert<Input, Output>(begin, end, output);
+            }
+        }
+
         while(begin < end)
         {
             codepoint_t code{};
@@ -675,17 +1231,42 @@ concept reservable = requires(T str, std::size_t count)
     str.reserve(count);
 };
 
+template<typename T, typename CharT>
+concept contiguous_resizable = requires(T str, std::size_t count)
+{
+    str.resize(count);
+    {std::data(str)} -> std::same_as<CharT*>;
+};
+
 template<encoding Input, encoding Output, typename StringIn, typename StringOut = std::basic_string<typename Output::char_type>>
 constexpr StringOut convert(const StringIn& str)
 {
     StringOut output{};
 
-    if constexpr(reservable<StringOut>)
+    if constexpr(contiguous_resizable<StringOut, typename Output::char_type> && impl::fast_convertible<Input, Output, std::ranges::iterator_t<const StringIn>, typename Output::char_type*>)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            const auto begin{std::to_address(std::begin(str))};
+
+            return impl::fast_convert_string<Input, Output, StringOut>(begin, begin + std::size(str));
+        }
+    }
+
+    if constexpr(contiguous_resizable<StringOut, typename Output::char_type>)
     {
-        output.reserve(Input::count(std::begin(str), std::end(str)) * Output::max_char_length());
+        output.resize(impl::converted_length<Input, Output>(std::begin(str), std::end(str)));
+        convert<Input, Output>(std::begin(str), std::end(str), std::data(output));
     }
+    else
+    {
+        if constexpr(reservable<StringOut>)
+        {
+            output.reserve(impl::converted_length<Input, Output>(std::begin(str), std::end(str)));
+        }
 
-    convert<Input, Output>(std::begin(str), std::end(str), std::back_inserter(output));
+        convert<Input, Output>(std::begin(str), std::end(str), std::back_inserter(output));
+    }
 
     return output;
 }
@@ -702,68 +1283,215 @@ constexpr StringOut convert_to(const StringIn& str)
     return convert<char_encoding_t<std::ranges::range_value_t<StringIn>>, Output, StringIn, StringOut>(str);
 }
 
-template<encoding Encoding, std::input_iterator InputIt, std::output_iterator<typename Encoding::char_type> OutputIt>
-constexpr OutputIt to_lower(InputIt begin, InputIt end, OutputIt output)
+namespace impl
 {
-    while(begin < end)
+
+//Two-level case mapping table: the BMP is split in pages of 256 codepoints,
+//pages without any mapping share the first delta page which is all zeros
+struct case_table
+{
+    std::array<std::uint8_t, 256> pages{};
+    std::array<std::array<std::int16_t, 256>, 16> deltas{};
+};
+
+template<std::size_t Size>
+constexpr case_table make_case_table(const std::array<char32_t, Size>& from, const std::array<char32_t, Size>& to)
+{
+    case_table output{};
+    std::uint8_t page_count{1};
+
+    for(std::size_t i{}; i < Size; ++i)
     {
-        codepoint_t code{};
-        begin = Encoding::decode(begin, end, code);
+        const auto delta{static_cast<std::int32_t>(to[i]) - static_cast<std::int32_t>(from[i])};
+
+        if(from[i] > 0xFFFF || delta < std::numeric_limits<std::int16_t>::min() || delta > std::numeric_limits<std::int16_t>::max())
+        {
+            throw std::out_of_range{"Case mapping does not fit in the table."};
+        }
 
-        const auto it{std::lower_bound(std::begin(impl::uppers), std::end(impl::uppers), code)};
-        if(it != std::end(impl::uppers) && *it == code)
+        auto& page{output.pages[from[i] >> 8]};
+        if(page == 0)
         {
-            code = impl::lowers[std::distance(std::begin(impl::uppers), it)];
+            page = page_count++;
         }
 
-        output = Encoding::encode(code, output);
+        //If a codepoint appears more than once, the first mapping is used
+        auto& value{output.deltas[page][from[i] & 0xFF]};
+        if(value == 0)
+        {
+            value = static_cast<std::int16_t>(delta);
+        }
     }
 
     return output;
 }
 
-template<encoding Encoding, typename String = std::basic_string<typename Encoding::char_type>>
-constexpr String to_lower(const String& str)
+inline constexpr case_table lower_case_table{make_case_table(uppers, lowers)};
+inline constexpr case_table upper_case_table{make_case_table(lowers, uppers)};
+
+constexpr codepoint_t map_case(const case_table& table, codepoint_t code) noexcept
 {
-    String output{};
-    output.resize(std::size(str));
+    if(code > 0xFFFF)
+    {
+        return code;
+    }
+
+    return static_cast<codepoint_t>(static_cast<std::int32_t>(code) + table.deltas[table.pages[code >> 8]][code & 0xFF]);
+}
+
+//ASCII case change of "count" values, flipping bit 0x20 of letters
+template<bool Lower, typename InputChar, typename OutputChar>
+OutputChar* change_ascii_case(const InputChar* begin, std::size_t count, OutputChar* output) noexcept
+{
+    static_assert(sizeof(InputChar) == 1 && sizeof(OutputChar) == 1);
+
+    constexpr char first{Lower ? 'A' : 'a'};
+    constexpr char last{Lower ? 'Z' : 'z'};
 
-    to_lower<Encoding>(std::begin(str), std::end(str), std::begin(output));
+    const InputChar* const end{begin + count};
+
+#ifdef CAPTAL_FOUNDATION_SSE2
+    const auto lower_bound{_mm_set1_epi8(first - 1)};
+    const auto upper_bound{_mm_set1_epi8(last + 1)};
+    const auto flip{_mm_set1_epi8(0x20)};
+
+    for(; end - begin >= 16; begin += 16, output += 16)
+    {
+        const auto bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin))};
+        const auto letters{_mm_and_si128(_mm_cmpgt_epi8(bytes, lower_bound), _mm_cmplt_epi8(bytes, upper_bound))};
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_xor_si128(bytes, _mm_and_si128(letters, flip)));
+    }
+#endif
+
+    for(; begin != end; ++begin, ++output)
+    {
+        const auto value{static_cast<char>(*begin)};
+
+        *output = static_cast<OutputChar>(value >= first && value <= last ? value ^ 0x20 : value);
+    }
 
     return output;
 }
 
-template<encoding Encoding, std::input_iterator InputIt, std::output_iterator<typename Encoding::char_type> OutputIt>
-constexpr OutputIt to_upper(InputIt begin, InputIt end, OutputIt output)
+template<bool Lower, encoding Encoding, std::input_iterator InputIt, typename OutputIt>
+constexpr OutputIt change_case(InputIt begin, InputIt end, OutputIt output)
 {
+    constexpr const case_table& table{Lower ? lower_case_table : upper_case_table};
+
     while(begin < end)
     {
-        codepoint_t code{};
-        begin = Encoding::decode(begin, end, code);
-
-        const auto it{std::lower_bound(std::begin(impl::lowers), std::end(impl::lowers), code)};
-        if(it != std::end(impl::lowers) && *it == code)
+        if constexpr(std::is_base_of_v<utf8, Encoding> && std::contiguous_iterator<InputIt> && std::contiguous_iterator<OutputIt>)
         {
-            code = impl::uppers[std::distance(std::begin(impl::lowers), it)];
+            if(!std::is_constant_evaluated())
+            {
+                const auto address{std::to_address(begin)};
+
+                if(starts_ascii_run(address, address + (end - begin)))
+                {
+                    const auto count{ascii_length(address, address + (end - begin))};
+                    const auto output_address{std::to_address(output)};
+
+                    output += change_ascii_case<Lower>(address, count, output_address) - output_address;
+                    begin  += count;
+
+                    continue;
+                }
+            }
         }
 
-        output = Encoding::encode(code, output);
+        codepoint_t code{};
+        begin  = Encoding::decode(begin, end, code);
+        output = Encoding::encode(map_case(table, code), output);
     }
 
     return output;
 }
 
-template<encoding Encoding, typename String = std::basic_string<typename Encoding::char_type>>
-constexpr String to_upper(const String& str)
+//The case of a codepoint may not be encoded with the same length, the output is appended
+template<bool Lower, encoding Encoding, typename String>
+constexpr String change_case(const String& str)
 {
     String output{};
-    output.resize(std::size(str));
 
-    to_upper<Encoding>(std::begin(str), std::end(str), std::back_inserter(output));
+    if constexpr(reservable<String>)
+    {
+        output.reserve(std::size(str));
+    }
+
+    if constexpr(std::is_base_of_v<utf8, Encoding> && contiguous_resizable<String, typename Encoding::char_type> && std::contiguous_iterator<std::ranges::iterator_t<const String>>)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            constexpr const case_table& table{Lower ? lower_case_table : upper_case_table};
+
+            auto begin{std::to_address(std::begin(str))};
+            const auto end{begin + std::size(str)};
+
+            while(begin != end)
+            {
+                if(starts_ascii_run(begin, end))
+                {
+                    const auto count{ascii_length(begin, end)};
+                    const auto size{std::size(output)};
+
+                    output.resize(size + count);
+                    change_ascii_case<Lower>(begin, count, std::data(output) + size);
+                    begin += count;
+                }
+                else
+                {
+                    codepoint_t code{};
+                    begin = Encoding::decode(begin, end, code);
+                    Encoding::encode(map_case(table, code), std::back_inserter(output));
+                }
+            }
+
+            return output;
+        }
+    }
+
+    change_case<Lower, Encoding>(std::begin(str), std::end(str), std::back_inserter(output));
 
     return output;
 }
 
+}
+
+constexpr codepoint_t to_lower(codepoint_t code) noexcept
+{
+    return impl::map_case(impl::lower_case_table, code);
+}
+
+constexpr codepoint_t to_upper(codepoint_t code) noexcept
+{
+    return impl::map_case(impl::upper_case_table, code);
+}
+
+template<encoding Encoding, std::input_iterator InputIt, std::output_iterator<typename Encoding::char_type> OutputIt>
+constexpr OutputIt to_lower(InputIt begin, InputIt end, OutputIt output)
+{
+    return impl::change_case<true, Encoding>(begin, end, output);
+}
+
+template<encoding Encoding, typename String = std::basic_string<typename Encoding::char_type>>
+constexpr String to_lower(const String& str)
+{
+    return impl::change_case<true, Encoding>(str);
+}
+
+template<encoding Encoding, std::input_iterator InputIt, std::output_iterator<typename Encoding::char_type> OutputIt>
+constexpr OutputIt to_upper(InputIt begin, InputIt end, OutputIt output)
+{
+    return impl::change_case<false, Encoding>(begin, end, output);
+}
+
+template<encoding Encoding, typename String = std::basic_string<typename Encoding::char_type>>
+constexpr String to_upper(const String& str)
+{
+    return impl::change_case<false, Encoding>(str);
+}
+
 template<encoding Encoding, std::input_iterator InputIt>
 class decoder_iterator
 {
@@ -0,0 +1,251 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#ifndef CAPTAL_FOUNDATION_FRAME_ALLOCATOR_HPP_INCLUDED
+#define CAPTAL_FOUNDATION_FRAME_ALLOCATOR_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+#include <memory_resource>
+#include <vector>
+
+namespace cpt
+{
+
+inline namespace foundation
+{
+
+//Bump allocator for short-lived containers.
+//Deallocation only rewinds the last allocation, memory is reclaimed all at once when no allocation is alive anymore, or on reset.
+//If a frame needed more than one chunk, the chunks are merged into a single bigger one when rewinding, so a steady workload ends up with one heap allocation for the whole program.
+class frame_memory_resource final : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t default_chunk_size{1024 * 64};
+
+    struct statistics
+    {
+        std::uint64_t allocation_count{}; //Allocations served since last reset
+        std::uint64_t heap_allocation_count{}; //Chunks requested to the upstream resource since last reset
+        std::size_t peak_size{}; //Highest amount of memory in use since last reset
+    };
+
+public:
+    explicit frame_memory_resource(std::size_t chunk_size = default_chunk_size, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+    :m_upstream{upstream}
+    ,m_chunk_size{chunk_size}
+    {
+
+    }
+
+    ~frame_memory_resource()
+    {
+        release();
+    }
+
+    frame_memory_resource(const frame_memory_resource&) = delete;
+    frame_memory_resource& operator=(const frame_memory_resource&) = delete;
+    frame_memory_resource(frame_memory_resource&&) noexcept = delete;
+    frame_memory_resource& operator=(frame_memory_resource&&) noexcept = delete;
+
+    //All memory allocated by this resource must have been deallocated
+    void reset() noexcept
+    {
+        assert(m_live_count == 0 && "cpt::frame_memory_resource::reset called while some allocations are still alive.");
+
+        rewind();
+        m_statistics = statistics{};
+    }
+
+    const statistics& stats() const noexcept
+    {
+        return m_statistics;
+    }
+
+    std::size_t live_count() const noexcept
+    {
+        return m_live_count;
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        std::size_t output{};
+
+        for(auto* chunk{m_chunk}; chunk; chunk = chunk->next)
+        {
+            output += chunk->size;
+        }
+
+        return output;
+    }
+
+private:
+    struct alignas(std::max_align_t) chunk_header
+    {
+        chunk_header* next{};
+        std::size_t size{};
+    };
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        void* output{try_allocate(bytes, alignment)};
+
+        if(!output)
+        {
+            grow(bytes + alignment);
+            output = try_allocate(bytes, alignment);
+        }
+
+        ++m_live_count;
+        ++m_statistics.allocation_count;
+        m_statistics.peak_size = std::max(m_statistics.peak_size, m_previous_size + static_cast<std::size_t>(m_current - m_begin));
+
+        return output;
+    }
+
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment [[maybe_unused]]) noexcept override
+    {
+        assert(m_live_count > 0 && "cpt::frame_memory_resource::deallocate called more times than allocate.");
+
+        auto* const begin{static_cast<std::uint8_t*>(pointer)};
+
+        if(--m_live_count == 0)
+        {
+            rewind();
+        }
+        else if(begin + bytes == m_current) //Last allocation, typically a container that grows
+        {
+            m_current = begin;
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    void* try_allocate(std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if(!m_current)
+        {
+            return nullptr;
+        }
+
+        const auto address{reinterpret_cast<std::uintptr_t>(m_current)};
+        const auto aligned{(address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1)};
+        auto* const begin {m_current + (aligned - address)};
+
+        if(begin > m_end || static_cast<std::size_t>(m_end - begin) < bytes)
+        {
+            return nullptr;
+        }
+
+        m_current = begin + bytes;
+
+        return begin;
+    }
+
+    void grow(std::size_t minimum_size)
+    {
+        const std::size_t size{std::max(m_chunk_size, minimum_size)};
+
+        auto* const chunk{static_cast<chunk_header*>(m_upstream->allocate(sizeof(chunk_header) + size, alignof(chunk_header)))};
+        chunk->next = m_chunk;
+        chunk->size = size;
+
+        if(m_chunk)
+        {
+            m_previous_size += static_cast<std::size_t>(m_current - m_begin);
+        }
+
+        m_chunk = chunk;
+        m_begin = reinterpret_cast<std::uint8_t*>(chunk + 1);
+        m_current = m_begin;
+        m_end = m_begin + size;
+
+        ++m_statistics.heap_allocation_count;
+    }
+
+    void rewind() noexcept
+    {
+        if(m_chunk && m_chunk->next) //The next chunk will be big enough to hold all the memory we needed
+        {
+            m_chunk_size = std::max(m_chunk_size, capacity());
+            release();
+        }
+
+        m_current = m_begin;
+        m_previous_size = 0;
+    }
+
+    void release() noexcept
+    {
+        while(m_chunk)
+        {
+            chunk_header* const next{m_chunk->next};
+            m_upstream->deallocate(m_chunk, sizeof(chunk_header) + m_chunk->size, alignof(chunk_header));
+            m_chunk = next;
+        }
+
+        m_begin = nullptr;
+        m_current = nullptr;
+        m_end = nullptr;
+    }
+
+private:
+    std::pmr::memory_resource* m_upstream{};
+    std::size_t m_chunk_size{};
+    chunk_header* m_chunk{};
+    std::uint8_t* m_begin{};
+    std::uint8_t* m_current{};
+    std::uint8_t* m_end{};
+    std::size_t m_previous_size{};
+    std::size_t m_live_count{};
+    statistics m_statistics{};
+};
+
+//The calling thread's frame arena, the engine resets the one of the main thread every frame
+inline frame_memory_resource& frame_memory() noexcept
+{
+    thread_local frame_memory_resource resource{};
+
+    return resource;
+}
+
+template<typename T>
+using frame_vector = std::pmr::vector<T>;
+
+template<typename T>
+frame_vector<T> make_frame_vector()
+{
+    return frame_vector<T>{&frame_memory()};
+}
+
+}
+
+}
+
+#endif
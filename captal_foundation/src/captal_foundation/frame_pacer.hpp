@@ -0,0 +1,262 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_FOUNDATION_FRAME_PACER_HPP_INCLUDED
+#define CAPTAL_FOUNDATION_FRAME_PACER_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace cpt
+{
+
+inline namespace foundation
+{
+
+//Default clock of frame pacers. Any type with the same interface can replace it (e.g. a manual clock in tests).
+struct steady_frame_clock
+{
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<std::chrono::steady_clock, duration>;
+
+    time_point now() const noexcept
+    {
+        return std::chrono::time_point_cast<duration>(std::chrono::steady_clock::now());
+    }
+
+    void sleep_for(duration time) const
+    {
+        std::this_thread::sleep_for(time);
+    }
+
+    //Called between two reads of now() while spinning
+    void relax() const noexcept
+    {
+        std::this_thread::yield();
+    }
+};
+
+struct frame_time_percentiles
+{
+    std::chrono::nanoseconds p50{};
+    std::chrono::nanoseconds p95{};
+    std::chrono::nanoseconds p99{};
+    std::chrono::nanoseconds max{};
+};
+
+//Limits the frame rate on an absolute timeline: deadlines are start + n * period, so waiting errors never accumulate.
+//Waits sleep until the spin threshold, then spin on the clock, OS sleeps are too coarse to hit a deadline on their own.
+//It also keeps the last frame times to compute percentiles.
+template<typename Clock = steady_frame_clock>
+class basic_frame_pacer
+{
+public:
+    using clock_type = Clock;
+    using duration = typename Clock::duration;
+    using time_point = typename Clock::time_point;
+
+    static constexpr std::size_t default_history_size{256};
+    static constexpr duration default_spin_threshold{std::chrono::milliseconds{2}};
+
+public:
+    explicit basic_frame_pacer(Clock clock = Clock{}, std::size_t history_size = default_history_size)
+    :m_clock{std::move(clock)}
+    ,m_last_frame{m_clock.now()}
+    ,m_deadline{m_last_frame}
+    {
+        m_history.resize(std::max(history_size, std::size_t{1}));
+    }
+
+    ~basic_frame_pacer() = default;
+    basic_frame_pacer(const basic_frame_pacer&) = delete;
+    basic_frame_pacer& operator=(const basic_frame_pacer&) = delete;
+    basic_frame_pacer(basic_frame_pacer&&) noexcept = default;
+    basic_frame_pacer& operator=(basic_frame_pacer&&) noexcept = default;
+
+    //0 disables the limit
+    void set_frame_rate(std::uint32_t frame_per_second) noexcept
+    {
+        if(frame_per_second == 0)
+        {
+            set_period(duration::zero());
+        }
+        else
+        {
+            set_period(std::chrono::duration_cast<duration>(std::chrono::duration<double>{1.0 / static_cast<double>(frame_per_second)}));
+        }
+    }
+
+    void set_period(duration period) noexcept
+    {
+        m_period = period;
+        m_deadline = m_last_frame + period;
+    }
+
+    void set_spin_threshold(duration threshold) noexcept
+    {
+        m_spin_threshold = threshold;
+    }
+
+    //Moves the timeline so deadlines fall on reference + n * period (e.g. reference is the time of a present).
+    //The next deadline moves by half a period at most.
+    void align(time_point reference) noexcept
+    {
+        if(m_period <= duration::zero())
+        {
+            return;
+        }
+
+        auto offset{(m_deadline - reference) % m_period};
+        if(offset < duration::zero())
+        {
+            offset += m_period;
+        }
+
+        if(offset * 2 > m_period)
+        {
+            m_deadline += m_period - offset;
+        }
+        else
+        {
+            m_deadline -= offset;
+        }
+    }
+
+    //Waits for the next deadline (if any), then returns the time since the previous call
+    duration next_frame()
+    {
+        if(m_period > duration::zero())
+        {
+            wait_until(m_deadline);
+        }
+
+        const auto now{m_clock.now()};
+
+        if(m_period > duration::zero())
+        {
+            m_deadline += m_period;
+
+            //More than a period late, the timeline restarts instead of rushing the next frames to catch up
+            if(now > m_deadline)
+            {
+                m_deadline = now + m_period;
+            }
+        }
+
+        const auto frame_time{now - m_last_frame};
+        m_last_frame = now;
+
+        m_history[m_history_index] = frame_time;
+        m_history_index = (m_history_index + 1) % std::size(m_history);
+        m_history_count = std::min(m_history_count + 1, std::size(m_history));
+
+        return frame_time;
+    }
+
+    //Over the last frames (up to the history size)
+    frame_time_percentiles percentiles() const
+    {
+        if(m_history_count == 0)
+        {
+            return frame_time_percentiles{};
+        }
+
+        std::vector<duration> sorted{std::begin(m_history), std::begin(m_history) + static_cast<std::ptrdiff_t>(m_history_count)};
+        std::sort(std::begin(sorted), std::end(sorted));
+
+        //Nearest-rank method
+        const auto rank = [&sorted](double percentile)
+        {
+            const auto index{static_cast<std::size_t>(std::ceil(percentile * static_cast<double>(std::size(sorted))))};
+
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(sorted[std::clamp<std::size_t>(index, 1, std::size(sorted)) - 1]);
+        };
+
+        return frame_time_percentiles{rank(0.50), rank(0.95), rank(0.99), std::chrono::duration_cast<std::chrono::nanoseconds>(sorted.back())};
+    }
+
+    duration period() const noexcept
+    {
+        return m_period;
+    }
+
+    duration spin_threshold() const noexcept
+    {
+        return m_spin_threshold;
+    }
+
+    time_point next_deadline() const noexcept
+    {
+        return m_deadline;
+    }
+
+    const Clock& clock() const noexcept
+    {
+        return m_clock;
+    }
+
+private:
+    void wait_until(time_point deadline)
+    {
+        auto now{m_clock.now()};
+        if(now >= deadline)
+        {
+            return;
+        }
+
+        if(deadline - now > m_spin_threshold)
+        {
+            m_clock.sleep_for(deadline - now - m_spin_threshold);
+            now = m_clock.now();
+        }
+
+        while(now < deadline)
+        {
+            m_clock.relax();
+            now = m_clock.now();
+        }
+    }
+
+private:
+    Clock m_clock{};
+    time_point m_last_frame{};
+    time_point m_deadline{};
+    duration m_period{};
+    duration m_spin_threshold{default_spin_threshold};
+    std::vector<duration> m_history{};
+    std::size_t m_history_index{};
+    std::size_t m_history_count{};
+};
+
+using frame_pacer = basic_frame_pacer<>;
+
+}
+
+}
+
+#endif
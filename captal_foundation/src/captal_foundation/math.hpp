@@ -24,12 +24,23 @@
 #define CAPTAL_FOUNDATION_MATH_HPP_INCLUDED
 
 #include <array>
+#include <span>
 #include <cstdint>
+#include <cassert>
 #include <concepts>
 #include <ranges>
 #include <type_traits>
+#include <algorithm>
 #include <cmath>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define CAPTAL_FOUNDATION_SSE
+    #include <xmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #define CAPTAL_FOUNDATION_NEON
+    #include <arm_neon.h>
+#endif
+
 namespace cpt
 {
 
@@ -249,7 +260,7 @@ public:
     constexpr vec() noexcept = default;
 
     constexpr explicit vec(value_type value) noexcept
-    :parent_type{value, value, value}
+    :parent_type{value, value, value, value}
     {
 
     }
@@ -333,6 +344,121 @@ public:
     using parent_type::crend;
 };
 
+//vec4f and mat4f operations use SSE or NEON at runtime, the generic loops are still used in constant evaluation
+namespace impl
+{
+
+template<typename T, std::size_t Size>
+inline constexpr bool is_simd_vec{false};
+
+#if defined(CAPTAL_FOUNDATION_SSE) || defined(CAPTAL_FOUNDATION_NEON)
+
+template<>
+inline constexpr bool is_simd_vec<float, 4>{true};
+
+#endif
+
+#if defined(CAPTAL_FOUNDATION_SSE)
+
+using simd_type = __m128;
+
+inline simd_type load(const vec<float, 4>& vector) noexcept
+{
+    return _mm_loadu_ps(std::data(vector));
+}
+
+inline vec<float, 4> store(simd_type value) noexcept
+{
+    vec<float, 4> output;
+    _mm_storeu_ps(std::data(output), value);
+
+    return output;
+}
+
+inline simd_type add(simd_type left, simd_type right) noexcept
+{
+    return _mm_add_ps(left, right);
+}
+
+inline simd_type sub(simd_type left, simd_type right) noexcept
+{
+    return _mm_sub_ps(left, right);
+}
+
+inline simd_type mul(simd_type left, simd_type right) noexcept
+{
+    return _mm_mul_ps(left, right);
+}
+
+inline simd_type div(simd_type left, simd_type right) noexcept
+{
+    return _mm_div_ps(left, right);
+}
+
+inline simd_type broadcast(float value) noexcept
+{
+    return _mm_set1_ps(value);
+}
+
+inline float horizontal_sum(simd_type value) noexcept
+{
+    const auto high{_mm_movehl_ps(value, value)};
+    const auto sum{_mm_add_ps(value, high)};
+
+    return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55)));
+}
+
+#elif defined(CAPTAL_FOUNDATION_NEON)
+
+using simd_type = float32x4_t;
+
+inline simd_type load(const vec<float, 4>& vector) noexcept
+{
+    return vld1q_f32(std::data(vector));
+}
+
+inline vec<float, 4> store(simd_type value) noexcept
+{
+    vec<float, 4> output;
+    vst1q_f32(std::data(output), value);
+
+    return output;
+}
+
+inline simd_type add(simd_type left, simd_type right) noexcept
+{
+    return vaddq_f32(left, right);
+}
+
+inline simd_type sub(simd_type left, simd_type right) noexcept
+{
+    return vsubq_f32(left, right);
+}
+
+inline simd_type mul(simd_type left, simd_type right) noexcept
+{
+    return vmulq_f32(left, right);
+}
+
+inline simd_type div(simd_type left, simd_type right) noexcept
+{
+    return vdivq_f32(left, right);
+}
+
+inline simd_type broadcast(float value) noexcept
+{
+    return vdupq_n_f32(value);
+}
+
+inline float horizontal_sum(simd_type value) noexcept
+{
+    return vaddvq_f32(value);
+}
+
+#endif
+
+}
+
 template<typename T, std::size_t Size>
 constexpr bool operator==(const vec<T, Size>& left, const vec<T, Size>& right) noexcept
 {
@@ -348,6 +474,14 @@ constexpr auto operator<=>(const vec<T, Size>& left, const vec<T, Size>& right)
 template<arithmetic T, std::size_t Size>
 constexpr vec<T, Size> operator+(const vec<T, Size>& left, const vec<T, Size>& right) noexcept
 {
+    if constexpr(impl::is_simd_vec<T, Size>)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            return impl::store(impl::add(impl::load(left), impl::load(right)));
+        }
+    }
+
     vec<T, Size> output{};
 
     for(std::size_t i{}; i < Size; ++i)
@@ -382,6 +516,14 @@ constexpr vec<T, Size> operator-(const vec<T, Size>& vector) noexcept
 template<arithmetic T, std::size_t Size>
 constexpr vec<T, Size> operator-(const vec<T, Size>& left, const vec<T, Size>& right) noexcept
 {
+    if constexpr(impl::is_simd_vec<T, Size>)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            return impl::store(impl::sub(impl::load(left), impl::load(right)));
+        }
+    }
+
     vec<T, Size> output{};
 
     for(std::size_t i{}; i < Size; ++i)
@@ -403,6 +545,14 @@ constexpr vec<T, Size>& operator-=(vec<T, Size>& left, const vec<T, Size>& right
 template<arithmetic T, std::size_t Size>
 constexpr vec<T, Size> operator*(const vec<T, Size>& left, const vec<T, Size>& right) noexcept
 {
+    if constexpr(impl::is_simd_vec<T, Size>)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            return impl::store(impl::mul(impl::load(left), impl::load(right)));
+        }
+    }
+
     vec<T, Size> output{};
 
     for(std::size_t i{}; i < Size; ++i)
@@ -424,6 +574,14 @@ constexpr vec<T, Size>& operator*=(vec<T, Size>& left, const vec<T, Size>& right
 template<arithmetic T, std::size_t Size>
 constexpr vec<T, Size> operator/(const vec<T, Size>& left, const vec<T, Size>& right) noexcept
 {
+    if constexpr(impl::is_simd_vec<T, Size>)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            return impl::store(impl::div(impl::load(left), impl::load(right)));
+        }
+    }
+
     vec<T, Size> output{};
 
     for(std::size_t i{}; i < Size; ++i)
@@ -445,6 +603,14 @@ constexpr vec<T, Size>& operator/=(vec<T, Size>& left, const vec<T, Size>& right
 template<arithmetic T, std::size_t Size>
 constexpr T dot(const vec<T, Size>& left, const vec<T, Size>& right) noexcept
 {
+    if constexpr(impl::is_simd_vec<T, Size>)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            return impl::horizontal_sum(impl::mul(impl::load(left), impl::load(right)));
+        }
+    }
+
     T output{};
 
     for(std::size_t i{}; i < Size; ++i)
@@ -869,9 +1035,56 @@ constexpr mat<T, Rows, Cols>& operator-=(mat<T, Rows, Cols>& left, const mat<T,
     return left;
 }
 
+namespace impl
+{
+
+#if defined(CAPTAL_FOUNDATION_SSE) || defined(CAPTAL_FOUNDATION_NEON)
+
+//Row i of the output is the sum of the rows of right weighted by left[i]
+inline mat<float, 4, 4> multiply(const mat<float, 4, 4>& left, const mat<float, 4, 4>& right) noexcept
+{
+    const simd_type rows[4]{load(right[0]), load(right[1]), load(right[2]), load(right[3])};
+
+    mat<float, 4, 4> output;
+
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        auto row{mul(broadcast(left[i][0]), rows[0])};
+        row = add(row, mul(broadcast(left[i][1]), rows[1]));
+        row = add(row, mul(broadcast(left[i][2]), rows[2]));
+        row = add(row, mul(broadcast(left[i][3]), rows[3]));
+
+        output[i] = store(row);
+    }
+
+    return output;
+}
+
+inline vec<float, 4> multiply(const mat<float, 4, 4>& left, const vec<float, 4>& right) noexcept
+{
+    const auto vector{load(right)};
+
+    return vec<float, 4>{horizontal_sum(mul(load(left[0]), vector)),
+                         horizontal_sum(mul(load(left[1]), vector)),
+                         horizontal_sum(mul(load(left[2]), vector)),
+                         horizontal_sum(mul(load(left[3]), vector))};
+}
+
+#endif
+
+}
+
 template<arithmetic T, std::size_t Size1, std::size_t Size2, std::size_t Size3>
 constexpr mat<T, Size1, Size3> operator*(const mat<T, Size1, Size2>& left, const mat<T, Size2, Size3>& right) noexcept
 {
+    if constexpr(impl::is_simd_vec<T, Size1> && Size1 == Size2 && Size2 == Size3)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            return impl::multiply(left, right);
+        }
+    }
+
     mat<T, Size1, Size3> output{};
 
     for(std::size_t i{}; i < Size1; ++i)
@@ -891,6 +1104,14 @@ constexpr mat<T, Size1, Size3> operator*(const mat<T, Size1, Size2>& left, const
 template<arithmetic T, std::size_t Rows, std::size_t Cols>
 constexpr vec<T, Rows> operator*(const mat<T, Rows, Cols>& left, const vec<T, Cols>& right) noexcept
 {
+    if constexpr(impl::is_simd_vec<T, Rows> && Rows == Cols)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            return impl::multiply(left, right);
+        }
+    }
+
     vec<T, Rows> output{};
 
     for(std::size_t i{}; i < Rows; ++i)
@@ -1091,6 +1312,88 @@ mat<T, 4, 4> model(const vec<T, 3>& translation, T angle, const vec<T, 3>& axis,
     return scale(factor) * translate(translation) * rotate(angle, axis) * translate(-origin);
 }
 
+namespace impl
+{
+
+template<std::floating_point T>
+constexpr mat<T, 4, 4> model_2d(const vec<T, 3>& translation, T cos, T sin, const vec<T, 3>& factor, const vec<T, 3>& origin) noexcept
+{
+    //scale(factor) * translate(translation) * rotate(angle, z) * translate(-origin), expanded
+    const T x{translation[0] - cos * origin[0] + sin * origin[1]};
+    const T y{translation[1] - sin * origin[0] - cos * origin[1]};
+    const T z{translation[2] - origin[2]};
+
+    return mat<T, 4, 4>
+    {
+        vec<T, 4>{factor[0] * cos, -factor[0] * sin, T{}, factor[0] * x},
+        vec<T, 4>{factor[1] * sin, factor[1] * cos, T{}, factor[1] * y},
+        vec<T, 4>{T{}, T{}, factor[2], factor[2] * z},
+        vec<T, 4>{T{}, T{}, T{}, static_cast<T>(1)}
+    };
+}
+
+//Branchless polynomial sine and cosine, so loops calling it can be vectorized. Max error is about 1e-5 for floats.
+//The angle must fit in an int32 once divided by 2 pi.
+template<std::floating_point T>
+constexpr void sincos(T angle, T& sin, T& cos) noexcept
+{
+    constexpr T pi{static_cast<T>(3.14159265358979323846)};
+    constexpr T half_pi{pi / 2};
+    constexpr T two_pi{pi * 2};
+
+    //Reduce to [-pi; pi], then to [-pi/2; pi/2] using sin(pi - x) = sin(x) and cos(pi - x) = -cos(x)
+    const T turns{angle / two_pi};
+    const T x{angle - two_pi * static_cast<T>(static_cast<std::int32_t>(turns + std::copysign(static_cast<T>(0.5), turns)))};
+    const T reflect{std::abs(x) > half_pi ? static_cast<T>(1) : T{}}; //Not a bool, to keep it vectorizable
+    const T r{x + reflect * (std::copysign(pi, x) - x - x)};
+    const T sign{static_cast<T>(1) - reflect - reflect};
+    const T r2{r * r};
+
+    sin = r * (static_cast<T>(1) + r2 * (static_cast<T>(-1.0 / 6.0) + r2 * (static_cast<T>(1.0 / 120.0) + r2 * (static_cast<T>(-1.0 / 5040.0)
+        + r2 * (static_cast<T>(1.0 / 362880.0) + r2 * static_cast<T>(-1.0 / 39916800.0))))));
+
+    cos = sign * (static_cast<T>(1) + r2 * (static_cast<T>(-1.0 / 2.0) + r2 * (static_cast<T>(1.0 / 24.0) + r2 * (static_cast<T>(-1.0 / 720.0)
+        + r2 * (static_cast<T>(1.0 / 40320.0) + r2 * (static_cast<T>(-1.0 / 3628800.0) + r2 * static_cast<T>(1.0 / 479001600.0)))))));
+}
+
+}
+
+//Same as model(translation, angle, vec3{0, 0, 1}, factor, origin), but computed directly
+template<std::floating_point T>
+mat<T, 4, 4> model_2d(const vec<T, 3>& translation, T angle, const vec<T, 3>& factor, const vec<T, 3>& origin) noexcept
+{
+    return impl::model_2d(translation, std::cos(angle), std::sin(angle), factor, origin);
+}
+
+//Batched model_2d, each attribute has its own array (as stored by an ECS).
+//Sines and cosines are computed by blocks with a branchless approximation in a separate loop, so the compiler can vectorize it.
+template<std::floating_point T>
+void model_2d(std::span<const vec<T, 3>> translations, std::span<const T> angles, std::span<const vec<T, 3>> factors, std::span<const vec<T, 3>> origins, std::span<mat<T, 4, 4>> output) noexcept
+{
+    assert(std::size(angles) == std::size(translations) && std::size(factors) == std::size(translations) && std::size(origins) == std::size(translations) && "cpt::model_2d called with arrays of different sizes");
+    assert(std::size(output) >= std::size(translations) && "cpt::model_2d output is too small");
+
+    constexpr std::size_t block_size{64};
+
+    std::array<T, block_size> cos;
+    std::array<T, block_size> sin;
+
+    for(std::size_t begin{}; begin < std::size(translations); begin += block_size)
+    {
+        const auto count{std::min(block_size, std::size(translations) - begin)};
+
+        for(std::size_t i{}; i < count; ++i)
+        {
+            impl::sincos(angles[begin + i], sin[i], cos[i]);
+        }
+
+        for(std::size_t i{}; i < count; ++i)
+        {
+            output[begin + i] = impl::model_2d(translations[begin + i], cos[i], sin[i], factors[begin + i], origins[begin + i]);
+        }
+    }
+}
+
 /* this is a cool effect :)
 template<arithmetic T>
 mat<T, 4, 4> rotate_and_scale(const vec<T, 3>& translation, T angle, const vec<T, 3>& axis, const vec<T, 3>& factor, const vec<T, 3>& origin)
@@ -0,0 +1,188 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#ifndef CAPTAL_FOUNDATION_MPSC_QUEUE_HPP_INCLUDED
+#define CAPTAL_FOUNDATION_MPSC_QUEUE_HPP_INCLUDED
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <new>
+
+namespace cpt
+{
+
+inline namespace foundation
+{
+
+//Unbounded lock-free queue, any thread can push, only one thread can pop at a time.
+//Values pushed by the same thread are popped in the same order.
+//A pop concurrent with a push may not see the pushed value yet, it will on a later pop.
+template<typename T, typename Allocator = std::allocator<T>>
+class mpsc_queue
+{
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+
+private:
+    struct node
+    {
+        std::atomic<node*> next{};
+        alignas(T) std::byte storage[sizeof(T)];
+
+        T& value() noexcept
+        {
+            return *std::launder(reinterpret_cast<T*>(&storage));
+        }
+    };
+
+    using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+    using node_allocator_traits = std::allocator_traits<node_allocator_type>;
+
+public:
+    mpsc_queue()
+    :mpsc_queue{Allocator{}}
+    {
+
+    }
+
+    explicit mpsc_queue(const Allocator& allocator)
+    :m_allocator{allocator}
+    ,m_tail{make_node()}
+    {
+        m_head.store(m_tail, std::memory_order_relaxed);
+    }
+
+    ~mpsc_queue()
+    {
+        while(try_pop())
+        {
+
+        }
+
+        free_node(m_tail);
+    }
+
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+    mpsc_queue(mpsc_queue&&) noexcept = delete;
+    mpsc_queue& operator=(mpsc_queue&&) noexcept = delete;
+
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        node* const new_node{make_node()};
+
+        try
+        {
+            ::new(&new_node->storage) T{std::forward<Args>(args)...};
+        }
+        catch(...)
+        {
+            free_node(new_node);
+            throw;
+        }
+
+        node* const previous{m_head.exchange(new_node, std::memory_order_acq_rel)};
+        previous->next.store(new_node, std::memory_order_release);
+    }
+
+    void push(const T& value)
+    {
+        emplace(value);
+    }
+
+    void push(T&& value)
+    {
+        emplace(std::move(value));
+    }
+
+    //Consumer only
+    std::optional<T> try_pop()
+    {
+        node* const next{m_tail->next.load(std::memory_order_acquire)};
+
+        if(!next)
+        {
+            return std::nullopt;
+        }
+
+        //next becomes the new dummy node once its value has been moved out
+        std::optional<T> output{std::move(next->value())};
+        next->value().~T();
+
+        free_node(std::exchange(m_tail, next));
+
+        return output;
+    }
+
+    //Consumer only, returns the number of values popped
+    template<typename Func>
+    std::size_t drain(Func&& func)
+    {
+        std::size_t count{};
+
+        while(auto value{try_pop()})
+        {
+            func(std::move(*value));
+            ++count;
+        }
+
+        return count;
+    }
+
+    //Consumer only, the answer may already be outdated when it returns
+    bool empty() const noexcept
+    {
+        return !m_tail->next.load(std::memory_order_acquire);
+    }
+
+private:
+    node* make_node()
+    {
+        node* const output{node_allocator_traits::allocate(m_allocator, 1)};
+        ::new(output) node;
+
+        return output;
+    }
+
+    void free_node(node* value) noexcept
+    {
+        value->~node();
+        node_allocator_traits::deallocate(m_allocator, value, 1);
+    }
+
+private:
+    node_allocator_type m_allocator;
+    node* m_tail{};
+    alignas(64) std::atomic<node*> m_head{};
+};
+
+}
+
+}
+
+#endif
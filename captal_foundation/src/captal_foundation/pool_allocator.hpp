@@ -0,0 +1,452 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#ifndef CAPTAL_FOUNDATION_POOL_ALLOCATOR_HPP_INCLUDED
+#define CAPTAL_FOUNDATION_POOL_ALLOCATOR_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <new>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+namespace cpt
+{
+
+inline namespace foundation
+{
+
+//Enough room for a T plus the bookkeeping std::allocate_shared or a node based container puts next to it
+template<typename T>
+inline constexpr std::size_t node_block_size{sizeof(T) + 4 * sizeof(void*)};
+
+template<typename T>
+inline constexpr std::size_t node_block_align{std::max(alignof(T), alignof(void*))};
+
+//Fixed-size block allocator, blocks are carved in slabs and never move.
+//Allocations that do not fit in a block are forwarded to operator new.
+//If thread_cache_size is not 0, each thread keeps up to that many free blocks for itself, so most allocations and deallocations do not lock.
+//Slabs are released once the pool and all thread caches referencing it are gone.
+class slab_pool
+{
+public:
+    static constexpr std::size_t default_slab_block_count{64};
+
+    struct statistics
+    {
+        std::size_t live_count{}; //Blocks in use
+        std::size_t slab_count{};
+        std::size_t block_count{}; //Blocks in all slabs, live_count / block_count is the occupancy
+        std::size_t fallback_count{}; //Allocations forwarded to operator new
+    };
+
+private:
+    struct free_block
+    {
+        free_block* next{};
+    };
+
+    struct state
+    {
+        std::size_t block_size{};
+        std::size_t block_align{};
+        std::size_t slab_block_count{};
+        std::size_t thread_cache_size{};
+        std::mutex mutex{};
+        free_block* free_list{};
+        std::vector<void*> slabs{};
+        std::atomic<std::size_t> live_count{};
+        std::atomic<std::size_t> fallback_count{};
+
+        ~state()
+        {
+            for(auto slab : slabs)
+            {
+                ::operator delete(slab, block_size * slab_block_count, std::align_val_t{block_align});
+            }
+        }
+    };
+
+    struct thread_cache
+    {
+        std::shared_ptr<state> owner{};
+        free_block* head{};
+        std::size_t count{};
+
+        thread_cache() = default;
+
+        explicit thread_cache(std::shared_ptr<state> pool_state) noexcept
+        :owner{std::move(pool_state)}
+        {
+
+        }
+
+        ~thread_cache()
+        {
+            if(owner && head)
+            {
+                std::lock_guard lock{owner->mutex};
+                give_back(*owner, *this, count);
+            }
+        }
+
+        thread_cache(const thread_cache&) = delete;
+        thread_cache& operator=(const thread_cache&) = delete;
+
+        thread_cache(thread_cache&& other) noexcept
+        :owner{std::move(other.owner)}
+        ,head{std::exchange(other.head, nullptr)}
+        ,count{std::exchange(other.count, 0)}
+        {
+
+        }
+
+        thread_cache& operator=(thread_cache&& other) noexcept = delete;
+    };
+
+public:
+    explicit slab_pool(std::size_t block_size, std::size_t block_align = alignof(std::max_align_t), std::size_t slab_block_count = default_slab_block_count, std::size_t thread_cache_size = 0)
+    :m_state{std::make_shared<state>()}
+    {
+        assert(block_align > 0 && (block_align & (block_align - 1)) == 0 && "cpt::slab_pool block alignment must be a power of two.");
+        assert(slab_block_count > 0 && "cpt::slab_pool slabs must contain at least one block.");
+
+        block_align = std::max(block_align, alignof(free_block));
+
+        m_state->block_size = (std::max(block_size, sizeof(free_block)) + block_align - 1) & ~(block_align - 1);
+        m_state->block_align = block_align;
+        m_state->slab_block_count = slab_block_count;
+        m_state->thread_cache_size = thread_cache_size;
+    }
+
+    ~slab_pool() = default;
+    slab_pool(const slab_pool&) = delete;
+    slab_pool& operator=(const slab_pool&) = delete;
+    slab_pool(slab_pool&&) noexcept = delete;
+    slab_pool& operator=(slab_pool&&) noexcept = delete;
+
+    void* allocate(std::size_t size, std::size_t align)
+    {
+        if(!fit(size, align))
+        {
+            m_state->fallback_count.fetch_add(1, std::memory_order_relaxed);
+
+            return ::operator new(size, std::align_val_t{align});
+        }
+
+        free_block* block{};
+
+        if(m_state->thread_cache_size > 0)
+        {
+            auto& cache{local_cache()};
+
+            if(!cache.head)
+            {
+                std::lock_guard lock{m_state->mutex};
+                refill(cache);
+            }
+
+            block = std::exchange(cache.head, cache.head->next);
+            --cache.count;
+        }
+        else
+        {
+            std::lock_guard lock{m_state->mutex};
+
+            if(!m_state->free_list)
+            {
+                grow(*m_state);
+            }
+
+            block = std::exchange(m_state->free_list, m_state->free_list->next);
+        }
+
+        m_state->live_count.fetch_add(1, std::memory_order_relaxed);
+
+        return block;
+    }
+
+    void deallocate(void* pointer, std::size_t size, std::size_t align) noexcept
+    {
+        if(!fit(size, align))
+        {
+            ::operator delete(pointer, size, std::align_val_t{align});
+
+            return;
+        }
+
+        m_state->live_count.fetch_sub(1, std::memory_order_relaxed);
+
+        auto* const block{::new(pointer) free_block{}};
+
+        if(m_state->thread_cache_size > 0)
+        {
+            if(auto* const cache{find_cache()}; cache)
+            {
+                block->next = std::exchange(cache->head, block);
+                ++cache->count;
+
+                if(cache->count > m_state->thread_cache_size) //Keep half of the blocks, so the next allocations don't refill right away
+                {
+                    std::lock_guard lock{m_state->mutex};
+                    give_back(*m_state, *cache, cache->count - m_state->thread_cache_size / 2);
+                }
+
+                return;
+            }
+        }
+
+        std::lock_guard lock{m_state->mutex};
+        block->next = std::exchange(m_state->free_list, block);
+    }
+
+    statistics stats() const
+    {
+        std::lock_guard lock{m_state->mutex};
+
+        statistics output{};
+        output.live_count = m_state->live_count.load(std::memory_order_relaxed);
+        output.slab_count = std::size(m_state->slabs);
+        output.block_count = std::size(m_state->slabs) * m_state->slab_block_count;
+        output.fallback_count = m_state->fallback_count.load(std::memory_order_relaxed);
+
+        return output;
+    }
+
+    std::size_t block_size() const noexcept
+    {
+        return m_state->block_size;
+    }
+
+    std::size_t block_align() const noexcept
+    {
+        return m_state->block_align;
+    }
+
+private:
+    static std::vector<thread_cache>& thread_caches() noexcept
+    {
+        thread_local std::vector<thread_cache> caches{};
+
+        return caches;
+    }
+
+    static void grow(state& pool_state)
+    {
+        auto* const slab{static_cast<std::uint8_t*>(::operator new(pool_state.block_size * pool_state.slab_block_count, std::align_val_t{pool_state.block_align}))};
+        pool_state.slabs.emplace_back(slab);
+
+        for(std::size_t i{pool_state.slab_block_count}; i > 0; --i)
+        {
+            auto* const block{::new(slab + (i - 1) * pool_state.block_size) free_block{}};
+            block->next = std::exchange(pool_state.free_list, block);
+        }
+    }
+
+    //Pool mutex must be locked
+    static void give_back(state& pool_state, thread_cache& cache, std::size_t count) noexcept
+    {
+        for(std::size_t i{}; i < count; ++i)
+        {
+            free_block* const block{std::exchange(cache.head, cache.head->next)};
+            block->next = std::exchange(pool_state.free_list, block);
+        }
+
+        cache.count -= count;
+    }
+
+    bool fit(std::size_t size, std::size_t align) const noexcept
+    {
+        return size <= m_state->block_size && align <= m_state->block_align;
+    }
+
+    thread_cache* find_cache() noexcept
+    {
+        for(auto& cache : thread_caches())
+        {
+            if(cache.owner == m_state)
+            {
+                return &cache;
+            }
+        }
+
+        return nullptr;
+    }
+
+    thread_cache& local_cache()
+    {
+        if(auto* const cache{find_cache()}; cache)
+        {
+            return *cache;
+        }
+
+        return thread_caches().emplace_back(m_state);
+    }
+
+    //Pool mutex must be locked
+    void refill(thread_cache& cache)
+    {
+        const std::size_t count{std::max<std::size_t>(m_state->thread_cache_size / 2, 1)};
+
+        for(std::size_t i{}; i < count; ++i)
+        {
+            if(!m_state->free_list)
+            {
+                grow(*m_state);
+            }
+
+            free_block* const block{std::exchange(m_state->free_list, m_state->free_list->next)};
+            block->next = std::exchange(cache.head, block);
+        }
+
+        cache.count += count;
+    }
+
+private:
+    std::shared_ptr<state> m_state{};
+};
+
+template<typename T>
+class pool_allocator
+{
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+public:
+    template<typename U>
+    struct rebind
+    {
+        using other = pool_allocator<U>;
+    };
+
+public:
+    pool_allocator() noexcept = default;
+
+    pool_allocator(slab_pool& pool) noexcept
+    :m_pool{&pool}
+    {
+
+    }
+
+    template<typename U>
+    pool_allocator(const pool_allocator<U>& other) noexcept
+    :m_pool{other.m_pool}
+    {
+
+    }
+
+    ~pool_allocator() = default;
+    pool_allocator(const pool_allocator&) noexcept = default;
+    pool_allocator& operator=(const pool_allocator&) noexcept = default;
+    pool_allocator(pool_allocator&&) noexcept = default;
+    pool_allocator& operator=(pool_allocator&&) noexcept = default;
+
+    T* allocate(std::size_t count)
+    {
+        if(!m_pool) //Default constructed allocator, fallback on new
+        {
+            return static_cast<T*>(::operator new(sizeof(T) * count, std::align_val_t{alignof(T)}));
+        }
+
+        return static_cast<T*>(m_pool->allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t count) noexcept
+    {
+        if(!m_pool)
+        {
+            ::operator delete(ptr, sizeof(T) * count, std::align_val_t{alignof(T)});
+        }
+        else
+        {
+            m_pool->deallocate(ptr, sizeof(T) * count, alignof(T));
+        }
+    }
+
+    slab_pool* memory_pool() const noexcept
+    {
+        return m_pool;
+    }
+
+public:
+    slab_pool* m_pool{}; //This member is public because MSVC don't let access to it in the rebind constructor.
+};
+
+template<typename T, typename U>
+bool operator==(const pool_allocator<T>& right, const pool_allocator<U>& left) noexcept
+{
+    return right.memory_pool() == left.memory_pool();
+}
+
+template<typename T, typename U>
+bool operator!=(const pool_allocator<T>& right, const pool_allocator<U>& left) noexcept
+{
+    return !(left == right);
+}
+
+template<typename T>
+struct pool_delete
+{
+    slab_pool* pool{};
+
+    void operator()(T* pointer) const noexcept
+    {
+        pointer->~T();
+        pool->deallocate(pointer, sizeof(T), alignof(T));
+    }
+};
+
+template<typename T>
+using pool_ptr = std::unique_ptr<T, pool_delete<T>>;
+
+template<typename T, typename... Args>
+pool_ptr<T> make_pooled(slab_pool& pool, Args&&... args)
+{
+    void* const memory{pool.allocate(sizeof(T), alignof(T))};
+
+    try
+    {
+        return pool_ptr<T>{::new(memory) T{std::forward<Args>(args)...}, pool_delete<T>{&pool}};
+    }
+    catch(...)
+    {
+        pool.deallocate(memory, sizeof(T), alignof(T));
+        throw;
+    }
+}
+
+}
+
+}
+
+#endif
@@ -0,0 +1,402 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_FOUNDATION_PROFILER_HPP_INCLUDED
+#define CAPTAL_FOUNDATION_PROFILER_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace cpt
+{
+
+inline namespace foundation
+{
+
+struct profile_event
+{
+    const char* name{}; //Must outlive the profiler, usually a string literal
+    std::uint64_t begin{}; //Nanoseconds since the profiler creation
+    std::uint64_t duration{};
+};
+
+//Collects profile scopes of all threads and exports them in the Chrome trace event format (chrome://tracing, Perfetto).
+//Each thread appends to its own buffer without locking, the profiler mutex is only taken on the first event of a thread and on export.
+//clear() hides previous events at once, each thread then frees its own buffer on its next event, so it is safe while other threads record.
+//Since this is header-only, each shared library using it has its own instance on platforms without symbol interposition (Windows).
+class profiler
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t chunk_size{4096};
+    static constexpr std::size_t max_event_count{std::size_t{1} << 20}; //Per thread and per capture, next events are dropped until clear()
+
+private:
+    struct chunk
+    {
+        std::array<profile_event, chunk_size> events{};
+        std::atomic<std::size_t> count{};
+        std::atomic<chunk*> next{};
+    };
+
+    struct thread_buffer
+    {
+        thread_buffer() = default;
+
+        ~thread_buffer()
+        {
+            free_chunks();
+        }
+
+        thread_buffer(const thread_buffer&) = delete;
+        thread_buffer& operator=(const thread_buffer&) = delete;
+        thread_buffer(thread_buffer&&) = delete;
+        thread_buffer& operator=(thread_buffer&&) = delete;
+
+        void free_chunks() noexcept
+        {
+            chunk* current{head.next.exchange(nullptr, std::memory_order_relaxed)};
+
+            while(current)
+            {
+                delete std::exchange(current, current->next.load(std::memory_order_relaxed));
+            }
+        }
+
+        chunk head{};
+        chunk* tail{&head};
+        std::size_t total{};
+        std::atomic<std::size_t> discarded{}; //Events before this index are hidden by clear()
+        std::uint64_t generation{}; //Value of the profiler generation when the buffer was last rewound
+        std::uint32_t id{};
+        std::string name{};
+    };
+
+private:
+    profiler() = default;
+
+public:
+    ~profiler() = default;
+    profiler(const profiler&) = delete;
+    profiler& operator=(const profiler&) = delete;
+    profiler(profiler&&) = delete;
+    profiler& operator=(profiler&&) = delete;
+
+    static profiler& instance() noexcept
+    {
+        static profiler output{};
+
+        return output;
+    }
+
+    void set_enabled(bool enabled) noexcept
+    {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool enabled() const noexcept
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    void record(const char* name, clock::time_point begin, clock::time_point end)
+    {
+        auto& buffer{local_buffer()};
+
+        if(buffer.generation != m_generation.load(std::memory_order_relaxed))
+        {
+            rewind(buffer);
+        }
+
+        if(buffer.total == max_event_count)
+        {
+            return;
+        }
+
+        if(buffer.tail->count.load(std::memory_order_relaxed) == chunk_size)
+        {
+            auto* const next{new chunk{}};
+
+            buffer.tail->next.store(next, std::memory_order_release);
+            buffer.tail = next;
+        }
+
+        auto& tail{*buffer.tail};
+        const auto index{tail.count.load(std::memory_order_relaxed)};
+
+        tail.events[index].name = name;
+        tail.events[index].begin = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(begin - m_origin).count());
+        tail.events[index].duration = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+
+        tail.count.store(index + 1, std::memory_order_release);
+        ++buffer.total;
+    }
+
+    //Shown in the trace instead of the thread number
+    void set_thread_name(std::string_view name)
+    {
+        auto& buffer{local_buffer()};
+
+        std::lock_guard lock{m_mutex};
+        buffer.name = name;
+    }
+
+    void clear() noexcept
+    {
+        std::lock_guard lock{m_mutex};
+
+        for(auto& buffer : m_buffers)
+        {
+            buffer->discarded.store(published_count(*buffer), std::memory_order_relaxed);
+        }
+
+        m_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::vector<profile_event> events() const
+    {
+        std::vector<profile_event> output{};
+
+        std::lock_guard lock{m_mutex};
+
+        for(auto& buffer : m_buffers)
+        {
+            read(*buffer, [&output](std::uint32_t, const profile_event& event)
+            {
+                output.emplace_back(event);
+            });
+        }
+
+        return output;
+    }
+
+    std::string chrome_trace() const
+    {
+        std::string output{"{\"displayTimeUnit\":\"ms\",\"traceEvents\":["};
+        bool first{true};
+
+        const auto separator = [&output, &first]()
+        {
+            if(!std::exchange(first, false))
+            {
+                output += ',';
+            }
+        };
+
+        std::lock_guard lock{m_mutex};
+
+        for(auto& buffer : m_buffers)
+        {
+            separator();
+
+            output += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":";
+            output += std::to_string(buffer->id);
+            output += ",\"args\":{\"name\":\"";
+            append_escaped(output, std::empty(buffer->name) ? "thread " + std::to_string(buffer->id) : buffer->name);
+            output += "\"}}";
+
+            read(*buffer, [&output, &separator](std::uint32_t id, const profile_event& event)
+            {
+                separator();
+
+                output += "{\"name\":\"";
+                append_escaped(output, event.name);
+                output += "\",\"cat\":\"captal\",\"ph\":\"X\",\"pid\":0,\"tid\":";
+                output += std::to_string(id);
+                output += ",\"ts\":";
+                append_microseconds(output, event.begin);
+                output += ",\"dur\":";
+                append_microseconds(output, event.duration);
+                output += '}';
+            });
+        }
+
+        output += "]}";
+
+        return output;
+    }
+
+    void write_chrome_trace(const std::filesystem::path& file) const
+    {
+        std::ofstream stream{file, std::ios_base::binary};
+        if(!stream)
+        {
+            throw std::runtime_error{"Can not open file \"" + file.string() + "\"."};
+        }
+
+        const auto trace{chrome_trace()};
+        stream.write(std::data(trace), static_cast<std::streamsize>(std::size(trace)));
+    }
+
+private:
+    thread_buffer& local_buffer()
+    {
+        thread_local thread_buffer* buffer{};
+
+        if(!buffer)
+        {
+            std::lock_guard lock{m_mutex};
+
+            auto& new_buffer{m_buffers.emplace_back(std::make_unique<thread_buffer>())};
+            new_buffer->id = static_cast<std::uint32_t>(std::size(m_buffers));
+            new_buffer->generation = m_generation.load(std::memory_order_relaxed);
+            buffer = new_buffer.get();
+        }
+
+        return *buffer;
+    }
+
+    //Called by the owning thread after clear(), the lock keeps readers away from the chunks
+    void rewind(thread_buffer& buffer) noexcept
+    {
+        std::lock_guard lock{m_mutex};
+
+        buffer.free_chunks();
+        buffer.head.count.store(0, std::memory_order_relaxed);
+        buffer.tail = &buffer.head;
+        buffer.total = 0;
+        buffer.discarded.store(0, std::memory_order_relaxed);
+        buffer.generation = m_generation.load(std::memory_order_relaxed);
+    }
+
+    static std::size_t published_count(const thread_buffer& buffer) noexcept
+    {
+        std::size_t output{};
+
+        for(const chunk* current{&buffer.head}; current; current = current->next.load(std::memory_order_acquire))
+        {
+            output += current->count.load(std::memory_order_acquire);
+        }
+
+        return output;
+    }
+
+    template<typename Func>
+    static void read(const thread_buffer& buffer, Func&& func)
+    {
+        const auto discarded{buffer.discarded.load(std::memory_order_relaxed)};
+        std::size_t index{};
+
+        for(const chunk* current{&buffer.head}; current; current = current->next.load(std::memory_order_acquire))
+        {
+            const auto count{current->count.load(std::memory_order_acquire)};
+
+            for(std::size_t i{}; i < count; ++i, ++index)
+            {
+                if(index >= discarded)
+                {
+                    func(buffer.id, current->events[i]);
+                }
+            }
+        }
+    }
+
+    static void append_escaped(std::string& output, std::string_view string)
+    {
+        for(const char c : string)
+        {
+            if(c == '"' || c == '\\')
+            {
+                output += '\\';
+            }
+
+            output += c;
+        }
+    }
+
+    static void append_microseconds(std::string& output, std::uint64_t nanoseconds)
+    {
+        const auto fraction{std::to_string(nanoseconds % 1000)};
+
+        output += std::to_string(nanoseconds / 1000);
+        output += '.';
+        output.append(3 - std::size(fraction), '0');
+        output += fraction;
+    }
+
+private:
+    clock::time_point m_origin{clock::now()};
+    std::atomic<bool> m_enabled{true};
+    std::atomic<std::uint64_t> m_generation{}; //Incremented by clear()
+    mutable std::mutex m_mutex{};
+    std::vector<std::unique_ptr<thread_buffer>> m_buffers{};
+};
+
+//Records its lifetime in the profiler, if it is enabled when the scope begins
+class profile_scope
+{
+public:
+    explicit profile_scope(const char* name) noexcept
+    :m_name{name}
+    {
+        if(profiler::instance().enabled())
+        {
+            m_begin = profiler::clock::now();
+        }
+    }
+
+    ~profile_scope()
+    {
+        if(m_begin != profiler::clock::time_point{})
+        {
+            profiler::instance().record(m_name, m_begin, profiler::clock::now());
+        }
+    }
+
+    profile_scope(const profile_scope&) = delete;
+    profile_scope& operator=(const profile_scope&) = delete;
+    profile_scope(profile_scope&&) = delete;
+    profile_scope& operator=(profile_scope&&) = delete;
+
+private:
+    const char* m_name{};
+    profiler::clock::time_point m_begin{};
+};
+
+}
+
+}
+
+#define CAPTAL_PROFILE_CONCAT_IMPL(left, right) left##right
+#define CAPTAL_PROFILE_CONCAT(left, right) CAPTAL_PROFILE_CONCAT_IMPL(left, right)
+
+//Scopes compile to nothing unless CAPTAL_PROFILING is defined (CAPTAL_PROFILING CMake option)
+#ifdef CAPTAL_PROFILING
+    #define CAPTAL_PROFILE_SCOPE(name) const ::cpt::profile_scope CAPTAL_PROFILE_CONCAT(captal_profile_scope_, __LINE__){name}
+#else
+    #define CAPTAL_PROFILE_SCOPE(name)
+#endif
+
+#endif
@@ -0,0 +1,165 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#ifndef CAPTAL_FOUNDATION_TASK_POOL_HPP_INCLUDED
+#define CAPTAL_FOUNDATION_TASK_POOL_HPP_INCLUDED
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace cpt
+{
+
+inline namespace foundation
+{
+
+//Fixed set of threads running submitted tasks in submission order, submit never waits for the task.
+//A pool without threads runs each task on the calling thread, within submit.
+//Tasks still queued when the pool stops are dropped, their futures report std::future_errc::broken_promise.
+class task_pool
+{
+public:
+    task_pool() = default;
+
+    explicit task_pool(std::size_t thread_count)
+    {
+        m_threads.reserve(thread_count);
+
+        for(std::size_t i{}; i < thread_count; ++i)
+        {
+            m_threads.emplace_back(&task_pool::worker, this);
+        }
+    }
+
+    ~task_pool()
+    {
+        stop();
+    }
+
+    task_pool(const task_pool&) = delete;
+    task_pool& operator=(const task_pool&) = delete;
+    task_pool(task_pool&&) = delete;
+    task_pool& operator=(task_pool&&) = delete;
+
+    template<typename Func>
+    auto submit(Func&& func)
+    {
+        using result_type = std::invoke_result_t<std::decay_t<Func>&>;
+
+        //std::function needs a copyable target
+        auto task{std::make_shared<std::packaged_task<result_type()>>(std::forward<Func>(func))};
+        auto output{task->get_future()};
+
+        std::unique_lock lock{m_mutex};
+
+        if(std::empty(m_threads))
+        {
+            lock.unlock();
+            (*task)();
+
+            return output;
+        }
+
+        m_tasks.emplace_back([task = std::move(task)]()
+        {
+            (*task)();
+        });
+
+        lock.unlock();
+        m_condition.notify_one();
+
+        return output;
+    }
+
+    //Drops the queued tasks and waits for the running ones, following tasks run within submit.
+    void stop()
+    {
+        std::unique_lock lock{m_mutex};
+        m_stop = true;
+        auto threads{std::move(m_threads)};
+        auto tasks{std::move(m_tasks)};
+        lock.unlock();
+
+        m_condition.notify_all();
+
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    std::size_t thread_count() const
+    {
+        std::lock_guard lock{m_mutex};
+
+        return std::size(m_threads);
+    }
+
+private:
+    void worker()
+    {
+        std::unique_lock lock{m_mutex};
+
+        while(true)
+        {
+            m_condition.wait(lock, [this]()
+            {
+                return m_stop || !std::empty(m_tasks);
+            });
+
+            if(m_stop)
+            {
+                return;
+            }
+
+            auto task{std::move(m_tasks.front())};
+            m_tasks.pop_front();
+
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+private:
+    std::vector<std::thread> m_threads{};
+    std::deque<std::function<void()>> m_tasks{};
+    mutable std::mutex m_mutex{};
+    std::condition_variable m_condition{};
+    bool m_stop{};
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,213 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_FOUNDATION_WORKER_POOL_HPP_INCLUDED
+#define CAPTAL_FOUNDATION_WORKER_POOL_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace cpt
+{
+
+inline namespace foundation
+{
+
+//Fixed set of threads for fork-join work, the calling thread takes part in each job.
+//A pool without threads runs everything on the calling thread.
+//Only one job runs at a time, parallel_for must not be called concurrently or from a job.
+class worker_pool
+{
+public:
+    worker_pool() = default;
+
+    explicit worker_pool(std::size_t thread_count)
+    {
+        m_threads.reserve(thread_count);
+
+        for(std::size_t i{}; i < thread_count; ++i)
+        {
+            m_threads.emplace_back(&worker_pool::worker, this);
+        }
+    }
+
+    ~worker_pool()
+    {
+        std::unique_lock lock{m_mutex};
+        m_stop = true;
+        lock.unlock();
+
+        m_condition.notify_all();
+
+        for(auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+    worker_pool(worker_pool&&) = delete;
+    worker_pool& operator=(worker_pool&&) = delete;
+
+    //Calls func(i) for each i in [0, count), returns once every call is done.
+    //If some calls throw, the first exception is rethrown after the join.
+    template<typename Func>
+    void parallel_for(std::size_t count, Func&& func)
+    {
+        if(count == 0)
+        {
+            return;
+        }
+
+        if(std::empty(m_threads) || count == 1)
+        {
+            for(std::size_t i{}; i < count; ++i)
+            {
+                func(i);
+            }
+
+            return;
+        }
+
+        using func_type = std::remove_reference_t<Func>;
+
+        std::unique_lock lock{m_mutex};
+
+        m_function = [](void* context, std::size_t index)
+        {
+            (*static_cast<func_type*>(context))(index);
+        };
+
+        m_context = const_cast<void*>(static_cast<const void*>(std::addressof(func)));
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_pending = std::size(m_threads);
+        m_exception = nullptr;
+        ++m_generation;
+
+        lock.unlock();
+        m_condition.notify_all();
+
+        work();
+
+        lock.lock();
+        m_done_condition.wait(lock, [this]()
+        {
+            return m_pending == 0;
+        });
+
+        m_function = nullptr;
+        m_context = nullptr;
+
+        if(m_exception)
+        {
+            std::rethrow_exception(std::exchange(m_exception, nullptr));
+        }
+    }
+
+    std::size_t thread_count() const noexcept
+    {
+        return std::size(m_threads);
+    }
+
+private:
+    void worker()
+    {
+        std::uint64_t generation{};
+
+        std::unique_lock lock{m_mutex};
+
+        while(true)
+        {
+            m_condition.wait(lock, [this, generation]()
+            {
+                return m_stop || m_generation != generation;
+            });
+
+            if(m_stop)
+            {
+                return;
+            }
+
+            generation = m_generation;
+
+            lock.unlock();
+            work();
+            lock.lock();
+
+            if(--m_pending == 0)
+            {
+                m_done_condition.notify_one();
+            }
+        }
+    }
+
+    void work()
+    {
+        for(auto i{m_next.fetch_add(1, std::memory_order_relaxed)}; i < m_count; i = m_next.fetch_add(1, std::memory_order_relaxed))
+        {
+            try
+            {
+                m_function(m_context, i);
+            }
+            catch(...)
+            {
+                std::lock_guard lock{m_mutex};
+
+                if(!m_exception)
+                {
+                    m_exception = std::current_exception();
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<std::thread> m_threads{};
+    std::mutex m_mutex{};
+    std::condition_variable m_condition{};
+    std::condition_variable m_done_condition{};
+    std::uint64_t m_generation{};
+    bool m_stop{};
+    void (*m_function)(void*, std::size_t){};
+    void* m_context{};
+    std::size_t m_count{};
+    std::atomic<std::size_t> m_next{};
+    std::size_t m_pending{};
+    std::exception_ptr m_exception{};
+};
+
+}
+
+}
+
+#endif
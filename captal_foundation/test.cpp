@@ -3,10 +3,19 @@
 #include <captal_foundation/optional_ref.hpp>
 #include <captal_foundation/enum_operations.hpp>
 #include <captal_foundation/stack_allocator.hpp>
+#include <captal_foundation/frame_allocator.hpp>
+#include <captal_foundation/pool_allocator.hpp>
+#include <captal_foundation/mpsc_queue.hpp>
+#include <captal_foundation/worker_pool.hpp>
+#include <captal_foundation/task_pool.hpp>
+#include <captal_foundation/frame_pacer.hpp>
+#include <captal_foundation/profiler.hpp>
 #include <captal_foundation/math.hpp>
 
 #include <vector>
 #include <numbers>
+#include <map>
+#include <thread>
 
 #define CATCH_CONFIG_ENABLE_BENCHMARKING
 #define CATCH_CONFIG_MAIN
@@ -145,6 +154,531 @@ TEST_CASE("Stack allocator test", "[stack_alloc]")
     }
 }
 
+TEST_CASE("Frame allocator test", "[frame_alloc]")
+{
+    SECTION("cpt::frame_memory_resource reuses the same memory once every allocation has been freed")
+    {
+        cpt::frame_memory_resource resource{256};
+
+        void* memory1{resource.allocate(24)};
+        void* memory2{resource.allocate(24)};
+        REQUIRE(memory1 != memory2);
+        REQUIRE(resource.live_count() == 2);
+        resource.deallocate(memory1, 24);
+        resource.deallocate(memory2, 24);
+
+        void* memory3{resource.allocate(24)};
+        REQUIRE(memory3 == memory1);
+        resource.deallocate(memory3, 24);
+
+        REQUIRE(resource.stats().allocation_count == 3);
+        REQUIRE(resource.stats().heap_allocation_count == 1);
+    }
+
+    SECTION("cpt::frame_memory_resource respects alignment")
+    {
+        cpt::frame_memory_resource resource{256};
+
+        void* memory1{resource.allocate(1, 1)};
+        void* memory2{resource.allocate(16, 64)};
+        REQUIRE(reinterpret_cast<std::uintptr_t>(memory2) % 64 == 0);
+        resource.deallocate(memory2, 16, 64);
+        resource.deallocate(memory1, 1, 1);
+    }
+
+    SECTION("cpt::frame_memory_resource merges its chunks on reset")
+    {
+        cpt::frame_memory_resource resource{64};
+
+        std::vector<void*> memories{};
+        for(std::size_t i{}; i < 16; ++i)
+        {
+            memories.emplace_back(resource.allocate(32));
+        }
+
+        REQUIRE(resource.stats().heap_allocation_count > 1);
+
+        for(auto memory : memories)
+        {
+            resource.deallocate(memory, 32);
+        }
+
+        resource.reset();
+        REQUIRE(resource.stats().allocation_count == 0);
+
+        for(auto& memory : memories)
+        {
+            memory = resource.allocate(32);
+        }
+
+        REQUIRE(resource.stats().heap_allocation_count == 1);
+
+        for(auto memory : memories)
+        {
+            resource.deallocate(memory, 32);
+        }
+    }
+
+    SECTION("cpt::frame_vector allocates within the calling thread frame arena")
+    {
+        const auto before{cpt::frame_memory().stats().heap_allocation_count};
+
+        auto vector{cpt::make_frame_vector<std::uint32_t>()};
+        for(std::uint32_t i{}; i < 1000; ++i)
+        {
+            vector.emplace_back(i);
+        }
+
+        REQUIRE(vector[999] == 999);
+        REQUIRE(cpt::frame_memory().stats().heap_allocation_count - before <= 1);
+    }
+}
+
+TEST_CASE("Pool allocator test", "[pool_alloc]")
+{
+    SECTION("cpt::slab_pool reuses freed blocks and allocates slabs on demand")
+    {
+        cpt::slab_pool pool{24, alignof(std::max_align_t), 4};
+
+        std::vector<void*> blocks{};
+        for(std::size_t i{}; i < 5; ++i)
+        {
+            blocks.emplace_back(pool.allocate(24, 8));
+        }
+
+        REQUIRE(pool.stats().live_count == 5);
+        REQUIRE(pool.stats().slab_count == 2);
+        REQUIRE(pool.stats().block_count == 8);
+
+        pool.deallocate(blocks[2], 24, 8);
+        REQUIRE(pool.allocate(24, 8) == blocks[2]);
+
+        for(auto block : blocks)
+        {
+            pool.deallocate(block, 24, 8);
+        }
+
+        REQUIRE(pool.stats().live_count == 0);
+        REQUIRE(pool.stats().fallback_count == 0);
+    }
+
+    SECTION("cpt::slab_pool fallbacks on new if the requested allocation does not fit in a block")
+    {
+        cpt::slab_pool pool{16, 16};
+
+        void* memory{pool.allocate(64, 8)};
+        REQUIRE(memory);
+        REQUIRE(pool.stats().fallback_count == 1);
+        REQUIRE(pool.stats().slab_count == 0);
+        pool.deallocate(memory, 64, 8);
+    }
+
+    SECTION("cpt::slab_pool thread caches give their blocks back")
+    {
+        cpt::slab_pool pool{32, alignof(std::max_align_t), 16, 8};
+
+        const auto work = [&pool]()
+        {
+            std::vector<void*> blocks{};
+            for(std::size_t j{}; j < 100; ++j)
+            {
+                for(std::size_t i{}; i < 20; ++i)
+                {
+                    blocks.emplace_back(pool.allocate(32, 8));
+                }
+
+                for(auto block : blocks)
+                {
+                    pool.deallocate(block, 32, 8);
+                }
+
+                blocks.clear();
+            }
+        };
+
+        std::vector<std::thread> threads{};
+        for(std::size_t i{}; i < 4; ++i)
+        {
+            threads.emplace_back(work);
+        }
+
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        REQUIRE(pool.stats().live_count == 0);
+        REQUIRE(pool.stats().block_count <= 4 * (20 + 8));
+
+        void* memory{pool.allocate(32, 8)};
+        REQUIRE(memory);
+        pool.deallocate(memory, 32, 8);
+    }
+
+    SECTION("cpt::pool_allocator works with std::allocate_shared and node based containers")
+    {
+        cpt::slab_pool pool{cpt::node_block_size<std::pair<const int, double>>, cpt::node_block_align<std::pair<const int, double>>};
+
+        {
+            const auto value{std::allocate_shared<std::pair<const int, double>>(cpt::pool_allocator<std::pair<const int, double>>{pool}, 42, 1.0)};
+            REQUIRE(value->first == 42);
+            REQUIRE(pool.stats().live_count == 1);
+
+            std::map<int, double, std::less<int>, cpt::pool_allocator<std::pair<const int, double>>> map{pool};
+            for(int i{}; i < 100; ++i)
+            {
+                map.emplace(i, static_cast<double>(i));
+            }
+
+            REQUIRE(pool.stats().live_count == 101);
+        }
+
+        REQUIRE(pool.stats().live_count == 0);
+        REQUIRE(pool.stats().fallback_count == 0);
+    }
+
+    SECTION("cpt::make_pooled returns a std::unique_ptr that gives its memory back to the pool")
+    {
+        cpt::slab_pool pool{sizeof(std::vector<int>), alignof(std::vector<int>)};
+
+        auto vector{cpt::make_pooled<std::vector<int>>(pool, 1, 2, 3)};
+        REQUIRE(std::size(*vector) == 3);
+        REQUIRE(pool.stats().live_count == 1);
+
+        vector.reset();
+        REQUIRE(pool.stats().live_count == 0);
+    }
+}
+
+TEST_CASE("MPSC queue test", "[mpsc_queue]")
+{
+    SECTION("cpt::mpsc_queue pops values in the order they were pushed")
+    {
+        cpt::mpsc_queue<std::unique_ptr<int>> queue{};
+        REQUIRE(queue.empty());
+
+        for(int i{}; i < 10; ++i)
+        {
+            queue.push(std::make_unique<int>(i));
+        }
+
+        REQUIRE(!queue.empty());
+
+        for(int i{}; i < 10; ++i)
+        {
+            const auto value{queue.try_pop()};
+            REQUIRE(value);
+            REQUIRE(**value == i);
+        }
+
+        REQUIRE(!queue.try_pop());
+    }
+
+    SECTION("cpt::mpsc_queue keeps the order of each producer")
+    {
+        static constexpr std::uint32_t producer_count{4};
+        static constexpr std::uint32_t value_count{10000};
+
+        cpt::slab_pool pool{cpt::node_block_size<std::uint64_t>, cpt::node_block_align<std::uint64_t>, 64, 64};
+        cpt::mpsc_queue<std::uint64_t, cpt::pool_allocator<std::uint64_t>> queue{pool};
+
+        std::vector<std::thread> producers{};
+        for(std::uint32_t i{}; i < producer_count; ++i)
+        {
+            producers.emplace_back([&queue, i]()
+            {
+                for(std::uint32_t j{}; j < value_count; ++j)
+                {
+                    queue.push((static_cast<std::uint64_t>(i) << 32) | j);
+                }
+            });
+        }
+
+        std::array<std::uint32_t, producer_count> next{};
+        std::uint32_t total{};
+
+        while(total < producer_count * value_count)
+        {
+            total += static_cast<std::uint32_t>(queue.drain([&next](std::uint64_t value)
+            {
+                const auto producer{static_cast<std::uint32_t>(value >> 32)};
+                const auto index   {static_cast<std::uint32_t>(value & 0xFFFFFFFF)};
+
+                REQUIRE(index == next[producer]);
+                ++next[producer];
+            }));
+        }
+
+        for(auto& producer : producers)
+        {
+            producer.join();
+        }
+
+        REQUIRE(queue.empty());
+    }
+}
+
+TEST_CASE("Worker pool test", "[worker_pool]")
+{
+    SECTION("cpt::worker_pool calls the function once per index")
+    {
+        cpt::worker_pool pool{3};
+        REQUIRE(pool.thread_count() == 3);
+
+        for(std::size_t count : {0, 1, 2, 7, 1000})
+        {
+            std::vector<std::atomic<std::uint32_t>> calls(count);
+
+            pool.parallel_for(count, [&calls](std::size_t i)
+            {
+                calls[i].fetch_add(1, std::memory_order_relaxed);
+            });
+
+            for(auto& call : calls)
+            {
+                REQUIRE(call.load() == 1);
+            }
+        }
+    }
+
+    SECTION("cpt::worker_pool without threads runs on the calling thread")
+    {
+        cpt::worker_pool pool{};
+        const auto id{std::this_thread::get_id()};
+
+        pool.parallel_for(16, [id](std::size_t)
+        {
+            REQUIRE(std::this_thread::get_id() == id);
+        });
+    }
+
+    SECTION("cpt::worker_pool rethrows after the join")
+    {
+        cpt::worker_pool pool{2};
+        std::atomic<std::uint32_t> done{};
+
+        REQUIRE_THROWS_AS(pool.parallel_for(100, [&done](std::size_t i)
+        {
+            if(i == 50)
+            {
+                throw std::runtime_error{"error"};
+            }
+
+            done.fetch_add(1, std::memory_order_relaxed);
+        }), std::runtime_error);
+
+        REQUIRE(done.load() == 99);
+
+        pool.parallel_for(4, [](std::size_t){}); //Still usable
+    }
+}
+
+TEST_CASE("Task pool test", "[task_pool]")
+{
+    SECTION("cpt::task_pool runs each task once and returns its result")
+    {
+        cpt::task_pool pool{2};
+        REQUIRE(pool.thread_count() == 2);
+
+        std::vector<std::future<std::size_t>> futures{};
+        for(std::size_t i{}; i < 100; ++i)
+        {
+            futures.emplace_back(pool.submit([i]()
+            {
+                return i * 2;
+            }));
+        }
+
+        for(std::size_t i{}; i < 100; ++i)
+        {
+            REQUIRE(futures[i].get() == i * 2);
+        }
+    }
+
+    SECTION("cpt::task_pool without threads runs on the calling thread")
+    {
+        cpt::task_pool pool{};
+        const auto id{std::this_thread::get_id()};
+
+        auto future{pool.submit([]()
+        {
+            return std::this_thread::get_id();
+        })};
+
+        REQUIRE(future.wait_for(std::chrono::seconds{0}) == std::future_status::ready);
+        REQUIRE(future.get() == id);
+    }
+
+    SECTION("cpt::task_pool reports exceptions through the future")
+    {
+        cpt::task_pool pool{1};
+
+        auto future{pool.submit([]() -> int
+        {
+            throw std::runtime_error{"error"};
+        })};
+
+        REQUIRE_THROWS_AS(future.get(), std::runtime_error);
+        REQUIRE(pool.submit([](){ return 1; }).get() == 1); //Still usable
+    }
+
+    SECTION("cpt::task_pool drops queued tasks when stopped")
+    {
+        cpt::task_pool pool{1};
+
+        std::promise<void> started{};
+        std::promise<void> release{};
+        auto running{pool.submit([&started, released = release.get_future()]() mutable
+        {
+            started.set_value();
+            released.wait();
+        })};
+
+        started.get_future().wait();
+        auto queued{pool.submit([](){ return 1; })};
+
+        std::thread stopper{[&pool]()
+        {
+            pool.stop();
+        }};
+
+        //Lets stop() drop the queued task before the running one ends
+        while(pool.thread_count() != 0)
+        {
+            std::this_thread::yield();
+        }
+
+        release.set_value();
+        stopper.join();
+
+        REQUIRE_NOTHROW(running.get());
+        REQUIRE_THROWS_AS(queued.get(), std::future_error);
+        REQUIRE(pool.thread_count() == 0);
+        REQUIRE(pool.submit([](){ return 2; }).get() == 2);
+    }
+}
+
+//Time only advances when the pacer sleeps or spins, or when a test simulates work
+struct manual_frame_clock
+{
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<std::chrono::steady_clock, duration>;
+
+    struct state
+    {
+        time_point now{};
+        duration oversleep{};
+        std::size_t sleep_count{};
+    };
+
+    state* data{};
+
+    time_point now() const noexcept
+    {
+        return data->now;
+    }
+
+    void sleep_for(duration time) const noexcept
+    {
+        data->now += time + data->oversleep;
+        ++data->sleep_count;
+    }
+
+    void relax() const noexcept
+    {
+        data->now += std::chrono::microseconds{10};
+    }
+};
+
+TEST_CASE("Frame pacer test", "[frame_pacer]")
+{
+    using namespace std::chrono_literals;
+
+    manual_frame_clock::state state{};
+
+    SECTION("cpt::basic_frame_pacer without limit does not wait")
+    {
+        cpt::basic_frame_pacer<manual_frame_clock> pacer{manual_frame_clock{&state}};
+
+        state.now += 5ms;
+        REQUIRE(pacer.next_frame() == 5ms);
+        state.now += 7ms;
+        REQUIRE(pacer.next_frame() == 7ms);
+        REQUIRE(state.sleep_count == 0);
+    }
+
+    SECTION("cpt::basic_frame_pacer deadlines do not drift")
+    {
+        cpt::basic_frame_pacer<manual_frame_clock> pacer{manual_frame_clock{&state}};
+        pacer.set_frame_rate(100);
+
+        state.oversleep = 1500us; //Worse than the OS, still within the spin threshold
+
+        const auto begin{state.now};
+        for(std::size_t i{}; i < 100; ++i)
+        {
+            state.now += 3ms;
+
+            const auto frame_time{pacer.next_frame()};
+            REQUIRE(frame_time >= 10ms);
+            REQUIRE(frame_time < 10ms + 10us);
+        }
+
+        REQUIRE(state.now - begin < 1s + 10us);
+        REQUIRE(state.sleep_count == 100);
+    }
+
+    SECTION("cpt::basic_frame_pacer restarts its timeline after a hitch")
+    {
+        cpt::basic_frame_pacer<manual_frame_clock> pacer{manual_frame_clock{&state}};
+        pacer.set_frame_rate(100);
+
+        state.now += 35ms;
+        REQUIRE(pacer.next_frame() == 35ms);
+        REQUIRE(pacer.next_deadline() == state.now + 10ms);
+
+        state.now += 2ms;
+        const auto frame_time{pacer.next_frame()};
+        REQUIRE(frame_time >= 10ms);
+        REQUIRE(frame_time < 10ms + 10us);
+    }
+
+    SECTION("cpt::basic_frame_pacer aligns its deadlines on a reference")
+    {
+        cpt::basic_frame_pacer<manual_frame_clock> pacer{manual_frame_clock{&state}};
+        pacer.set_period(10ms);
+
+        const auto deadline{pacer.next_deadline()};
+
+        pacer.align(deadline + 23ms);
+        REQUIRE(pacer.next_deadline() == deadline + 3ms);
+
+        pacer.align(deadline + 31ms);
+        REQUIRE(pacer.next_deadline() == deadline + 1ms);
+
+        pacer.align(deadline - 2ms);
+        REQUIRE(pacer.next_deadline() == deadline - 2ms);
+    }
+
+    SECTION("cpt::basic_frame_pacer percentiles")
+    {
+        cpt::basic_frame_pacer<manual_frame_clock> pacer{manual_frame_clock{&state}, 100};
+        REQUIRE(pacer.percentiles().max == 0ns);
+
+        for(std::size_t i{1}; i <= 200; ++i) //Only the last 100 frames are kept
+        {
+            state.now += std::chrono::milliseconds{static_cast<std::int64_t>(i > 100 ? i - 100 : 1000)};
+            pacer.next_frame();
+        }
+
+        const auto percentiles{pacer.percentiles()};
+        REQUIRE(percentiles.p50 == 50ms);
+        REQUIRE(percentiles.p95 == 95ms);
+        REQUIRE(percentiles.p99 == 99ms);
+        REQUIRE(percentiles.max == 100ms);
+    }
+}
+
 TEST_CASE("Encoding test", "[encoding]")
 {
     const std::u8string_view string{u8"abcÀçè中国日本国кир👦"}; //A string with a lot of special chars with different sizes (in UTF-8)
@@ -169,6 +703,261 @@ TEST_CASE("Encoding test", "[encoding]")
     REQUIRE(count.operator()<cpt::wide>() == codepoint_count);
 }
 
+//Per-codepoint conversion, without any fast path
+template<cpt::encoding Input, cpt::encoding Output, typename String>
+static std::basic_string<typename Output::char_type> reference_convert(const String& string)
+{
+    std::basic_string<typename Output::char_type> output{};
+
+    auto begin{std::begin(string)};
+    while(begin < std::end(string))
+    {
+        cpt::codepoint_t code{};
+        begin = Input::decode(begin, std::end(string), code);
+        Output::encode(code, std::back_inserter(output));
+    }
+
+    return output;
+}
+
+static std::u8string make_corpus(std::u8string_view text, std::size_t size)
+{
+    std::u8string output{};
+
+    while(std::size(output) < size)
+    {
+        output += text;
+    }
+
+    return output;
+}
+
+static const std::array<std::pair<const char*, std::u8string>, 5> corpora
+{
+    std::make_pair("english", make_corpus(u8"The quick brown fox jumps over the lazy dog. 0123456789 ", 1 << 16)),
+    std::make_pair("french",  make_corpus(u8"Le cœur déçu mais l'âme plutôt naïve, Louÿs rêva de crapaüter. ", 1 << 16)),
+    std::make_pair("russian", make_corpus(u8"Съешь же ещё этих мягких французских булок, да выпей чаю. ", 1 << 16)),
+    std::make_pair("chinese", make_corpus(u8"我能吞下玻璃而不伤身体。私はガラスを食べられます。", 1 << 16)),
+    std::make_pair("mixed",   make_corpus(u8"<p>Hello 世界, привет мир, ça va? 👦🏽 [42]</p>\n", 1 << 16))
+};
+
+TEST_CASE("Encoding fast paths", "[encoding]")
+{
+    SECTION("Fast paths give the same result as per-codepoint conversion")
+    {
+        for(auto&& [name, corpus] : corpora)
+        {
+            const auto utf32{cpt::convert<cpt::utf8, cpt::utf32>(corpus)};
+            const auto utf16{cpt::convert<cpt::utf8, cpt::utf16>(corpus)};
+
+            REQUIRE(utf32 == reference_convert<cpt::utf8, cpt::utf32>(corpus));
+            REQUIRE(utf16 == reference_convert<cpt::utf8, cpt::utf16>(corpus));
+            REQUIRE(cpt::convert<cpt::utf16, cpt::utf8>(utf16) == corpus);
+            REQUIRE(cpt::convert<cpt::utf32, cpt::utf8>(utf32) == corpus);
+            REQUIRE(cpt::convert<cpt::narrow, cpt::wide>(cpt::to_narrow(corpus)) == reference_convert<cpt::narrow, cpt::wide>(cpt::to_narrow(corpus)));
+        }
+    }
+
+    SECTION("Fast paths handle invalid sequences like per-codepoint conversion")
+    {
+        const std::u8string invalid{u8"abcdefghijklmnopqrstuvwxyz\xC3(\xE2\x82\xFF" u8"0123456789\x80\xBF\xE4\x41\x42\xF8" u8"abcdef\xF0\x9F"};
+        const std::u16string invalid_utf16{u"abcdefghijklmnopqrstuvwxyz\xDC00\xD800\xD800\xDC00\xD83D" u"0123456789\xD83D"};
+
+        REQUIRE(cpt::convert<cpt::utf8, cpt::utf32>(invalid) == reference_convert<cpt::utf8, cpt::utf32>(invalid));
+        REQUIRE(cpt::convert<cpt::utf8, cpt::utf16>(invalid) == reference_convert<cpt::utf8, cpt::utf16>(invalid));
+        REQUIRE(cpt::convert<cpt::utf16, cpt::utf8>(invalid_utf16) == reference_convert<cpt::utf16, cpt::utf8>(invalid_utf16));
+        REQUIRE(cpt::convert<cpt::utf16, cpt::utf32>(invalid_utf16) == reference_convert<cpt::utf16, cpt::utf32>(invalid_utf16));
+
+        //Ill-formed 3-byte sequence that decodes above U+FFFF, it needs two UTF-16 values
+        const std::string ill_formed{"\xEF\xFB\xEA"};
+        const std::string ill_formed_text{"abcdefghijklmnopqrstuvwxyz\xEF\xFB\xEA" "0123456789\xEF\xFB\xEA"};
+
+        REQUIRE(cpt::convert<cpt::utf8, cpt::utf16>(ill_formed) == reference_convert<cpt::utf8, cpt::utf16>(ill_formed));
+        REQUIRE(cpt::convert<cpt::utf8, cpt::utf16>(ill_formed_text) == reference_convert<cpt::utf8, cpt::utf16>(ill_formed_text));
+        REQUIRE(std::size(cpt::convert<cpt::utf8, cpt::utf16>(ill_formed)) == 2);
+    }
+
+    SECTION("Output size is exact")
+    {
+        const std::u8string_view string{u8"abcÀçè中国日本国кир👦"};
+
+        REQUIRE(std::size(cpt::convert<cpt::utf8, cpt::utf32>(string)) == 15);
+        REQUIRE(std::size(cpt::convert<cpt::utf8, cpt::utf16>(string)) == 16);
+        REQUIRE(std::size(cpt::convert<cpt::utf32, cpt::utf8>(cpt::convert<cpt::utf8, cpt::utf32>(string))) == std::size(string));
+    }
+
+    SECTION("UTF-8 validation")
+    {
+        const auto validate = [](std::string_view string)
+        {
+            return cpt::utf8::validate(std::begin(string), std::end(string));
+        };
+
+        for(auto&& [name, corpus] : corpora)
+        {
+            REQUIRE(cpt::utf8::validate(std::begin(corpus), std::end(corpus)));
+        }
+
+        REQUIRE(validate("0123456789abcdef0123456789abcdef"));
+        REQUIRE(validate("\xF4\x8F\xBF\xBF"));
+        REQUIRE(!validate("0123456789abcdef0123456789abcdef\x80"));
+        REQUIRE(!validate("\xC0\xAF"));          //overlong
+        REQUIRE(!validate("\xE0\x80\xAF"));      //overlong
+        REQUIRE(!validate("\xED\xA0\x80"));      //surrogate
+        REQUIRE(!validate("\xF4\x90\x80\x80"));  //above U+10FFFF
+        REQUIRE(!validate("\xE2\x82"));          //truncated
+
+        static_assert(cpt::utf8::validate(std::begin(u8"abcÀ中👦"), std::end(u8"abcÀ中👦")));
+    }
+}
+
+//Linear search of the first occurrence, as reference for the lookup tables
+static cpt::codepoint_t reference_case(const std::array<char32_t, 666>& from, const std::array<char32_t, 666>& to, cpt::codepoint_t code)
+{
+    const auto it{std::find(std::begin(from), std::end(from), code)};
+    if(it != std::end(from))
+    {
+        return to[static_cast<std::size_t>(std::distance(std::begin(from), it))];
+    }
+
+    return code;
+}
+
+TEST_CASE("Case mapping", "[encoding]")
+{
+    SECTION("Lookup tables match the case mapping arrays")
+    {
+        std::size_t mismatches{};
+
+        for(cpt::codepoint_t code{}; code < 0x20000; ++code)
+        {
+            mismatches += cpt::to_lower(code) != reference_case(cpt::impl::uppers, cpt::impl::lowers, code);
+            mismatches += cpt::to_upper(code) != reference_case(cpt::impl::lowers, cpt::impl::uppers, code);
+        }
+
+        REQUIRE(mismatches == 0);
+
+        static_assert(cpt::to_lower(U'A') == U'a' && cpt::to_lower(U'Ж') == U'ж' && cpt::to_upper(U'ω') == U'Ω');
+    }
+
+    SECTION("Strings")
+    {
+        const std::u8string_view string{u8"Hello World, ÀÇÈ КИР ΑΒΓ 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ"};
+
+        REQUIRE(cpt::to_lower<cpt::utf8>(std::u8string{string}) == u8"hello world, àçè кир αβγ 0123456789 abcdefghijklmnopqrstuvwxyz");
+        REQUIRE(cpt::to_upper<cpt::utf8>(std::u8string{string}) == u8"HELLO WORLD, ÀÇÈ КИР ΑΒΓ 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+        REQUIRE(cpt::to_upper<cpt::utf16>(std::u16string{u"çà ΑΒΓ abc"}) == u"ÇÀ ΑΒΓ ABC");
+        REQUIRE(cpt::to_lower<cpt::utf32>(std::u32string{U"ÇÀ ΑΒΓ ABC"}) == U"çà αβγ abc");
+    }
+
+    SECTION("Strings with length-changing mappings")
+    {
+        //U+0131 is encoded with 2 bytes in UTF-8, but its upper case is ASCII
+        REQUIRE(cpt::to_upper<cpt::utf8>(std::u8string{u8"ııı ok"}) == u8"III OK");
+
+        std::u8string output{};
+        const std::u8string_view string{u8"ıabcdefghijklmnopqrstuvwxyz"};
+        cpt::to_upper<cpt::utf8>(std::begin(string), std::end(string), std::back_inserter(output));
+
+        REQUIRE(output == u8"IABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    }
+}
+
+TEST_CASE("Case mapping benchmark", "[encoding_bench][.]")
+{
+    //Something that looks like item names of a game
+    const std::array<std::u8string_view, 8> words{u8"Sword", u8"of", u8"the", u8"Ancient", u8"Épée", u8"Щит", u8"ΔΡΑΚΟΣ", u8"Shield"};
+
+    std::vector<std::u8string> names{};
+    for(std::size_t i{}; i < 20000; ++i)
+    {
+        std::u8string name{};
+        for(std::size_t j{}; j < 3 + i % 4; ++j)
+        {
+            name += words[(i * 7 + j * 3) % std::size(words)];
+            name += u8" ";
+        }
+
+        name += std::u8string{u8"#"} + cpt::convert<cpt::narrow, cpt::utf8>(std::to_string(i));
+        names.emplace_back(std::move(name));
+    }
+
+    BENCHMARK("binary search cpt::to_lower")
+    {
+        std::size_t total{};
+
+        for(auto&& name : names)
+        {
+            std::u8string output{};
+            output.reserve(std::size(name));
+
+            auto begin{std::begin(name)};
+            while(begin < std::end(name))
+            {
+                cpt::codepoint_t code{};
+                begin = cpt::utf8::decode(begin, std::end(name), code);
+
+                const auto it{std::lower_bound(std::begin(cpt::impl::uppers), std::end(cpt::impl::uppers), code)};
+                if(it != std::end(cpt::impl::uppers) && *it == code)
+                {
+                    code = cpt::impl::lowers[static_cast<std::size_t>(std::distance(std::begin(cpt::impl::uppers), it))];
+                }
+
+                cpt::utf8::encode(code, std::back_inserter(output));
+            }
+
+            total += std::size(output);
+        }
+
+        return total;
+    };
+
+    BENCHMARK("cpt::to_lower")
+    {
+        std::size_t total{};
+
+        for(auto&& name : names)
+        {
+            total += std::size(cpt::to_lower<cpt::utf8>(name));
+        }
+
+        return total;
+    };
+}
+
+TEST_CASE("Encoding benchmark", "[encoding_bench][.]")
+{
+    for(auto&& [name, corpus] : corpora)
+    {
+        const auto utf16{cpt::convert<cpt::utf8, cpt::utf16>(corpus)};
+
+        BENCHMARK(std::string{"per-codepoint utf8 -> utf32 ("} + name + ")")
+        {
+            return reference_convert<cpt::utf8, cpt::utf32>(corpus);
+        };
+
+        BENCHMARK(std::string{"cpt::convert utf8 -> utf32 ("} + name + ")")
+        {
+            return cpt::convert<cpt::utf8, cpt::utf32>(corpus);
+        };
+
+        BENCHMARK(std::string{"cpt::convert utf8 -> utf16 ("} + name + ")")
+        {
+            return cpt::convert<cpt::utf8, cpt::utf16>(corpus);
+        };
+
+        BENCHMARK(std::string{"cpt::convert utf16 -> utf8 ("} + name + ")")
+        {
+            return cpt::convert<cpt::utf16, cpt::utf8>(utf16);
+        };
+
+        BENCHMARK(std::string{"cpt::utf8::validate ("} + name + ")")
+        {
+            return cpt::utf8::validate(std::begin(corpus), std::end(corpus));
+        };
+    }
+}
+
 /*
 static constexpr std::size_t pool_size{1024};
 
@@ -202,6 +991,105 @@ TEST_CASE("cpt::stack_allocator benchmark", "[stack_alloc_bench]")
 }
 */
 
+TEST_CASE("Profiler test", "[profiler]")
+{
+    auto& profiler{cpt::profiler::instance()};
+    profiler.set_enabled(true);
+    profiler.clear();
+
+    SECTION("cpt::profile_scope records nested scopes")
+    {
+        {
+            cpt::profile_scope outer{"outer"};
+            cpt::profile_scope inner{"inner"};
+        }
+
+        const auto events{profiler.events()};
+        REQUIRE(std::size(events) == 2);
+        REQUIRE(std::string_view{events[0].name} == "inner");
+        REQUIRE(std::string_view{events[1].name} == "outer");
+        REQUIRE(events[0].begin >= events[1].begin);
+        REQUIRE(events[0].begin + events[0].duration <= events[1].begin + events[1].duration);
+    }
+
+    SECTION("cpt::profiler keeps events of each thread")
+    {
+        std::vector<std::thread> threads{};
+        for(std::size_t i{}; i < 4; ++i)
+        {
+            threads.emplace_back([]()
+            {
+                for(std::size_t j{}; j < cpt::profiler::chunk_size + 10; ++j)
+                {
+                    cpt::profile_scope scope{"worker"};
+                }
+            });
+        }
+
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        REQUIRE(std::size(profiler.events()) == 4 * (cpt::profiler::chunk_size + 10));
+
+        profiler.clear();
+        REQUIRE(std::empty(profiler.events()));
+    }
+
+    SECTION("cpt::profiler clear() lets recording resume after the cap")
+    {
+        const auto now{cpt::profiler::clock::now()};
+
+        for(std::size_t i{}; i < cpt::profiler::max_event_count + 10; ++i)
+        {
+            profiler.record("capped", now, now);
+        }
+
+        REQUIRE(std::size(profiler.events()) == cpt::profiler::max_event_count);
+
+        profiler.clear();
+        REQUIRE(std::empty(profiler.events()));
+
+        for(std::size_t i{}; i < cpt::profiler::chunk_size + 10; ++i)
+        {
+            profiler.record("resumed", now, now);
+        }
+
+        const auto events{profiler.events()};
+        REQUIRE(std::size(events) == cpt::profiler::chunk_size + 10);
+        REQUIRE(std::string_view{events.front().name} == "resumed");
+    }
+
+    SECTION("cpt::profiler disabled does not record")
+    {
+        profiler.set_enabled(false);
+
+        {
+            cpt::profile_scope scope{"ignored"};
+        }
+
+        profiler.set_enabled(true);
+
+        REQUIRE(std::empty(profiler.events()));
+    }
+
+    SECTION("cpt::profiler Chrome trace export")
+    {
+        std::thread{[]()
+        {
+            cpt::profiler::instance().set_thread_name("audio \"thread\"");
+            cpt::profile_scope scope{"generate"};
+        }}.join();
+
+        const auto trace{profiler.chrome_trace()};
+        REQUIRE(trace.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+        REQUIRE(trace.ends_with("]}"));
+        REQUIRE(trace.find("\"args\":{\"name\":\"audio \\\"thread\\\"\"}") != std::string::npos);
+        REQUIRE(trace.find("{\"name\":\"generate\",\"cat\":\"captal\",\"ph\":\"X\"") != std::string::npos);
+    }
+}
+
 TEST_CASE("maths test", "[math_test]")
 {
     using namespace cpt::indices;
@@ -275,3 +1163,274 @@ TEST_CASE("maths test", "[math_test]")
         REQUIRE(transformed[w] == Approx(1.0).margin(0.01));
     }
 }
+
+TEST_CASE("2D model matrices", "[math_test]")
+{
+    const cpt::vec3f translation{12.0f, 3.0f, 6.0f};
+    const cpt::vec3f factor{2.0f, 3.0f, 1.0f};
+    const cpt::vec3f origin{4.0f, 5.0f, 0.0f};
+    const float angle{std::numbers::pi_v<float> / 3.0f};
+
+    const auto reference{cpt::model(translation, angle, cpt::vec3f{0.0f, 0.0f, 1.0f}, factor, origin)};
+
+    SECTION("cpt::model_2d gives the same result as cpt::model with Z axis")
+    {
+        const auto model{cpt::model_2d(translation, angle, factor, origin)};
+
+        for(std::size_t i{}; i < 4; ++i)
+        {
+            for(std::size_t j{}; j < 4; ++j)
+            {
+                REQUIRE(model[i][j] == Approx(reference[i][j]).margin(0.0001));
+            }
+        }
+    }
+
+    SECTION("Batched cpt::model_2d gives the same result as cpt::model_2d")
+    {
+        const std::vector<cpt::vec3f> translations(100, translation);
+        const std::vector<float> angles(100, angle);
+        const std::vector<cpt::vec3f> factors(100, factor);
+        const std::vector<cpt::vec3f> origins(100, origin);
+        std::vector<cpt::mat4f> models(100);
+
+        cpt::model_2d<float>(translations, angles, factors, origins, models);
+
+        for(auto&& model : models)
+        {
+            for(std::size_t i{}; i < 4; ++i)
+            {
+                for(std::size_t j{}; j < 4; ++j)
+                {
+                    REQUIRE(model[i][j] == Approx(reference[i][j]).margin(0.0001));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("2D model matrices benchmark", "[math_bench][.]")
+{
+    static constexpr std::size_t count{4096};
+
+    std::vector<cpt::vec3f> translations(count);
+    std::vector<float> angles(count);
+    std::vector<cpt::vec3f> factors(count, cpt::vec3f{1.0f});
+    std::vector<cpt::vec3f> origins(count, cpt::vec3f{16.0f, 16.0f, 0.0f});
+    std::vector<cpt::mat4f> models(count);
+
+    for(std::size_t i{}; i < count; ++i)
+    {
+        translations[i] = cpt::vec3f{static_cast<float>(i % 64) * 32.0f, static_cast<float>(i / 64) * 32.0f, 0.0f};
+        angles[i] = static_cast<float>(i) * 0.01f;
+    }
+
+    BENCHMARK("cpt::model")
+    {
+        for(std::size_t i{}; i < count; ++i)
+        {
+            models[i] = cpt::model(translations[i], angles[i], cpt::vec3f{0.0f, 0.0f, 1.0f}, factors[i], origins[i]);
+        }
+
+        return models.back()[0][0];
+    };
+
+    BENCHMARK("cpt::model_2d")
+    {
+        for(std::size_t i{}; i < count; ++i)
+        {
+            models[i] = cpt::model_2d(translations[i], angles[i], factors[i], origins[i]);
+        }
+
+        return models.back()[0][0];
+    };
+
+    BENCHMARK("batched cpt::model_2d")
+    {
+        cpt::model_2d<float>(translations, angles, factors, origins, models);
+
+        return models.back()[0][0];
+    };
+}
+
+static cpt::mat4f scalar_multiply(const cpt::mat4f& left, const cpt::mat4f& right) noexcept
+{
+    cpt::mat4f output{};
+
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        for(std::size_t j{}; j < 4; ++j)
+        {
+            for(std::size_t k{}; k < 4; ++k)
+            {
+                output[i][j] += left[i][k] * right[k][j];
+            }
+        }
+    }
+
+    return output;
+}
+
+static cpt::vec4f scalar_multiply(const cpt::mat4f& left, const cpt::vec4f& right) noexcept
+{
+    cpt::vec4f output{};
+
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        for(std::size_t j{}; j < 4; ++j)
+        {
+            output[i] += left[i][j] * right[j];
+        }
+    }
+
+    return output;
+}
+
+static cpt::vec4f scalar_normalize(const cpt::vec4f& vector) noexcept
+{
+    float length{};
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        length += vector[i] * vector[i];
+    }
+
+    length = std::sqrt(length);
+
+    cpt::vec4f output{};
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        output[i] = vector[i] / length;
+    }
+
+    return output;
+}
+
+TEST_CASE("vec4f and mat4f operations", "[math_test]")
+{
+    static constexpr cpt::mat4f left{cpt::vec4f{1.0f, 2.0f, 3.0f, 4.0f}, cpt::vec4f{5.0f, 6.0f, 7.0f, 8.0f}, cpt::vec4f{9.0f, 10.0f, 11.0f, 12.0f}, cpt::vec4f{13.0f, 14.0f, 15.0f, 16.0f}};
+    static constexpr cpt::mat4f right{cpt::vec4f{2.0f, 0.0f, 1.0f, 0.0f}, cpt::vec4f{0.0f, 3.0f, 0.0f, 1.0f}, cpt::vec4f{1.0f, 0.0f, 4.0f, 0.0f}, cpt::vec4f{0.0f, 1.0f, 0.0f, 5.0f}};
+    static constexpr cpt::vec4f vector{1.0f, -2.0f, 3.0f, 0.5f};
+
+    SECTION("Operations are usable in constant expressions")
+    {
+        static constexpr auto product{left * right};
+        static_assert(product[0][0] == 5.0f && product[1][3] == 46.0f && product[3][2] == 73.0f);
+
+        static constexpr auto transformed{left * vector};
+        static_assert(transformed[0] == 8.0f && transformed[3] == 38.0f);
+
+        static_assert(cpt::dot(vector, vector) == 14.25f);
+        static_assert((vector + vector)[1] == -4.0f && (vector / cpt::vec4f{2.0f})[3] == 0.25f);
+    }
+
+    SECTION("Runtime operations match the scalar implementation")
+    {
+        //Go through volatile to prevent constant folding
+        volatile float scale{1.0f};
+        const auto runtime_left{left * cpt::mat4f{cpt::identity} * cpt::scale(cpt::vec3f{scale})};
+        const auto runtime_vector{vector * cpt::vec4f{scale}};
+
+        const auto product{runtime_left * right};
+        const auto reference_product{scalar_multiply(left, right)};
+
+        const auto transformed{runtime_left * runtime_vector};
+        const auto reference_transformed{scalar_multiply(left, vector)};
+
+        const auto normalized{cpt::normalize(runtime_vector)};
+        const auto reference_normalized{scalar_normalize(vector)};
+
+        for(std::size_t i{}; i < 4; ++i)
+        {
+            for(std::size_t j{}; j < 4; ++j)
+            {
+                REQUIRE(product[i][j] == Approx(reference_product[i][j]));
+            }
+
+            REQUIRE(transformed[i] == Approx(reference_transformed[i]));
+            REQUIRE(normalized[i] == Approx(reference_normalized[i]));
+        }
+
+        REQUIRE(cpt::vec4f{scale}[3] == 1.0f);
+        REQUIRE(cpt::dot(runtime_vector, runtime_vector) == Approx(14.25f));
+    }
+}
+
+TEST_CASE("vec4f and mat4f benchmark", "[math_bench][.]")
+{
+    static constexpr std::size_t count{4096};
+
+    std::vector<cpt::mat4f> matrices(count);
+    std::vector<cpt::vec4f> vectors(count);
+    std::vector<cpt::mat4f> matrix_outputs(count);
+    std::vector<cpt::vec4f> vector_outputs(count);
+
+    for(std::size_t i{}; i < count; ++i)
+    {
+        const auto value{static_cast<float>(i)};
+
+        matrices[i] = cpt::model(cpt::vec3f{value, value * 0.5f, 0.0f}, value * 0.01f, cpt::vec3f{0.0f, 0.0f, 1.0f}, cpt::vec3f{1.0f}, cpt::vec3f{0.0f});
+        vectors[i] = cpt::vec4f{value, value + 1.0f, value + 2.0f, 1.0f};
+    }
+
+    const auto view{cpt::look_at(cpt::vec3f{0.0f, 0.0f, -10.0f}, cpt::vec3f{0.0f}, cpt::vec3f{0.0f, 1.0f, 0.0f})};
+
+    BENCHMARK("scalar mat4f * mat4f")
+    {
+        for(std::size_t i{}; i < count; ++i)
+        {
+            matrix_outputs[i] = scalar_multiply(view, matrices[i]);
+        }
+
+        return matrix_outputs.back()[0][0];
+    };
+
+    BENCHMARK("cpt::mat4f * cpt::mat4f")
+    {
+        for(std::size_t i{}; i < count; ++i)
+        {
+            matrix_outputs[i] = view * matrices[i];
+        }
+
+        return matrix_outputs.back()[0][0];
+    };
+
+    BENCHMARK("scalar mat4f * vec4f")
+    {
+        for(std::size_t i{}; i < count; ++i)
+        {
+            vector_outputs[i] = scalar_multiply(matrices[i], vectors[i]);
+        }
+
+        return vector_outputs.back()[0];
+    };
+
+    BENCHMARK("cpt::mat4f * cpt::vec4f")
+    {
+        for(std::size_t i{}; i < count; ++i)
+        {
+            vector_outputs[i] = matrices[i] * vectors[i];
+        }
+
+        return vector_outputs.back()[0];
+    };
+
+    BENCHMARK("scalar normalize")
+    {
+        for(std::size_t i{}; i < count; ++i)
+        {
+            vector_outputs[i] = scalar_normalize(vectors[i]);
+        }
+
+        return vector_outputs.back()[0];
+    };
+
+    BENCHMARK("cpt::normalize")
+    {
+        for(std::size_t i{}; i < count; ++i)
+        {
+            vector_outputs[i] = cpt::normalize(vectors[i]);
+        }
+
+        return vector_outputs.back()[0];
+    };
+}
@@ -0,0 +1,150 @@
+#include <swell/audio_world.hpp>
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <cmath>
+#include <numbers>
+
+//Audio world benchmark, it mixes synthetic sounds for several listeners and prints a JSON report.
+//It needs no audio device, every block is generated as fast as possible.
+//Arguments: [block count] [worker count]
+
+static constexpr std::uint32_t sample_rate{44100};
+static constexpr std::size_t frame_count{1024};
+
+//A sine wave computed on each read, to have a decoding cost without any file
+class sine_reader final : public swl::sound_reader
+{
+public:
+    sine_reader(float frequency, std::uint32_t channel_count)
+    :m_frequency{frequency}
+    {
+        set_info(swl::sound_info{sample_rate * 3600ull, sample_rate, channel_count, true});
+    }
+
+    bool read(float* output, std::size_t frame_count) override
+    {
+        const auto channel_count{info().channel_count};
+        const auto step{2.0f * std::numbers::pi_v<float> * m_frequency / static_cast<float>(sample_rate)};
+
+        for(std::size_t i{}; i < frame_count; ++i)
+        {
+            const float value{std::sin(static_cast<float>(m_position + i) * step) * 0.5f};
+
+            for(std::uint32_t j{}; j < channel_count; ++j)
+            {
+                output[i * channel_count + j] = value;
+            }
+        }
+
+        m_position += frame_count;
+
+        return true;
+    }
+
+    void seek(std::uint64_t frame) override
+    {
+        m_position = frame;
+    }
+
+    std::uint64_t tell() override
+    {
+        return m_position;
+    }
+
+private:
+    float m_frequency{};
+    std::uint64_t m_position{};
+};
+
+static void run(std::size_t block_count, std::size_t worker_count, std::size_t listener_count, std::size_t sound_count, bool first)
+{
+    swl::audio_world world{sample_rate, worker_count};
+
+    std::vector<swl::sound> sounds{};
+    sounds.reserve(sound_count);
+
+    //Half of the sounds are mono and spatialized, deterministic so results can be compared between commits
+    for(std::size_t i{}; i < sound_count; ++i)
+    {
+        const auto channel_count{i % 2 == 0 ? 1u : 2u};
+        auto& sound{sounds.emplace_back(world, std::make_unique<sine_reader>(220.0f + static_cast<float>(i), channel_count))};
+
+        if(channel_count == 1)
+        {
+            sound.enable_spatialization();
+            sound.move_to(swl::vec3f{static_cast<float>(i % 16) - 8.0f, 0.0f, static_cast<float>(i / 16) - 8.0f});
+        }
+
+        sound.start();
+    }
+
+    std::vector<swl::listener> listeners{};
+    for(std::size_t i{}; i < listener_count; ++i)
+    {
+        listeners.emplace_back(2).move_to(swl::vec3f{static_cast<float>(i) * 4.0f, 0.0f, 0.0f});
+    }
+
+    std::vector<float> drained{};
+    drained.resize(frame_count * 2);
+
+    double total{};
+    double maximum{};
+
+    for(std::size_t i{}; i < block_count; ++i)
+    {
+        for(auto& listener : listeners)
+        {
+            world.bind_listener(listener);
+        }
+
+        const auto begin{swl::clock::now()};
+        world.generate(frame_count);
+        const auto time{std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(swl::clock::now() - begin).count()};
+
+        total += time;
+        maximum = std::max(maximum, time);
+
+        for(auto& listener : listeners)
+        {
+            listener.drain(std::begin(drained), frame_count);
+        }
+    }
+
+    const auto voices{world.voice_stats()};
+
+    std::cout << (first ? "" : ",\n") << "    {\"listeners\": " << listener_count << ", \"sounds\": " << sound_count << ", \"workers\": " << worker_count
+              << ", \"real_voices\": " << voices.real_count << ", \"mean_us\": " << total / static_cast<double>(block_count) << ", \"max_us\": " << maximum << "}";
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const std::size_t block_count{argc > 1 ? static_cast<std::size_t>(std::stoul(argv[1])) : 200};
+        const std::size_t worker_count{argc > 2 ? static_cast<std::size_t>(std::stoul(argv[2])) : std::max(std::thread::hardware_concurrency(), 2u) - 1};
+
+        std::cout << "{\n  \"frame_count\": " << frame_count << ",\n  \"block_count\": " << block_count << ",\n  \"results\": [\n";
+
+        bool first{true};
+        for(const std::size_t workers : {std::size_t{0}, worker_count})
+        {
+            for(std::size_t listener_count{1}; listener_count <= 4; ++listener_count)
+            {
+                for(const std::size_t sound_count : {50, 100, 250, 500})
+                {
+                    run(block_count, workers, listener_count, sound_count, first);
+                    first = false;
+                }
+            }
+        }
+
+        std::cout << "\n  ]\n}" << std::endl;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "An exception as been throw: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -25,6 +25,8 @@
 #include <cassert>
 #include <numbers>
 
+#include <captal_foundation/profiler.hpp>
+
 namespace swl
 {
 
@@ -141,253 +143,263 @@ vec3f listener::direction() const
 }
 
 sound::sound(audio_world& world, std::unique_ptr<sound_reader> reader)
-:m_data{world.make_sound()}
+:m_world{&world}
+,m_data{world.make_sound(std::move(reader))}
 {
-    m_data->reader = std::move(reader);
+
 }
 
 sound::~sound()
 {
     if(m_data)
     {
-        std::lock_guard lock{m_data->mutex};
-
-        m_data->state.status = sound_status::freed;
+        send(impl::sound_command_type::free);
     }
 }
 
 sound::sound(sound&& other) noexcept
-:m_data{std::exchange(other.m_data, nullptr)}
+:m_world{other.m_world}
+,m_data{std::exchange(other.m_data, nullptr)}
+,m_state{other.m_state}
+,m_generation{other.m_generation}
 {
 
 }
 
 sound& sound::operator=(sound&& other) noexcept
 {
+    m_world = std::exchange(other.m_world, m_world);
     m_data = std::exchange(other.m_data, m_data);
+    m_state = std::exchange(other.m_state, m_state);
+    m_generation = std::exchange(other.m_generation, m_generation);
 
     return *this;
 }
 
 void sound::start()
 {
-    std::lock_guard lock{m_data->mutex};
+    assert((status() == sound_status::stopped || status() == sound_status::ended || status() == sound_status::aborted) && "swl::sound::start() can only be called on stopped, ended or arboted sound.");
 
-    assert((m_data->state.status == sound_status::stopped || m_data->state.status == sound_status::ended || m_data->state.status == sound_status::aborted) && "swl::sound::start() can only be called on stopped, ended or arboted sound.");
+    m_state.status = sound_status::playing;
+    ++m_generation;
 
-    m_data->reader->seek(0);
-    m_data->state.status = sound_status::playing;
-    m_data->state.current_fading = 0;
-    m_data->state.fading = std::numeric_limits<std::uint64_t>::max();
+    send(impl::sound_command_type::start);
 }
 
 void sound::stop()
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.status = sound_status::stopped;
+    ++m_generation;
 
-    m_data->state.status = sound_status::stopped;
+    send(impl::sound_command_type::stop);
 }
 
 void sound::pause()
 {
-    std::lock_guard lock{m_data->mutex};
+    const auto current{status()};
+
+    assert((current == sound_status::playing || current == sound_status::fading_in || current == sound_status::fading_out) && "swl::sound::pause() can only be called on playing or fading sound.");
 
-    assert((m_data->state.status == sound_status::playing || m_data->state.status == sound_status::fading_in || m_data->state.status == sound_status::fading_out) && "swl::sound::pause() can only be called on playing or fading sound.");
+    m_state.pause_initial_status = current;
+    m_state.status = sound_status::paused;
+    ++m_generation;
 
-    m_data->state.pause_initial_status = m_data->state.status;
-    m_data->state.status = sound_status::paused;
+    send(impl::sound_command_type::pause);
 }
 
 void sound::resume()
 {
-    std::lock_guard lock{m_data->mutex};
+    assert(status() == sound_status::paused && "swl::sound::resume() can only be called on paused sound.");
 
-    assert(m_data->state.status == sound_status::paused && "swl::sound::resume() can only be called on paused sound.");
+    m_state.status = m_state.pause_initial_status;
+    ++m_generation;
 
-    m_data->state.status = m_data->state.pause_initial_status;
+    send(impl::sound_command_type::resume);
 }
 
 void sound::fade_in(std::uint64_t frames)
 {
-    std::lock_guard lock{m_data->mutex};
+    const auto current{status()};
 
-    assert((m_data->state.status == sound_status::stopped || m_data->state.status == sound_status::ended || m_data->state.status == sound_status::aborted || m_data->state.status == sound_status::paused) && "swl::sound::fade_in() can only be called on stopped, ended, paused or aborted sound.");
+    assert((current == sound_status::stopped || current == sound_status::ended || current == sound_status::aborted || current == sound_status::paused) && "swl::sound::fade_in() can only be called on stopped, ended, paused or aborted sound.");
 
-    if(m_data->state.status == sound_status::stopped || m_data->state.status == sound_status::ended || m_data->state.status == sound_status::aborted)
-    {
-        //Can not call start() because the mutex is already locked
-        m_data->reader->seek(0);
-        m_data->state.current_fading = 0;
-    }
+    m_state.status = sound_status::fading_in;
+    ++m_generation;
 
-    m_data->state.status = sound_status::fading_in;
-    m_data->state.fading = frames;
+    send(impl::sound_command_type::fade_in, frames);
 }
 
 void sound::fade_out(std::uint64_t frames)
 {
-    std::lock_guard lock{m_data->mutex};
+    assert(status() == sound_status::playing && "swl::sound::fade_out() can only be called on playing sound.");
 
-    assert(m_data->state.status == sound_status::playing && "swl::sound::fade_out() can only be called on playing sound.");
+    m_state.status = sound_status::fading_out;
+    ++m_generation;
 
-    m_data->state.status = sound_status::fading_out;
-    m_data->state.fading = frames;
+    send(impl::sound_command_type::fade_out, frames);
 }
 
 void sound::set_volume(float volume)
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.volume = get_volume_multiplier(volume);
 
-    m_data->state.volume = get_volume_multiplier(volume);
+    send(impl::sound_command_type::parameters);
 }
 
 void sound::set_loop_points(std::uint64_t begin_frame, std::uint64_t end_frame)
 {
-    std::lock_guard lock{m_data->mutex};
-
     assert(m_data->reader->info().seekable && "looped sound's reader must be seekable.");
     assert(m_data->reader->info().frame_count >= end_frame && "looped sound's end frame outside reader bounds.");
 
-    m_data->state.loop_begin = begin_frame;
-    m_data->state.loop_end = end_frame;
+    m_state.loop_begin = begin_frame;
+    m_state.loop_end = end_frame;
+
+    send(impl::sound_command_type::parameters);
 }
 
 void sound::enable_spatialization()
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.spatialization.enable = true;
 
-    m_data->state.spatialization.enable = true;
+    send(impl::sound_command_type::parameters);
 }
 
 void sound::disable_spatialization()
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.spatialization.enable = false;
 
-    m_data->state.spatialization.enable = false;
+    send(impl::sound_command_type::parameters);
 }
 
 void sound::relative_spatialization()
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.spatialization.relative = true;
 
-    m_data->state.spatialization.relative = true;
+    send(impl::sound_command_type::parameters);
 }
 
 void sound::absolute_spatialization()
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.spatialization.relative = false;
 
-    m_data->state.spatialization.relative = false;
+    send(impl::sound_command_type::parameters);
 }
 
 void sound::set_minimum_distance(float distance)
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.spatialization.minimum_distance = distance;
 
-    m_data->state.spatialization.minimum_distance = distance;
+    send(impl::sound_command_type::parameters);
 }
 
 void sound::set_attenuation(float attenuation)
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.spatialization.attenuation = attenuation;
 
-    m_data->state.spatialization.attenuation = attenuation;
+    send(impl::sound_command_type::parameters);
 }
 
 void sound::move(const vec3f& relative)
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.spatialization.position += relative;
 
-    m_data->state.spatialization.position += relative;
+    send(impl::sound_command_type::parameters);
 }
 
 void sound::move_to(const vec3f& position)
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.spatialization.position = position;
 
-    m_data->state.spatialization.position = position;
+    send(impl::sound_command_type::parameters);
 }
 
-void sound::seek(std::uint64_t frame)
+void sound::set_priority(std::int32_t priority)
 {
-    std::lock_guard lock{m_data->mutex};
+    m_state.priority = priority;
+
+    send(impl::sound_command_type::parameters);
+}
 
-    m_data->reader->seek(frame);
+void sound::seek(std::uint64_t frame)
+{
+    send(impl::sound_command_type::seek, frame);
 }
 
 std::unique_ptr<sound_reader> sound::change_reader(std::unique_ptr<sound_reader> new_reader)
 {
-    std::lock_guard lock{m_data->mutex};
+    std::unique_lock lock{m_data->reader_mutex};
+    std::unique_ptr<sound_reader> output{std::exchange(m_data->reader, std::move(new_reader))};
+    lock.unlock();
 
-    std::unique_ptr<sound_reader> output{std::move(m_data->reader)};
+    m_state.status = sound_status::stopped;
+    ++m_generation;
 
-    m_data->reader = std::move(new_reader);
-    m_data->state.status = sound_status::stopped;
+    send(impl::sound_command_type::stop);
 
     return output;
 }
 
 sound_status sound::status() const
 {
-    std::lock_guard lock{m_data->mutex};
+    const auto published{m_data->published_status.load(std::memory_order_acquire)};
 
-    return m_data->state.status;
+    if(static_cast<std::uint32_t>(published >> 32) == m_generation) //The audio thread has applied our last command
+    {
+        return static_cast<sound_status>(published & 0xFFFFFFFF);
+    }
+
+    return m_state.status;
 }
 
 float sound::volume() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.volume;
+    return m_state.volume;
 }
 
 std::pair<std::uint64_t, std::uint64_t> sound::loop_points() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return std::make_pair(m_data->state.loop_begin, m_data->state.loop_end);
+    return std::make_pair(m_state.loop_begin, m_state.loop_end);
 }
 
 bool sound::is_spatialization_enabled() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.spatialization.enable;
+    return m_state.spatialization.enable;
 }
 
 bool sound::is_spatialization_relative() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.spatialization.relative;
+    return m_state.spatialization.relative;
 }
 
 float sound::minimum_distance() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.spatialization.minimum_distance;
+    return m_state.spatialization.minimum_distance;
 }
 
 float sound::attenuation() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.spatialization.attenuation;
+    return m_state.spatialization.attenuation;
 }
 
 vec3f sound::position() const
 {
-    std::lock_guard lock{m_data->mutex};
+    return m_state.spatialization.position;
+}
 
-    return m_data->state.spatialization.position;
+std::int32_t sound::priority() const
+{
+    return m_state.priority;
 }
 
+//Position at the end of the last block generated by the audio thread
 std::uint64_t sound::tell() const
 {
-    std::lock_guard lock{m_data->mutex};
+    return m_data->published_position.load(std::memory_order_acquire);
+}
 
-    return m_data->reader->tell();
+void sound::send(impl::sound_command_type type, std::uint64_t frame)
+{
+    m_world->send(impl::sound_command{m_data, type, m_generation, frame, m_state});
 }
 
 static constexpr float fast_pow(float value, std::size_t count) noexcept
@@ -427,6 +439,23 @@ static constexpr float fast_pow(float value, std::size_t count) noexcept
     return output;
 }
 
+static bool is_active(sound_status status) noexcept
+{
+    return status == sound_status::playing || status == sound_status::fading_in || status == sound_status::fading_out;
+}
+
+static float distance_attenuation(const impl::listener_state& listener, const impl::sound_state& sound) noexcept
+{
+    const vec3f listener_position{listener.spatialization.position};
+    const vec3f sound_position   {sound.spatialization.relative ? listener_position + sound.spatialization.position : sound.spatialization.position};
+
+    const float distance   {cpt::distance(sound_position, listener_position)};
+    const float minimum    {sound.spatialization.minimum_distance};
+    const float attenuation{sound.spatialization.attenuation};
+
+    return minimum / (minimum + attenuation * (std::max(distance, minimum) - minimum));
+}
+
 static constexpr float sign(float value) noexcept
 {
     return value >= 0.0f ? 1.0f : -1.0f;
@@ -437,122 +466,259 @@ inline float mix_amplitude(float value, std::size_t count) noexcept
     return sign(value) * (1.0f - fast_pow(1.0f - std::abs(value), count));
 }
 
-audio_world::audio_world(std::uint32_t sample_rate)
+audio_world::audio_world(std::uint32_t sample_rate, std::size_t worker_count)
 :m_sample_rate{sample_rate}
+,m_workers{worker_count}
 {
 
 }
 
+audio_world::~audio_world()
+{
+    //Sounds that were created but never reached the audio thread are still owned by their "add" command
+    process_commands();
+}
+
 void audio_world::set_up(const vec3f& direction)
 {
     m_up = cpt::normalize(direction);
 }
 
+void audio_world::set_voice_limit(std::size_t count)
+{
+    std::lock_guard lock{m_mutex};
+
+    m_voice_limit = count;
+}
+
+void audio_world::set_audibility_threshold(float threshold)
+{
+    std::lock_guard lock{m_mutex};
+
+    m_audibility_threshold = threshold;
+}
+
 void audio_world::discard(std::size_t frame_count)
 {
     std::unique_lock lock{m_mutex};
 
+    process_commands();
     discard_impl(frame_count);
     free_resources();
 }
 
 void audio_world::generate(std::size_t frame_count)
 {
+    CAPTAL_PROFILE_SCOPE("swl::audio_world::generate");
+
     std::unique_lock lock{m_mutex};
 
+    process_commands();
+
     if(std::empty(m_listeners_data))
     {
         discard_impl(frame_count);
+        free_resources();
 
         return;
     }
 
-    m_sample_buffer.clear();
     store_sounds_data(frame_count);
 
     lock.unlock();
 
-    for(auto& sound : m_sounds_data)
+    //Each listener has its own queue, the pool joins before the resources are freed
+    m_workers.parallel_for(std::size(m_listeners_data), [this, frame_count](std::size_t index)
     {
-        apply_fading(sound, frame_count);
-    }
+        mix_listener(m_listeners_data[index], frame_count);
+    });
 
-    for(auto& listener : m_listeners_data)
+    lock.lock();
+
+    free_resources();
+}
+
+vec3f audio_world::up() const
+{
+    std::lock_guard lock{m_mutex};
+
+    return m_up;
+}
+
+std::size_t audio_world::voice_limit() const
+{
+    std::lock_guard lock{m_mutex};
+
+    return m_voice_limit;
+}
+
+float audio_world::audibility_threshold() const
+{
+    std::lock_guard lock{m_mutex};
+
+    return m_audibility_threshold;
+}
+
+audio_world::voice_statistics audio_world::voice_stats() const noexcept
+{
+    voice_statistics output{};
+    output.real_count = m_published_real_count.load(std::memory_order_relaxed);
+    output.virtual_count = m_published_virtual_count.load(std::memory_order_relaxed);
+
+    return output;
+}
+
+impl::sound_data* audio_world::make_sound(std::unique_ptr<sound_reader> reader)
+{
+    auto sound{make_pooled<impl::sound_data>(m_sound_pool)};
+    sound->reader = std::move(reader);
+
+    //Ownership is transfered to the audio thread by the "add" command
+    const auto output{sound.release()};
+    send(impl::sound_command{output, impl::sound_command_type::add});
+
+    return output;
+}
+
+void audio_world::send(const impl::sound_command& command)
+{
+    m_commands.push(command);
+}
+
+void audio_world::process_commands()
+{
+    m_commands.drain([this](const impl::sound_command& command)
     {
-        std::lock_guard lock{*listener.queue};
+        process_command(command);
+    });
+}
 
-        m_listener_samples = listener.queue->begin(frame_count * listener.state.channel_count);
+void audio_world::process_command(const impl::sound_command& command)
+{
+    auto& sound{*command.sound};
 
-        for(auto& sound : m_sounds_data)
+    try
+    {
+        switch(command.type)
         {
-            if(sound.state.channel_count == 1 && listener.state.spatialization.enable && sound.state.spatialization.enable)
-            {
-                spatialize(listener, sound, frame_count);
-            }
-            else if(sound.state.channel_count != listener.state.channel_count)
+            case impl::sound_command_type::add:
+                m_sounds.emplace_back(command.sound, pool_delete<impl::sound_data>{&m_sound_pool});
+                break;
+
+            case impl::sound_command_type::free:
+                sound.state.status = sound_status::freed;
+                break;
+
+            case impl::sound_command_type::start:
             {
-                adjust_channels(listener, sound, frame_count);
+                std::lock_guard lock{sound.reader_mutex};
+
+                sound.reader->seek(0);
+                sound.state.status = sound_status::playing;
+                sound.state.current_fading = 0;
+                sound.state.fading = std::numeric_limits<std::uint64_t>::max();
+                break;
             }
-            else //no spacialization and sound.state.channel_count == listener.state.channel_count
-            {
-                const float volume{sound.state.volume * listener.state.volume};
 
-                for(std::size_t i{}; i < std::size(sound.samples); ++i)
+            case impl::sound_command_type::stop:
+                sound.state.status = sound_status::stopped;
+                break;
+
+            case impl::sound_command_type::pause:
+                if(sound.state.status == sound_status::playing || sound.state.status == sound_status::fading_in || sound.state.status == sound_status::fading_out)
                 {
-                    m_listener_samples[i] += sound.samples[i] * volume;
+                    sound.state.pause_initial_status = sound.state.status;
+                    sound.state.status = sound_status::paused;
                 }
-            }
-        }
+                break;
 
-        mix_sounds();
+            case impl::sound_command_type::resume:
+                if(sound.state.status == sound_status::paused)
+                {
+                    sound.state.status = sound.state.pause_initial_status;
+                }
+                break;
 
-        listener.queue->end();
-    }
+            case impl::sound_command_type::fade_in:
+                if(sound.state.status == sound_status::stopped || sound.state.status == sound_status::ended || sound.state.status == sound_status::aborted)
+                {
+                    std::lock_guard lock{sound.reader_mutex};
 
-    lock.lock();
+                    sound.reader->seek(0);
+                    sound.state.current_fading = 0;
+                }
 
-    free_resources();
-}
+                sound.state.status = sound_status::fading_in;
+                sound.state.fading = command.frame;
+                break;
 
-vec3f audio_world::up() const
-{
-    std::lock_guard lock{m_mutex};
+            case impl::sound_command_type::fade_out:
+                sound.state.status = sound_status::fading_out;
+                sound.state.fading = command.frame;
+                break;
 
-    return m_up;
-}
+            case impl::sound_command_type::seek:
+            {
+                std::lock_guard lock{sound.reader_mutex};
 
-impl::sound_data* audio_world::make_sound()
-{
-    std::lock_guard lock{m_mutex};
+                sound.reader->seek(command.frame);
+                break;
+            }
+
+            case impl::sound_command_type::parameters:
+                sound.state.volume = command.parameters.volume;
+                sound.state.loop_begin = command.parameters.loop_begin;
+                sound.state.loop_end = command.parameters.loop_end;
+                sound.state.priority = command.parameters.priority;
+                sound.state.spatialization = command.parameters.spatialization;
+                break;
+        }
+    }
+    catch(...)
+    {
+        sound.state.status = sound_status::aborted;
+    }
 
-    m_sounds.push_back(std::make_unique<impl::sound_data>());
+    if(command.type != impl::sound_command_type::add && command.type != impl::sound_command_type::free)
+    {
+        sound.generation = command.generation;
+    }
+}
 
-    return m_sounds.back().get();
+void audio_world::publish(impl::sound_data& sound)
+{
+    sound.published_position.store(sound.reader->tell(), std::memory_order_release);
+    sound.published_status.store((static_cast<std::uint64_t>(sound.generation) << 32) | static_cast<std::uint32_t>(sound.state.status), std::memory_order_release);
 }
 
 void audio_world::discard_impl(std::size_t frame_count)
 {
-    m_sample_buffer.reserve(4096);
-    m_sample_buffer.resize(m_sample_buffer.capacity());
+    std::size_t virtual_count{};
 
     for(auto& sound : m_sounds)
     {
-        std::lock_guard sound_lock{sound->mutex};
+        std::lock_guard sound_lock{sound->reader_mutex};
 
         try
         {
-            if(sound->state.status == sound_status::playing || sound->state.status == sound_status::fading_in || sound->state.status == sound_status::fading_out)
+            if(is_active(sound->state.status))
             {
                 sound->state.channel_count = sound->reader->info().channel_count;
 
                 discard_sound_data(*sound, frame_count);
+                ++virtual_count;
             }
         }
         catch(...)
         {
             sound->state.status = sound_status::aborted;
         }
+
+        publish(*sound);
     }
+
+    m_published_real_count.store(0, std::memory_order_relaxed);
+    m_published_virtual_count.store(virtual_count, std::memory_order_relaxed);
 }
 
 void audio_world::discard_sound_data(impl::sound_data& sound, std::size_t frame_count)
@@ -582,14 +748,17 @@ void audio_world::discard_sound_data(impl::sound_data& sound, std::size_t frame_
         }
         else
         {
-            const auto buffer_size{std::size(m_sample_buffer) / sound.state.channel_count};
+            thread_local std::vector<float> buffer{}; //Sounds may be discarded on several workers at once
+            buffer.resize(4096);
+
+            const auto buffer_size{std::size(buffer) / sound.state.channel_count};
 
             std::size_t read{};
             while(read < frame_count)
             {
                 const auto count{std::min(buffer_size, frame_count - read)};
 
-                if(!sound.reader->read(std::data(m_sample_buffer), count))
+                if(!sound.reader->read(std::data(buffer), count))
                 {
                     sound.state.status = sound_status::ended;
                     return;
@@ -606,39 +775,167 @@ void audio_world::discard_sound_data(impl::sound_data& sound, std::size_t frame_
     }
 }
 
+float audio_world::audibility(const impl::sound_state& sound) const noexcept
+{
+    float output{};
+
+    for(auto& listener : m_listeners_data)
+    {
+        float value{sound.volume * listener.state.volume};
+
+        if(sound.channel_count == 1 && listener.state.spatialization.enable && sound.spatialization.enable)
+        {
+            value *= distance_attenuation(listener.state, sound);
+        }
+
+        output = std::max(output, value);
+    }
+
+    return output;
+}
+
+void audio_world::select_voices()
+{
+    const auto threshold{m_audibility_threshold};
+
+    const auto audible_end{std::partition(std::begin(m_voices), std::end(m_voices), [threshold](const voice& voice)
+    {
+        return voice.audibility >= threshold;
+    })};
+
+    const auto audible_count{static_cast<std::size_t>(std::distance(std::begin(m_voices), audible_end))};
+
+    m_real_voice_count = std::min(audible_count, m_voice_limit);
+
+    if(m_real_voice_count < audible_count) //Keep the highest priorities, then the loudest
+    {
+        const auto compare = [](const voice& left, const voice& right)
+        {
+            if(left.sound->state.priority != right.sound->state.priority)
+            {
+                return left.sound->state.priority > right.sound->state.priority;
+            }
+
+            return left.audibility > right.audibility;
+        };
+
+        const auto real_end{std::begin(m_voices) + static_cast<std::ptrdiff_t>(m_real_voice_count)};
+        std::nth_element(std::begin(m_voices), real_end, audible_end, compare);
+    }
+}
+
 void audio_world::store_sounds_data(std::size_t frame_count)
 {
-    m_sounds_data.clear();
-    m_sounds_data.reserve(std::size(m_sounds));
+    m_voices.clear();
+    m_voices.reserve(std::size(m_sounds));
 
+    //The reader may be changed by the sound owner at any time, it is only used under the sound lock
     for(auto& sound : m_sounds)
     {
-        std::lock_guard sound_lock{sound->mutex};
+        std::lock_guard sound_lock{sound->reader_mutex};
 
-        try
+        if(is_active(sound->state.status))
         {
-            if(sound->state.status == sound_status::playing || sound->state.status == sound_status::fading_in || sound->state.status == sound_status::fading_out)
+            try
             {
                 sound->state.channel_count = sound->reader->info().channel_count;
 
-                m_sounds_data.emplace_back(get_sound_data(*sound, frame_count), sound->state);
+                m_voices.emplace_back(voice{sound.get(), audibility(sound->state)});
+
+                continue; //Voices are published once their data is stored
+            }
+            catch(...)
+            {
+                sound->state.status = sound_status::aborted;
             }
         }
-        catch(...)
-        {
-            sound->state.status = sound_status::aborted;
-        }
+
+        publish(*sound);
+    }
+
+    select_voices();
+
+    //Real voices decode into their own part of the sample buffer, so they can be decoded in parallel
+    std::size_t sample_count{};
+    for(std::size_t i{}; i < m_real_voice_count; ++i)
+    {
+        sample_count += frame_count * m_voices[i].sound->state.channel_count;
+    }
+
+    m_sample_buffer.resize(sample_count);
+    m_sounds_data.resize(m_real_voice_count);
+
+    std::size_t offset{};
+    for(std::size_t i{}; i < m_real_voice_count; ++i)
+    {
+        const auto count{frame_count * m_voices[i].sound->state.channel_count};
+
+        m_sounds_data[i].samples = std::span<float>{std::data(m_sample_buffer) + offset, count};
+        offset += count;
     }
+
+    m_workers.parallel_for(std::size(m_voices), [this, frame_count](std::size_t index)
+    {
+        store_sound_data(index, frame_count);
+    });
+
+    //Voices that failed or whose reader changed are not mixed this time
+    const auto empty_predicate = [](const sound_data_buffer& sound)
+    {
+        return std::empty(sound.samples);
+    };
+
+    m_sounds_data.erase(std::remove_if(std::begin(m_sounds_data), std::end(m_sounds_data), empty_predicate), std::end(m_sounds_data));
+
+    m_published_real_count.store(std::size(m_sounds_data), std::memory_order_relaxed);
+    m_published_virtual_count.store(std::size(m_voices) - std::size(m_sounds_data), std::memory_order_relaxed);
 }
 
-std::span<float> audio_world::get_sound_data(impl::sound_data& sound, std::size_t frame_count)
+void audio_world::store_sound_data(std::size_t index, std::size_t frame_count)
 {
-    const auto begin{std::size(m_sample_buffer)};
-    const auto count{frame_count * sound.state.channel_count};
+    auto& sound{*m_voices[index].sound};
 
-    m_sample_buffer.resize(begin + count);
+    std::lock_guard sound_lock{sound.reader_mutex};
 
-    const auto output  {std::data(m_sample_buffer) + begin};
+    try
+    {
+        bool stored{};
+
+        if(index < m_real_voice_count)
+        {
+            auto& data{m_sounds_data[index]};
+            const auto samples{std::exchange(data.samples, std::span<float>{})};
+
+            if(sound.reader->info().channel_count == sound.state.channel_count)
+            {
+                get_sound_data(sound, samples, frame_count);
+
+                data.samples = samples;
+                data.state = sound.state;
+                apply_fading(data, frame_count);
+
+                stored = true;
+            }
+        }
+
+        //Virtual voice, or the reader has been changed since the voices were selected: only advance its position
+        if(!stored)
+        {
+            sound.state.channel_count = sound.reader->info().channel_count;
+            discard_sound_data(sound, frame_count);
+        }
+    }
+    catch(...)
+    {
+        sound.state.status = sound_status::aborted;
+    }
+
+    publish(sound);
+}
+
+void audio_world::get_sound_data(impl::sound_data& sound, std::span<float> samples, std::size_t frame_count)
+{
+    const auto output  {std::data(samples)};
     const auto position{sound.reader->tell()};
 
     if((position + frame_count) > sound.state.loop_end) //Loop
@@ -680,8 +977,6 @@ std::span<float> audio_world::get_sound_data(impl::sound_data& sound, std::size_
     {
         sound.state.status = sound_status::ended;
     }
-
-    return std::span<float>{output, frame_count * sound.state.channel_count};
 }
 
 void audio_world::apply_fading(sound_data_buffer& sound, std::size_t frame_count)
@@ -710,23 +1005,52 @@ void audio_world::apply_fading(sound_data_buffer& sound, std::size_t frame_count
     }
 }
 
-void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept
+void audio_world::mix_listener(listener_data_buffer& listener, std::size_t frame_count)
+{
+    std::lock_guard lock{*listener.queue};
+
+    const auto output{listener.queue->begin(frame_count * listener.state.channel_count)};
+
+    for(auto& sound : m_sounds_data)
+    {
+        if(sound.state.channel_count == 1 && listener.state.spatialization.enable && sound.state.spatialization.enable)
+        {
+            spatialize(listener, sound, output, frame_count);
+        }
+        else if(sound.state.channel_count != listener.state.channel_count)
+        {
+            adjust_channels(listener, sound, output, frame_count);
+        }
+        else //no spacialization and sound.state.channel_count == listener.state.channel_count
+        {
+            const float volume{sound.state.volume * listener.state.volume};
+
+            for(std::size_t i{}; i < std::size(sound.samples); ++i)
+            {
+                output[i] += sound.samples[i] * volume;
+            }
+        }
+    }
+
+    mix_sounds(output);
+
+    listener.queue->end();
+}
+
+void audio_world::spatialize(const listener_data_buffer& listener, const sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) noexcept
 {
     const vec3f listener_position  {listener.state.spatialization.position};
     const vec3f sound_base_position{sound.state.spatialization.position};
     const vec3f sound_position     {sound.state.spatialization.relative ? listener_position + sound_base_position : sound_base_position};
 
-    const float distance   {cpt::distance(sound_position, listener_position)};
-    const float minimum    {sound.state.spatialization.minimum_distance};
-    const float attenuation{sound.state.spatialization.attenuation};
-    const float volume     {sound.state.volume * listener.state.volume};
-    const float factor     {(minimum / (minimum + attenuation * (std::max(distance, minimum) - minimum))) * volume};
+    const float volume{sound.state.volume * listener.state.volume};
+    const float factor{distance_attenuation(listener.state, sound.state) * volume};
 
     if(listener.state.channel_count == 1)
     {
         for(std::size_t i{}; i < frame_count; ++i)
         {
-            m_listener_samples[i] += sound.samples[i] * factor;
+            output[i] += sound.samples[i] * factor;
         }
 
         return;
@@ -746,8 +1070,8 @@ void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer&
     {
         for(std::size_t i{}; i < frame_count; ++i)
         {
-            m_listener_samples[i * 2]     += sound.samples[i] * factor * ((-sine) + 2.0f) / 4.0f; //right
-            m_listener_samples[i * 2 + 1] += sound.samples[i] * factor * (sine + 2.0f) / 4.0f; //left
+            output[i * 2]     += sound.samples[i] * factor * ((-sine) + 2.0f) / 4.0f; //right
+            output[i * 2 + 1] += sound.samples[i] * factor * (sine + 2.0f) / 4.0f; //left
         }
     }
     else
@@ -756,7 +1080,7 @@ void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer&
     }
 }
 
-void audio_world::adjust_channels(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept
+void audio_world::adjust_channels(const listener_data_buffer& listener, const sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) noexcept
 {
     const float volume{sound.state.volume * listener.state.volume};
 
@@ -766,8 +1090,8 @@ void audio_world::adjust_channels(listener_data_buffer& listener, sound_data_buf
         {
             const float sample{sound.samples[i] * volume};
 
-            m_listener_samples[i * 2]     += sample; //right
-            m_listener_samples[i * 2 + 1] += sample; //left
+            output[i * 2]     += sample; //right
+            output[i * 2 + 1] += sample; //left
         }
     }
     else if(listener.state.channel_count == 1 && sound.state.channel_count == 2)
@@ -776,14 +1100,14 @@ void audio_world::adjust_channels(listener_data_buffer& listener, sound_data_buf
         {
             const float sample{(sound.samples[i * 2] + sound.samples[i * 2 + 1]) * volume};
 
-            m_listener_samples[i] += mix_amplitude(sample, 2);
+            output[i] += mix_amplitude(sample, 2);
         }
     }
 }
 
-void audio_world::mix_sounds()
+void audio_world::mix_sounds(std::span<float> output)
 {
-    for(auto& sample : m_listener_samples)
+    for(auto& sample : output)
     {
         sample = mix_amplitude(sample, std::size(m_sounds_data));
     }
@@ -26,10 +26,14 @@
 #include "config.hpp"
 
 #include <captal_foundation/math.hpp>
+#include <captal_foundation/pool_allocator.hpp>
+#include <captal_foundation/mpsc_queue.hpp>
+#include <captal_foundation/worker_pool.hpp>
 
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 #include <span>
 
@@ -263,14 +267,41 @@ struct sound_state
     std::uint64_t loop_end{std::numeric_limits<std::uint64_t>::max()};
     std::uint64_t fading{std::numeric_limits<std::uint64_t>::max()};
     std::uint64_t current_fading{};
+    std::int32_t priority{};
     sound_spatialization spatialization{};
 };
 
 struct sound_data
 {
     std::unique_ptr<sound_reader> reader{};
-    sound_state state{};
-    std::mutex mutex{};
+    sound_state state{}; //Only accessed by the audio thread
+    std::uint32_t generation{}; //Generation of the last command applied by the audio thread
+    std::atomic<std::uint64_t> published_status{}; //Generation in the high bits, status in the low bits
+    std::atomic<std::uint64_t> published_position{};
+    std::mutex reader_mutex{}; //swl::sound::change_reader only holds it for the time of a swap
+};
+
+enum class sound_command_type : std::uint32_t
+{
+    add = 0,
+    free = 1,
+    start = 2,
+    stop = 3,
+    pause = 4,
+    resume = 5,
+    fade_in = 6,
+    fade_out = 7,
+    seek = 8,
+    parameters = 9,
+};
+
+struct sound_command
+{
+    sound_data* sound{};
+    sound_command_type type{};
+    std::uint32_t generation{};
+    std::uint64_t frame{}; //Fading duration or seek position
+    sound_state parameters{}; //Volume, loop points, priority and spatialization for sound_command_type::parameters
 };
 
 }
@@ -316,6 +347,7 @@ public:
     void set_attenuation(float attenuation);
     void move(const vec3f& relative);
     void move_to(const vec3f& position);
+    void set_priority(std::int32_t priority);
     void seek(std::uint64_t frame);
 
     template<typename Rep1, typename Period1, typename Rep2, typename Period2>
@@ -340,6 +372,7 @@ public:
     float minimum_distance() const;
     float attenuation() const;
     vec3f position() const;
+    std::int32_t priority() const;
     std::uint64_t tell() const;
 
     template<typename DurationT>
@@ -355,11 +388,19 @@ public:
     }
 
 private:
+    void send(impl::sound_command_type type, std::uint64_t frame = 0);
+
+private:
+    audio_world* m_world{};
     impl::sound_data* m_data{};
+    impl::sound_state m_state{}; //What the game thread sees, the audio thread works on its own copy
+    std::uint32_t m_generation{}; //Incremented by each command that changes the status
 };
 
 class SWELL_API audio_world
 {
+    friend class sound;
+
     template<typename T>
     class default_init_allocator : public std::allocator<T>
     {
@@ -376,17 +417,26 @@ class SWELL_API audio_world
         }
     };
 
+public:
+    struct voice_statistics
+    {
+        std::size_t real_count{};
+        std::size_t virtual_count{};
+    };
+
 public:
     audio_world() = default;
-    explicit audio_world(std::uint32_t sample_rate);
+    explicit audio_world(std::uint32_t sample_rate, std::size_t worker_count = 0);
 
-    ~audio_world() = default;
+    ~audio_world();
     audio_world(const audio_world&) = delete;
     audio_world& operator=(const audio_world&) = delete;
     audio_world(audio_world&& other) noexcept = delete;
     audio_world& operator=(audio_world&& other) noexcept = delete;
 
     void set_up(const vec3f& direction);
+    void set_voice_limit(std::size_t count);
+    void set_audibility_threshold(float threshold);
 
     template<typename... Listeners>
     void bind_listener(Listeners&... listeners)
@@ -401,13 +451,21 @@ public:
     void generate(std::size_t frame_count);
 
     vec3f up() const;
+    std::size_t voice_limit() const;
+    float audibility_threshold() const;
+    voice_statistics voice_stats() const noexcept;
 
     std::uint32_t sample_rate() const noexcept
     {
         return m_sample_rate;
     }
 
-    impl::sound_data* make_sound();
+    impl::sound_data* make_sound(std::unique_ptr<sound_reader> reader);
+
+    slab_pool::statistics sound_pool_statistics() const
+    {
+        return m_sound_pool.stats();
+    }
 
 private:
     struct sound_data_buffer
@@ -422,17 +480,32 @@ private:
         impl::listener_state state{};
     };
 
+    struct voice
+    {
+        impl::sound_data* sound{};
+        float audibility{};
+    };
+
 private:
+    void send(const impl::sound_command& command);
+    void process_commands();
+    void process_command(const impl::sound_command& command);
+    void publish(impl::sound_data& sound);
+
     void discard_impl(std::size_t frame_count);
     void discard_sound_data(impl::sound_data& sound, std::size_t frame_count);
 
+    float audibility(const impl::sound_state& sound) const noexcept;
+    void select_voices();
     void store_sounds_data(std::size_t frame_count);
-    std::span<float> get_sound_data(impl::sound_data& sound, std::size_t frame_count);
+    void store_sound_data(std::size_t index, std::size_t frame_count);
+    void get_sound_data(impl::sound_data& sound, std::span<float> output, std::size_t frame_count);
 
     void apply_fading(sound_data_buffer& sound, std::size_t frame_count);
-    void spatialize(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept;
-    void adjust_channels(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept;
-    void mix_sounds();
+    void mix_listener(listener_data_buffer& listener, std::size_t frame_count);
+    void spatialize(const listener_data_buffer& listener, const sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) noexcept;
+    void adjust_channels(const listener_data_buffer& listener, const sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) noexcept;
+    void mix_sounds(std::span<float> output);
 
     void free_resources();
 
@@ -440,13 +513,21 @@ private:
     std::uint32_t m_sample_rate{};
 
     vec3f m_up{0.0f, 1.0f, 0.0f};
-
-    std::vector<std::unique_ptr<impl::sound_data>> m_sounds{};
+    std::size_t m_voice_limit{std::numeric_limits<std::size_t>::max()};
+    float m_audibility_threshold{0.001f}; //-60dB
+
+    slab_pool m_sound_pool{sizeof(impl::sound_data), alignof(impl::sound_data)};
+    std::vector<pool_ptr<impl::sound_data>> m_sounds{};
+    slab_pool m_command_pool{node_block_size<impl::sound_command>, node_block_align<impl::sound_command>, 256, 256};
+    mpsc_queue<impl::sound_command, pool_allocator<impl::sound_command>> m_commands{m_command_pool};
+    std::vector<voice> m_voices{};
+    std::size_t m_real_voice_count{};
+    std::atomic<std::size_t> m_published_real_count{};
+    std::atomic<std::size_t> m_published_virtual_count{};
     std::vector<float, default_init_allocator<float>> m_sample_buffer{};
     std::vector<sound_data_buffer> m_sounds_data{};
     std::vector<listener_data_buffer> m_listeners_data{};
-
-    std::span<float> m_listener_samples{};
+    worker_pool m_workers{}; //Decodes sounds and mixes listeners in parallel
 
     mutable std::mutex m_mutex{};
 };
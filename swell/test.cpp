@@ -0,0 +1,104 @@
+#include <swell/audio_world.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_CONSOLE_WIDTH 120
+#include <catch2/catch.hpp>
+
+//Endless constant signal
+class constant_reader final : public swl::sound_reader
+{
+public:
+    explicit constant_reader(std::uint32_t channel_count)
+    {
+        set_info(swl::sound_info{std::numeric_limits<std::uint32_t>::max(), 44100, channel_count, true});
+    }
+
+    bool read(float* output, std::size_t frame_count) override
+    {
+        std::fill_n(output, frame_count * info().channel_count, 0.5f);
+        m_position += frame_count;
+
+        return true;
+    }
+
+    void seek(std::uint64_t frame) override
+    {
+        m_position = frame;
+    }
+
+    std::uint64_t tell() override
+    {
+        return m_position;
+    }
+
+private:
+    std::uint64_t m_position{};
+};
+
+TEST_CASE("Audio world test", "[audio_world]")
+{
+    SECTION("swl::sound::change_reader while the audio thread generates")
+    {
+        swl::listener listener{2};
+        swl::audio_world world{44100, 2};
+        world.bind_listener(listener);
+
+        //Idle sounds are published too, not only the playing ones
+        std::vector<swl::sound> sounds{};
+        for(std::size_t i{}; i < 8; ++i)
+        {
+            auto& sound{sounds.emplace_back(world, std::make_unique<constant_reader>(1))};
+
+            if(i % 2 == 0)
+            {
+                sound.start();
+            }
+        }
+
+        std::atomic<bool> running{true};
+        std::atomic<std::size_t> generated{};
+        std::thread audio{[&world, &listener, &running, &generated]()
+        {
+            std::vector<float> buffer(256 * 2);
+
+            while(running.load(std::memory_order_relaxed))
+            {
+                world.generate(256);
+                listener.drain_n(std::begin(buffer), 256);
+
+                generated.fetch_add(1, std::memory_order_relaxed);
+            }
+        }};
+
+        //Old readers are freed right away, the audio thread must not use them anymore
+        std::uint32_t changes{};
+        std::uint32_t old_readers{};
+        for(; generated.load(std::memory_order_relaxed) < 1000; ++changes)
+        {
+            for(std::size_t i{}; i < std::size(sounds); ++i)
+            {
+                if(sounds[i].change_reader(std::make_unique<constant_reader>(1 + changes % 2)))
+                {
+                    ++old_readers;
+                }
+
+                if(i % 2 == 0)
+                {
+                    sounds[i].start();
+                }
+            }
+        }
+
+        running.store(false, std::memory_order_relaxed);
+        audio.join();
+
+        REQUIRE(old_readers == changes * std::size(sounds));
+    }
+}
@@ -31,7 +31,7 @@ using namespace tph::vulkan::functions;
 namespace tph
 {
 
-static constexpr buffer_usage not_extension{~(buffer_usage::device_only | buffer_usage::staging)};
+static constexpr buffer_usage not_extension{~(buffer_usage::device_only | buffer_usage::staging | buffer_usage::device_mapped)};
 
 buffer::buffer(renderer& renderer, std::uint64_t size, buffer_usage usage)
 :m_buffer{underlying_cast<VkDevice>(renderer), size, static_cast<VkBufferUsageFlags>(usage & not_extension)}
@@ -41,6 +41,10 @@ buffer::buffer(renderer& renderer, std::uint64_t size, buffer_usage usage)
     {
         m_memory = renderer.allocator().allocate_bound(m_buffer, vulkan::memory_resource_type::linear, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
     }
+    else if(static_cast<bool>(usage & buffer_usage::device_mapped))
+    {
+        m_memory = renderer.allocator().allocate_bound(m_buffer, vulkan::memory_resource_type::linear, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
     else
     {
         if(static_cast<bool>(usage & buffer_usage::staging))
@@ -64,6 +68,11 @@ const std::uint8_t* buffer::map() const
     return reinterpret_cast<const std::uint8_t*>(m_memory.map());
 }
 
+void buffer::flush(std::uint64_t offset, std::uint64_t size)
+{
+    m_memory.flush(offset, size);
+}
+
 void buffer::unmap() noexcept
 {
     m_memory.unmap();
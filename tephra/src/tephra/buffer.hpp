@@ -49,6 +49,7 @@ enum class buffer_usage : std::uint32_t
     indirect = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
     device_only = 0x10000000,
     staging = 0x20000000,
+    device_mapped = 0x40000000, //Device local and host visible memory, see vulkan::memory_allocator::device_memory_host_visible
 };
 
 class TEPHRA_API buffer
@@ -78,6 +79,7 @@ public:
 
     std::uint8_t* map();
     const std::uint8_t* map() const;
+    void flush(std::uint64_t offset, std::uint64_t size);
     void unmap() noexcept;
 
     std::uint64_t size() const noexcept
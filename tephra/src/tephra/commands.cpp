@@ -924,6 +924,13 @@ void bind_descriptor_set(command_buffer& command_buffer, std::uint32_t index, st
                             index, static_cast<std::uint32_t>(std::size(native_sets)), std::data(native_sets), 0, nullptr);
 }
 
+void bind_descriptor_set(command_buffer& command_buffer, std::uint32_t index, descriptor_set& set, pipeline_layout& layout, std::span<const std::uint32_t> dynamic_offsets, pipeline_type bind_point) noexcept
+{
+    VkDescriptorSet native_set{underlying_cast<VkDescriptorSet>(set)};
+    vkCmdBindDescriptorSets(underlying_cast<VkCommandBuffer>(command_buffer), static_cast<VkPipelineBindPoint>(bind_point), underlying_cast<VkPipelineLayout>(layout),
+                            index, 1, &native_set, static_cast<std::uint32_t>(std::size(dynamic_offsets)), std::data(dynamic_offsets));
+}
+
 void reset_event(command_buffer& command_buffer, event& event, pipeline_stage stage) noexcept
 {
     vkCmdResetEvent(underlying_cast<VkCommandBuffer>(command_buffer), underlying_cast<VkEvent>(event), static_cast<VkPipelineStageFlags>(stage));
@@ -379,6 +379,7 @@ TEPHRA_API void bind_vertex_buffer(command_buffer& command_buffer, buffer& buffe
 TEPHRA_API void bind_index_buffer(command_buffer& command_buffer, buffer& buffer, std::uint64_t offset, index_type type) noexcept;
 TEPHRA_API void bind_descriptor_set(command_buffer& command_buffer, std::uint32_t index, descriptor_set& set, pipeline_layout& layout, pipeline_type bind_point = pipeline_type::graphics) noexcept;
 TEPHRA_API void bind_descriptor_set(command_buffer& command_buffer, std::uint32_t index, std::span<descriptor_set> sets, pipeline_layout& layout, pipeline_type bind_point = pipeline_type::graphics) noexcept;
+TEPHRA_API void bind_descriptor_set(command_buffer& command_buffer, std::uint32_t index, descriptor_set& set, pipeline_layout& layout, std::span<const std::uint32_t> dynamic_offsets, pipeline_type bind_point = pipeline_type::graphics) noexcept;
 
 TEPHRA_API void reset_event(command_buffer& command_buffer, event& event, pipeline_stage stage) noexcept;
 TEPHRA_API void set_event(command_buffer& command_buffer, event& event, pipeline_stage stage) noexcept;
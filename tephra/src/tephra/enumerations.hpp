@@ -335,6 +335,8 @@ enum class vertex_format : std::uint32_t
     vec4i = VK_FORMAT_R32G32B32A32_SINT,
     vec4f = VK_FORMAT_R32G32B32A32_SFLOAT,
     vec4d = VK_FORMAT_R64G64B64A64_SFLOAT,
+    vec2u16_unorm = VK_FORMAT_R16G16_UNORM,
+    vec4u8_unorm = VK_FORMAT_R8G8B8A8_UNORM,
 };
 
 enum class texture_format : std::uint32_t
@@ -470,6 +472,60 @@ enum class texture_format : std::uint32_t
     d16_unorm_s8_uint = VK_FORMAT_D16_UNORM_S8_UINT,
     d24_unorm_s8_uint = VK_FORMAT_D24_UNORM_S8_UINT,
     d32_sfloat_s8_uint = VK_FORMAT_D32_SFLOAT_S8_UINT,
+    bc1_rgb_unorm_block = VK_FORMAT_BC1_RGB_UNORM_BLOCK,
+    bc1_rgb_srgb_block = VK_FORMAT_BC1_RGB_SRGB_BLOCK,
+    bc1_rgba_unorm_block = VK_FORMAT_BC1_RGBA_UNORM_BLOCK,
+    bc1_rgba_srgb_block = VK_FORMAT_BC1_RGBA_SRGB_BLOCK,
+    bc2_unorm_block = VK_FORMAT_BC2_UNORM_BLOCK,
+    bc2_srgb_block = VK_FORMAT_BC2_SRGB_BLOCK,
+    bc3_unorm_block = VK_FORMAT_BC3_UNORM_BLOCK,
+    bc3_srgb_block = VK_FORMAT_BC3_SRGB_BLOCK,
+    bc4_unorm_block = VK_FORMAT_BC4_UNORM_BLOCK,
+    bc4_snorm_block = VK_FORMAT_BC4_SNORM_BLOCK,
+    bc5_unorm_block = VK_FORMAT_BC5_UNORM_BLOCK,
+    bc5_snorm_block = VK_FORMAT_BC5_SNORM_BLOCK,
+    bc6h_ufloat_block = VK_FORMAT_BC6H_UFLOAT_BLOCK,
+    bc6h_sfloat_block = VK_FORMAT_BC6H_SFLOAT_BLOCK,
+    bc7_unorm_block = VK_FORMAT_BC7_UNORM_BLOCK,
+    bc7_srgb_block = VK_FORMAT_BC7_SRGB_BLOCK,
+    etc2_r8g8b8_unorm_block = VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,
+    etc2_r8g8b8_srgb_block = VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK,
+    etc2_r8g8b8a1_unorm_block = VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK,
+    etc2_r8g8b8a1_srgb_block = VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK,
+    etc2_r8g8b8a8_unorm_block = VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,
+    etc2_r8g8b8a8_srgb_block = VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK,
+    eac_r11_unorm_block = VK_FORMAT_EAC_R11_UNORM_BLOCK,
+    eac_r11_snorm_block = VK_FORMAT_EAC_R11_SNORM_BLOCK,
+    eac_r11g11_unorm_block = VK_FORMAT_EAC_R11G11_UNORM_BLOCK,
+    eac_r11g11_snorm_block = VK_FORMAT_EAC_R11G11_SNORM_BLOCK,
+    astc_4x4_unorm_block = VK_FORMAT_ASTC_4x4_UNORM_BLOCK,
+    astc_4x4_srgb_block = VK_FORMAT_ASTC_4x4_SRGB_BLOCK,
+    astc_5x4_unorm_block = VK_FORMAT_ASTC_5x4_UNORM_BLOCK,
+    astc_5x4_srgb_block = VK_FORMAT_ASTC_5x4_SRGB_BLOCK,
+    astc_5x5_unorm_block = VK_FORMAT_ASTC_5x5_UNORM_BLOCK,
+    astc_5x5_srgb_block = VK_FORMAT_ASTC_5x5_SRGB_BLOCK,
+    astc_6x5_unorm_block = VK_FORMAT_ASTC_6x5_UNORM_BLOCK,
+    astc_6x5_srgb_block = VK_FORMAT_ASTC_6x5_SRGB_BLOCK,
+    astc_6x6_unorm_block = VK_FORMAT_ASTC_6x6_UNORM_BLOCK,
+    astc_6x6_srgb_block = VK_FORMAT_ASTC_6x6_SRGB_BLOCK,
+    astc_8x5_unorm_block = VK_FORMAT_ASTC_8x5_UNORM_BLOCK,
+    astc_8x5_srgb_block = VK_FORMAT_ASTC_8x5_SRGB_BLOCK,
+    astc_8x6_unorm_block = VK_FORMAT_ASTC_8x6_UNORM_BLOCK,
+    astc_8x6_srgb_block = VK_FORMAT_ASTC_8x6_SRGB_BLOCK,
+    astc_8x8_unorm_block = VK_FORMAT_ASTC_8x8_UNORM_BLOCK,
+    astc_8x8_srgb_block = VK_FORMAT_ASTC_8x8_SRGB_BLOCK,
+    astc_10x5_unorm_block = VK_FORMAT_ASTC_10x5_UNORM_BLOCK,
+    astc_10x5_srgb_block = VK_FORMAT_ASTC_10x5_SRGB_BLOCK,
+    astc_10x6_unorm_block = VK_FORMAT_ASTC_10x6_UNORM_BLOCK,
+    astc_10x6_srgb_block = VK_FORMAT_ASTC_10x6_SRGB_BLOCK,
+    astc_10x8_unorm_block = VK_FORMAT_ASTC_10x8_UNORM_BLOCK,
+    astc_10x8_srgb_block = VK_FORMAT_ASTC_10x8_SRGB_BLOCK,
+    astc_10x10_unorm_block = VK_FORMAT_ASTC_10x10_UNORM_BLOCK,
+    astc_10x10_srgb_block = VK_FORMAT_ASTC_10x10_SRGB_BLOCK,
+    astc_12x10_unorm_block = VK_FORMAT_ASTC_12x10_UNORM_BLOCK,
+    astc_12x10_srgb_block = VK_FORMAT_ASTC_12x10_SRGB_BLOCK,
+    astc_12x12_unorm_block = VK_FORMAT_ASTC_12x12_UNORM_BLOCK,
+    astc_12x12_srgb_block = VK_FORMAT_ASTC_12x12_SRGB_BLOCK,
 };
 
 enum class texture_aspect : std::uint32_t
@@ -48,6 +48,9 @@ static physical_device_properties make_properties(const VkPhysicalDeviceProperti
     output.api_version.patch = VK_VERSION_PATCH(properties.apiVersion);
     output.type = static_cast<physical_device_type>(properties.deviceType);
     std::copy(std::cbegin(properties.pipelineCacheUUID), std::cend(properties.pipelineCacheUUID), std::begin(output.uuid));
+    output.vendor_id = properties.vendorID;
+    output.device_id = properties.deviceID;
+    output.driver_version = properties.driverVersion;
 
     return output;
 }
@@ -54,6 +54,9 @@ struct physical_device_properties
     tph::version api_version{};
     std::string name{};
     std::array<std::uint8_t, 16> uuid{};
+    std::uint32_t vendor_id{};
+    std::uint32_t device_id{};
+    std::uint32_t driver_version{};
 };
 
 struct physical_device_features
@@ -168,6 +168,12 @@ public:
         return m_sample_count;
     }
 
+    //Size of the memory bound to the texture, 0 for swapchain textures
+    std::uint64_t memory_size() const noexcept
+    {
+        return m_memory.size();
+    }
+
 private:
     vulkan::image m_image{};
     vulkan::memory_heap_chunk m_memory{};
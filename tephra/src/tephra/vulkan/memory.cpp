@@ -124,6 +124,19 @@ void memory_heap_chunk::flush()
     m_parent->flush(m_offset, m_size);
 }
 
+void memory_heap_chunk::flush(std::uint64_t offset, std::uint64_t size)
+{
+    assert(m_parent && "tph::vulkan::memory_heap_chunk::flush called with an invalid memory_heap_chunk.");
+    assert(m_mapped && "tph::vulkan::memory_heap_chunk::flush called on an unmapped memory_heap_chunk.");
+    assert(offset + size <= m_size && "tph::vulkan::memory_heap_chunk::flush called with an out of range range.");
+
+    //Ranges are flushed often, skip the call when it is not needed
+    if(!m_parent->coherent())
+    {
+        m_parent->flush(m_offset + offset, size);
+    }
+}
+
 void memory_heap_chunk::invalidate()
 {
     assert(m_parent && "tph::vulkan::memory_heap_chunk::invalidate called with an invalid memory_heap_chunk.");
@@ -365,6 +378,29 @@ std::optional<memory_heap_chunk> memory_heap::try_allocate(memory_resource_type
     return std::nullopt;
 }
 
+std::uint64_t memory_heap::largest_free_block() const
+{
+    if(dedicated())
+    {
+        return m_free_space;
+    }
+
+    const auto& heap{std::get<non_dedicated_heap>(m_heap)};
+
+    std::lock_guard lock{heap.mutex};
+
+    std::uint64_t output{};
+    std::uint64_t end{};
+
+    for(auto&& range : heap.ranges)
+    {
+        output = std::max(output, range.offset - end);
+        end = range.offset + range.size;
+    }
+
+    return std::max(output, m_size - end);
+}
+
 void* memory_heap::map()
 {
     if(dedicated())
@@ -535,6 +571,29 @@ memory_allocator::memory_allocator(VkPhysicalDevice physical_device, VkDevice de
     m_version.minor = static_cast<std::uint16_t>(VK_VERSION_MINOR(properties.apiVersion));
     m_granularity = properties.limits.bufferImageGranularity;
     m_non_coherent_atom_size = properties.limits.nonCoherentAtomSize;
+
+    //Without resizable BAR, the host visible device heap is a small window (usually 256MiB) of the device memory
+    constexpr VkMemoryPropertyFlags device_shared{VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT};
+
+    std::uint64_t device_local_size{};
+    std::uint64_t device_shared_size{};
+    for(std::uint32_t i{}; i < m_memory_properties.memoryTypeCount; ++i)
+    {
+        const auto& type{m_memory_properties.memoryTypes[i]};
+        const auto  size{m_memory_properties.memoryHeaps[type.heapIndex].size};
+
+        if((type.propertyFlags & device_shared) == device_shared)
+        {
+            device_shared_size = std::max(device_shared_size, size);
+        }
+
+        if(type.propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        {
+            device_local_size = std::max(device_local_size, size);
+        }
+    }
+
+    m_device_memory_host_visible = device_shared_size > 0 && device_shared_size == device_local_size;
 }
 
 memory_heap_chunk memory_allocator::allocate(const VkMemoryRequirements& requirements, memory_resource_type resource_type, VkMemoryPropertyFlags minimal, VkMemoryPropertyFlags optimal)
@@ -832,6 +891,33 @@ memory_allocator::heap_sizes memory_allocator::allocated_memory() const
     return output;
 }
 
+memory_allocator::heap_sizes memory_allocator::largest_free_block() const
+{
+    std::lock_guard lock{m_mutex};
+
+    heap_sizes output{};
+
+    for(auto& heap : m_heaps)
+    {
+        const auto flags{m_heaps_flags[m_memory_properties.memoryTypes[heap->type()].heapIndex]};
+
+        if((flags & (VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) == (VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+        {
+            output.device_shared = std::max(output.device_shared, heap->largest_free_block());
+        }
+        else if(flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        {
+            output.device_local = std::max(output.device_local, heap->largest_free_block());
+        }
+        else if(flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            output.host_shared = std::max(output.host_shared, heap->largest_free_block());
+        }
+    }
+
+    return output;
+}
+
 memory_allocator::heap_sizes memory_allocator::dedicated_heap_count() const
 {
     std::lock_guard lock{m_mutex};
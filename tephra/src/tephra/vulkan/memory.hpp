@@ -66,6 +66,7 @@ public:
     void* map();
     const void* map() const;
     void flush();
+    void flush(std::uint64_t offset, std::uint64_t size);
     void invalidate();
     void unmap() const noexcept;
 
@@ -150,6 +151,7 @@ public:
     memory_heap_chunk allocate_dedicated(std::uint64_t size);
     memory_heap_chunk allocate_pseudo_dedicated(memory_resource_type resource_type, std::uint64_t size);
     std::optional<memory_heap_chunk> try_allocate(memory_resource_type resource_type, std::uint64_t size, std::uint64_t alignment);
+    std::uint64_t largest_free_block() const;
 
     std::uint32_t type() const noexcept
     {
@@ -243,6 +245,7 @@ public:
     heap_sizes allocation_count() const;
     heap_sizes allocated_memory() const;
     heap_sizes used_memory() const;
+    heap_sizes largest_free_block() const; //Largest free block among the heaps of each category
 
     heap_sizes dedicated_heap_count() const;
     heap_sizes dedicated_allocation_count() const;
@@ -254,6 +257,12 @@ public:
         return m_sizes;
     }
 
+    //True on unified memory architectures and on discrete devices with resizable BAR
+    bool device_memory_host_visible() const noexcept
+    {
+        return m_device_memory_host_visible;
+    }
+
     operator VkPhysicalDevice() const noexcept
     {
         return m_physical_device;
@@ -276,6 +285,7 @@ private:
     heap_sizes m_sizes{};
     std::uint64_t m_granularity{};
     std::uint64_t m_non_coherent_atom_size{};
+    bool m_device_memory_host_visible{};
     std::vector<std::unique_ptr<memory_heap>> m_heaps{};
     mutable std::mutex m_mutex{};
 };